@@ -0,0 +1,132 @@
+#include "AgingWheel.h"
+
+AgingWheel::AgingWheel(uint32_t agingTimeout)
+    : timeout(agingTimeout), shift(0), cursor(0), started(false), records(0) {
+    // Deadlines lie at most timeout+1 units ahead, so that span (plus slack
+    // for the bucket being processed) must fit in the wheel
+    while ((static_cast<uint64_t>(timeout) + 1) >> shift > kMaxSlots - 2) {
+        shift++;
+    }
+    const uint64_t span = ((static_cast<uint64_t>(timeout) + 1) >> shift) + 2;
+    uint32_t count = 1;
+    while (count < span) {
+        count <<= 1;
+    }
+    slots.resize(count);
+    slotMask = count - 1;
+}
+
+void AgingWheel::file(uint64_t key, uint32_t tick) {
+    // Never file behind the cursor; a record that is already due is simply
+    // handled with the next bucket
+    if (static_cast<int32_t>(tick - cursor) < 0) {
+        tick = cursor;
+    }
+    slots[tick & slotMask].push_back(key);
+    records++;
+}
+
+void AgingWheel::schedule(FdbKey key, MacTable::Timestamp lastSeen) {
+    if (!started) {
+        cursor = dueLimit(lastSeen);
+        started = true;
+    }
+    // A record left by an earlier entry for this key is due no later than
+    // the new deadline, and re-checks the new entry when it comes up
+    if (filed.insert(key.toUint64()).second) {
+        file(key.toUint64(), deadlineTick(lastSeen));
+    }
+}
+
+bool AgingWheel::hasDueWork(MacTable::Timestamp now) const {
+    return started && records > 0 && cursor != dueLimit(now);
+}
+
+std::size_t AgingWheel::advance(MacTable::Timestamp now, MacTable& table, std::size_t budget,
+                                const ExpireCallback& onExpire) {
+    if (!started) {
+        return 0;
+    }
+
+    const uint32_t limit = dueLimit(now);
+
+    // After a long jump every bucket is due; visiting each once is enough
+    if (limit - cursor > slotMask + 1) {
+        cursor = limit - (slotMask + 1);
+    }
+
+    std::size_t removed = 0;
+    std::size_t examined = 0;
+
+    while (cursor != limit) {
+        // Take the bucket so records re-filed into the same bucket index
+        // (a full wheel revolution later) are not seen again in this pass
+        std::vector<uint64_t> due;
+        due.swap(slots[cursor & slotMask]);
+        records -= due.size();
+
+        std::size_t i = 0;
+        for (; i < due.size(); i++) {
+            if (budget > 0 && examined >= budget) {
+                break;
+            }
+            examined++;
+
+            MACTableEntry entry;
+            if (!table.find(FdbKey::fromUint64(due[i]), entry)) {
+                filed.erase(due[i]);
+                continue;   // Already gone (flushed, erased or evicted)
+            }
+            const uint32_t elapsed = now - entry.timestamp;
+            if (elapsed > timeout) {
+                if (onExpire) {
+                    onExpire(entry, elapsed);
+                }
+                table.erase(entry.key());
+                filed.erase(due[i]);
+                removed++;
+            } else {
+                // Seen since it was filed: re-file under the new deadline
+                file(due[i], deadlineTick(entry.timestamp));
+            }
+        }
+
+        if (i < due.size()) {
+            // Out of budget: put the unexamined records back and resume here
+            std::vector<uint64_t>& slot = slots[cursor & slotMask];
+            slot.insert(slot.end(), due.begin() + i, due.end());
+            records += due.size() - i;
+            break;
+        }
+
+        // Reuse the bucket's storage if nothing was re-filed into it
+        std::vector<uint64_t>& slot = slots[cursor & slotMask];
+        if (slot.empty()) {
+            due.clear();
+            slot.swap(due);
+        }
+        cursor++;
+    }
+
+    return removed;
+}
+
+std::size_t AgingWheel::allocatedBytes() const {
+    std::size_t bytes = slots.capacity() * sizeof(slots[0]);
+    for (const auto& slot : slots) {
+        bytes += slot.capacity() * sizeof(uint64_t);
+    }
+    // Bucket array plus one node (next pointer and key) per filed key
+    bytes += filed.bucket_count() * sizeof(void*);
+    bytes += filed.size() * (sizeof(void*) + sizeof(uint64_t));
+    return bytes;
+}
+
+void AgingWheel::clear() {
+    for (auto& slot : slots) {
+        slot.clear();
+    }
+    filed.clear();
+    records = 0;
+    started = false;
+}
@@ -0,0 +1,116 @@
+#ifndef AGING_WHEEL_H
+#define AGING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+#include "MacTable.h"
+
+/**
+ * @brief Timing wheel that schedules MAC table entries for expiry
+ *
+ * Each learned address is filed once, in the bucket of the tick at which it
+ * would expire if never seen again. Advancing the wheel only visits buckets
+ * whose tick has passed, so the cost of aging is proportional to the entries
+ * that come due rather than to the table size.
+ *
+ * Refreshing an entry does not touch the wheel: when its bucket comes due the
+ * entry's real timestamp is re-checked, and if it has been seen since, it is
+ * re-filed under its new deadline. A busy station is therefore handled at
+ * most once per timeout period, and the forwarding path never pays for aging
+ * bookkeeping beyond the first learn.
+ *
+ * Every key has at most one record. An entry flushed, erased or evicted
+ * leaves its record behind until the bucket comes due; if the address is
+ * learned again before then, that record (due no later than the new
+ * deadline) serves the new entry instead of a second one being filed.
+ *
+ * Buckets are one clock unit wide for timeouts up to kMaxSlots units; longer
+ * timeouts use wider (power-of-two) buckets, so entries may expire up to one
+ * bucket width late.
+ */
+class AgingWheel {
+public:
+    // Upper bound on the number of buckets, regardless of timeout
+    static constexpr uint32_t kMaxSlots = 4096;
+
+    using ExpireCallback = std::function<void(const MACTableEntry& entry, uint32_t elapsed)>;
+
+    /**
+     * @param timeout Aging timeout in clock units (entries expire once older than this)
+     */
+    explicit AgingWheel(uint32_t timeout);
+
+    /**
+     * @brief Files a newly learned address, unless a record for it is still filed
+     *
+     * @param key Entry that was just inserted into the table
+     * @param lastSeen The timestamp it was learned with
+     */
+    void schedule(FdbKey key, MacTable::Timestamp lastSeen);
+
+    /**
+     * @brief Expires entries whose deadline has passed
+     *
+     * Removes expired entries from the table and re-files refreshed ones.
+     * Work stops after budget records so aging can be interleaved with
+     * frame processing; the remainder is picked up by the next call.
+     *
+     * @param now Current time in clock units
+     * @param table Table the scheduled addresses live in
+     * @param budget Maximum records to examine (0 = no limit)
+     * @param onExpire Called for each entry just before it is erased
+     * @return Number of entries removed
+     */
+    std::size_t advance(MacTable::Timestamp now, MacTable& table, std::size_t budget,
+                        const ExpireCallback& onExpire);
+
+    /**
+     * @brief True if some bucket is due at this time
+     */
+    bool hasDueWork(MacTable::Timestamp now) const;
+
+    /**
+     * @brief Drops every scheduled record (after the table was cleared)
+     */
+    void clear();
+
+    /**
+     * @brief Records currently filed, including stale ones not yet re-checked
+     *
+     * At most one per key, so never more than the table held within the
+     * last timeout.
+     */
+    std::size_t pending() const { return records; }
+
+    /**
+     * @brief Heap bytes held by the buckets and the set of filed keys
+     */
+    std::size_t allocatedBytes() const;
+
+private:
+    std::vector<std::vector<uint64_t>> slots;   // Packed FdbKeys per bucket
+    std::unordered_set<uint64_t> filed;         // Keys with a record in some bucket
+    uint32_t timeout;
+    uint32_t shift;         // log2 of the bucket width in clock units
+    uint32_t slotMask;      // Bucket count - 1
+    uint32_t cursor;        // Next tick to process
+    bool started;           // Whether cursor has been anchored to a real time
+    std::size_t records;
+
+    // First tick at which an entry last seen at lastSeen is expired
+    uint32_t deadlineTick(MacTable::Timestamp lastSeen) const {
+        return (lastSeen + timeout + 1) >> shift;
+    }
+
+    // Ticks strictly below this are due at time now
+    uint32_t dueLimit(MacTable::Timestamp now) const {
+        return static_cast<uint32_t>((static_cast<uint64_t>(now) + 1) >> shift);
+    }
+
+    void file(uint64_t key, uint32_t tick);
+};
+
+#endif // AGING_WHEEL_H
@@ -0,0 +1,158 @@
+#include "AsyncObserver.h"
+#include <chrono>
+
+namespace {
+
+// How long the logging thread sleeps when the ring is empty
+constexpr std::chrono::microseconds kIdleSleep(50);
+
+LogRecord makeRecord(ObserverEvent::Type type) {
+    LogRecord record{};
+    record.type = type;
+    record.evictedPort = -1;
+    return record;
+}
+
+} // namespace
+
+AsyncObserver::AsyncObserver(SwitchObserver& target, std::size_t capacity)
+    : inner(target), ring(capacity > 0 ? capacity : kDefaultCapacity) {
+    worker = std::thread(&AsyncObserver::run, this);
+}
+
+AsyncObserver::~AsyncObserver() {
+    stopping.store(true, std::memory_order_release);
+    worker.join();
+}
+
+void AsyncObserver::push(const LogRecord& record) {
+    if (!ring.tryPush(record)) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncObserver::onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) {
+    LogRecord record = makeRecord(ObserverEvent::Type::SwitchCreated);
+    record.port = numPorts;
+    record.words[0] = static_cast<uint64_t>(agingTimeout);
+    record.clock = static_cast<uint8_t>(clock);
+    push(record);
+}
+
+void AsyncObserver::onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                                    MacAddress destMAC, int incomingPort) {
+    LogRecord record = makeRecord(ObserverEvent::Type::FrameReceived);
+    record.words[0] = frameNumber;
+    record.words[1] = sourceMAC.toUint64();
+    record.peer = destMAC.toUint64();
+    record.port = incomingPort;
+    push(record);
+}
+
+void AsyncObserver::onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) {
+    LogRecord record = makeRecord(ObserverEvent::Type::Learn);
+    record.words[1] = sourceMAC.toUint64();
+    record.port = incomingPort;
+    record.code = static_cast<uint8_t>(outcome.result);
+    record.otherPort = outcome.previousPort;
+    if (outcome.evicted()) {
+        record.peer = outcome.evictedKey.toUint64();
+        record.evictedPort = outcome.evictedPort;
+    }
+    push(record);
+}
+
+void AsyncObserver::onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                               int incomingPort) {
+    LogRecord record = makeRecord(ObserverEvent::Type::Decision);
+    record.peer = destMAC.toUint64();
+    record.port = incomingPort;
+    record.code = static_cast<uint8_t>(decision.kind);
+    record.otherPort = decision.outPort;
+    for (int w = 0; w < PortMask::kWords; w++) {
+        record.words[w] = decision.egressPorts.word(w);
+    }
+    push(record);
+}
+
+void AsyncObserver::onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) {
+    LogRecord record = makeRecord(ObserverEvent::Type::AgeOut);
+    record.words[1] = mac.toUint64();
+    record.words[0] = static_cast<uint64_t>(elapsed);
+    record.clock = static_cast<uint8_t>(clock);
+    push(record);
+}
+
+void AsyncObserver::onAgingComplete(std::size_t removed) {
+    LogRecord record = makeRecord(ObserverEvent::Type::AgingComplete);
+    record.words[0] = removed;
+    push(record);
+}
+
+void AsyncObserver::onTableCleared() {
+    push(makeRecord(ObserverEvent::Type::TableCleared));
+}
+
+void AsyncObserver::flush() {
+    // Records claimed before this point are written (or were dropped, and
+    // never claimed) once the logging thread's count reaches the claim count
+    const uint64_t target = ring.claimed();
+    while (writtenRecords.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(kIdleSleep);
+    }
+}
+
+void AsyncObserver::write(const LogRecord& record) {
+    ObserverEvent event{};
+    event.type = record.type;
+    event.port = record.port;
+    event.clock = static_cast<AgingClock>(record.clock);
+    switch (record.type) {
+        case ObserverEvent::Type::Learn:
+            event.mac = MacAddress(record.words[1]);
+            event.learn = LearnOutcome(static_cast<LearnResult>(record.code), record.otherPort);
+            if (record.evictedPort != -1) {
+                event.learn.evictedKey = FdbKey::fromUint64(record.peer);
+                event.learn.evictedPort = record.evictedPort;
+            }
+            break;
+        case ObserverEvent::Type::Decision:
+            event.peer = MacAddress(record.peer);
+            event.decision.kind = static_cast<ForwardKind>(record.code);
+            event.decision.outPort = record.otherPort;
+            for (int w = 0; w < PortMask::kWords; w++) {
+                event.decision.egressPorts.setWord(w, record.words[w]);
+            }
+            break;
+        default:
+            event.value = record.words[0];
+            event.mac = MacAddress(record.words[1]);
+            event.peer = MacAddress(record.peer);
+            break;
+    }
+    replayEvent(event, inner);
+}
+
+void AsyncObserver::run() {
+    LogRecord record;
+    uint64_t count = 0;
+    for (;;) {
+        if (ring.tryPop(record)) {
+            write(record);
+            count++;
+            continue;
+        }
+        // Caught up: push the formatted trace out before reporting progress,
+        // so that a returning flush() finds the target's output complete.
+        // An idle thread leaves the target alone, so the caller of flush()
+        // may write to the same stream afterwards.
+        if (count != writtenRecords.load(std::memory_order_relaxed)) {
+            inner.flush();
+            writtenRecords.store(count, std::memory_order_release);
+        }
+        if (stopping.load(std::memory_order_acquire) && ring.claimed() == count) {
+            return;
+        }
+        std::this_thread::sleep_for(kIdleSleep);
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef ASYNC_OBSERVER_H
+#define ASYNC_OBSERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include "MpscRing.h"
+#include "SwitchObserver.h"
+
+/**
+ * @brief One observer callback, packed for the logging ring
+ *
+ * Field meaning depends on type, as in ObserverEvent, but in 56 bytes so
+ * that a ring slot with its sequence number is one cache line:
+ * - SwitchCreated:  port = numPorts, words[0] = agingTimeout, clock
+ * - FrameReceived:  words[0] = frame number, words[1] = source, peer = destination, port = ingress
+ * - Learn:          words[1] = source, port = ingress, code = result, otherPort = previous
+ *                   port, peer = evicted key and evictedPort (-1 if none)
+ * - Decision:       peer = destination, port = ingress, code = kind, otherPort = outPort,
+ *                   words = egress port mask
+ * - AgeOut:         words[1] = address, words[0] = elapsed time, clock
+ * - AgingComplete:  words[0] = entries removed
+ */
+struct LogRecord {
+    ObserverEvent::Type type;
+    uint8_t code;               // LearnResult or ForwardKind
+    uint8_t clock;              // AgingClock
+    int32_t port;
+    int32_t otherPort;
+    int32_t evictedPort;
+    uint64_t peer;
+    uint64_t words[PortMask::kWords];
+};
+
+static_assert(sizeof(LogRecord) == 56, "LogRecord: a ring slot must stay one cache line");
+
+/**
+ * @brief Moves another observer's work onto a background logging thread
+ *
+ * Callbacks pack their arguments into a LogRecord and push it onto a
+ * lock-free MPSC ring; a logging thread pops records in order and replays
+ * them into the target observer, so formatting, colorizing and stream I/O
+ * (a ConsoleObserver's whole cost) happen off the forwarding path. Any
+ * number of switches or threads may report into one AsyncObserver.
+ *
+ * A full ring never blocks the caller: the record is dropped and counted,
+ * and the trace reads on from the next record that fits. flush() waits
+ * until everything reported before it has been written, which Switch calls
+ * before printing tables and statistics, so those appear after the trace
+ * that led to them. The target must not be used by other threads while the
+ * AsyncObserver exists.
+ */
+class AsyncObserver : public SwitchObserver {
+public:
+    // Ring slots by default: 4 MiB of records, a few hundred thousand frames of trace
+    static constexpr std::size_t kDefaultCapacity = 65536;
+
+    /**
+     * @param target Observer the logging thread replays every record into
+     * @param capacity Ring slots (rounded up to a power of two)
+     */
+    explicit AsyncObserver(SwitchObserver& target, std::size_t capacity = kDefaultCapacity);
+
+    /**
+     * @brief Writes out every pending record and stops the logging thread
+     */
+    ~AsyncObserver() override;
+
+    AsyncObserver(const AsyncObserver&) = delete;
+    AsyncObserver& operator=(const AsyncObserver&) = delete;
+
+    void onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) override;
+    void onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                         MacAddress destMAC, int incomingPort) override;
+    void onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) override;
+    void onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                    int incomingPort) override;
+    void onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) override;
+    void onAgingComplete(std::size_t removed) override;
+    void onTableCleared() override;
+
+    /**
+     * @brief Blocks until every record pushed before the call is written and flushed
+     */
+    void flush() override;
+
+    /**
+     * @brief Records dropped because the ring was full
+     */
+    uint64_t dropped() const { return droppedRecords.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records replayed into the target and flushed so far
+     */
+    uint64_t written() const { return writtenRecords.load(std::memory_order_acquire); }
+
+private:
+    SwitchObserver& inner;
+    MpscRing<LogRecord> ring;
+    std::atomic<uint64_t> droppedRecords{0};
+    std::atomic<uint64_t> writtenRecords{0};
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    void push(const LogRecord& record);
+
+    // Logging thread: replays records until stopping is set and the ring is empty
+    void run();
+
+    // Replays one record into the target
+    void write(const LogRecord& record);
+};
+
+#endif // ASYNC_OBSERVER_H
@@ -0,0 +1,481 @@
+#ifndef BASIC_SWITCH_H
+#define BASIC_SWITCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "AgingWheel.h"
+#include "EtherType.h"
+#include "FdbKey.h"
+#include "FlatMacTable.h"
+#include "ForwardDecision.h"
+#include "FrameView.h"
+#include "MacAddress.h"
+#include "MacTable.h"
+#include "PortMask.h"
+#include "SwitchCounters.h"
+#include "SwitchObserver.h"
+
+/**
+ * @brief Aging policy: learned entries never expire
+ *
+ * No wheel is kept and no aging work is ever done. Entries are stamped with
+ * the logical cycle so the table still shows when they were last seen.
+ */
+struct NoAging {
+    static constexpr bool kEnabled = false;
+    static constexpr uint32_t kTimeout = 0;
+    static constexpr AgingClock kClock = AgingClock::Logical;
+    static constexpr std::size_t kBudgetPerBurst = 0;
+};
+
+/**
+ * @brief Aging policy: entries expire Timeout clock units after last seen
+ *
+ * @tparam Timeout Aging timeout in Clock units
+ * @tparam Clock Time base of entry stamps
+ * @tparam BudgetPerBurst Aging records examined after each burst (0 = only in cleanupTable)
+ */
+template <uint32_t Timeout, AgingClock Clock = AgingClock::Logical, std::size_t BudgetPerBurst = 0>
+struct FixedAging {
+    static_assert(Timeout > 0, "FixedAging: use NoAging to disable aging");
+    static constexpr bool kEnabled = true;
+    static constexpr uint32_t kTimeout = Timeout;
+    static constexpr AgingClock kClock = Clock;
+    static constexpr std::size_t kBudgetPerBurst = BudgetPerBurst;
+};
+
+/**
+ * @brief Observer policy: nothing is reported and every hook compiles away
+ */
+struct NoObserver {
+    static constexpr bool kEnabled = false;
+};
+
+/**
+ * @brief Observer policy: events go to a SwitchObserver chosen at run time
+ *
+ * Decisions are widened to a full ForwardDecision only when an observer is
+ * set. Any type with kEnabled = true and these member functions can be used
+ * instead, in which case the hooks are plain inline calls.
+ */
+class RuntimeObserver {
+public:
+    static constexpr bool kEnabled = true;
+
+    explicit RuntimeObserver(SwitchObserver* observer = nullptr) : observer(observer) {}
+
+    void onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) {
+        if (observer) {
+            observer->onSwitchCreated(numPorts, agingTimeout, clock);
+        }
+    }
+
+    void onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC, MacAddress destMAC, int incomingPort) {
+        if (observer) {
+            observer->onFrameReceived(frameNumber, sourceMAC, destMAC, incomingPort);
+        }
+    }
+
+    void onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) {
+        if (observer) {
+            observer->onLearn(sourceMAC, incomingPort, outcome);
+        }
+    }
+
+    template <typename Mask>
+    void onDecision(const BasicForwardDecision<Mask>& decision, MacAddress destMAC, int incomingPort) {
+        if (observer) {
+            const ForwardDecision wide{decision.kind, decision.outPort, decision.egressPorts.toPortMask()};
+            observer->onDecision(wide, destMAC, incomingPort);
+        }
+    }
+
+    void onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) {
+        if (observer) {
+            observer->onAgeOut(mac, elapsed, clock);
+        }
+    }
+
+    void onAgingComplete(std::size_t removed) {
+        if (observer) {
+            observer->onAgingComplete(removed);
+        }
+    }
+
+    void onTableCleared() {
+        if (observer) {
+            observer->onTableCleared();
+        }
+    }
+
+    SwitchObserver* get() const { return observer; }
+
+    void set(SwitchObserver* newObserver) { observer = newObserver; }
+
+private:
+    SwitchObserver* observer;
+};
+
+/**
+ * @brief Learning switch specialized at compile time for a fixed hardware model
+ *
+ * Forwards exactly like a Switch in its default configuration (every port
+ * untagged in VLAN 1 and Forwarding, no egress queues), but the port count,
+ * aging, table engine and observer are template parameters instead of
+ * runtime settings:
+ * - Egress sets are FixedPortMask<NumPorts>, one 32-bit word for a 24-port
+ *   switch rather than the four words of a PortMask
+ * - The table is held by value as its concrete engine type, so lookups and
+ *   learns are direct calls rather than virtual ones
+ * - With NoAging there is no wheel and no aging code; with NoObserver no
+ *   event is built, and neither leaves a per-frame branch behind
+ *
+ * VLANs, spanning tree states, egress modelling and table snapshots are
+ * runtime configuration and stay with Switch. Statistics are plain 64-bit
+ * counters, so unlike Switch they are read on the forwarding thread.
+ *
+ * @tparam NumPorts Number of physical ports (1..PortMask::kMaxPorts)
+ * @tparam AgingPolicy NoAging or FixedAging<...>
+ * @tparam TablePolicy MAC table engine class (FlatMacTable, HashMacTable, ConcurrentMacTable, CompactMacTable)
+ * @tparam ObserverPolicy NoObserver, RuntimeObserver, or a type with the same hooks
+ */
+template <int NumPorts, typename AgingPolicy = NoAging, typename TablePolicy = FlatMacTable,
+          typename ObserverPolicy = NoObserver>
+class BasicSwitch {
+    static_assert(std::is_base_of<MacTable, TablePolicy>::value,
+                  "BasicSwitch: TablePolicy must be a MacTable engine");
+
+public:
+    using Mask = FixedPortMask<NumPorts>;
+    using Decision = BasicForwardDecision<Mask>;
+
+    static constexpr int kPorts = NumPorts;
+
+    // Frames handled together inside processBurst(); longer bursts are split
+    static constexpr std::size_t kMaxBurst = 256;
+
+    /**
+     * @param tableCapacity Max MAC entries (0 = engine default)
+     * @param observer Observer policy instance
+     */
+    explicit BasicSwitch(std::size_t tableCapacity = 0, ObserverPolicy observer = ObserverPolicy())
+        : table(tableCapacity), observer(observer),
+          startTime(std::chrono::steady_clock::now()), currentCycle(0), framesProcessed(0) {
+        if constexpr (AgingPolicy::kEnabled) {
+            agingWheel = std::make_unique<AgingWheel>(AgingPolicy::kTimeout);
+        }
+        if constexpr (ObserverPolicy::kEnabled) {
+            this->observer.onSwitchCreated(NumPorts, static_cast<int>(AgingPolicy::kTimeout),
+                                           AgingPolicy::kClock);
+        }
+    }
+
+    /**
+     * @brief Processes one frame: admission, learning, forwarding decision
+     *
+     * Frames on a port the switch does not have, or tagged for a VLAN other
+     * than the default one, are dropped unlearned.
+     */
+    Decision processFrame(const FrameView& frame, int incomingPort) {
+        framesProcessed++;
+        PortStatistics& stats = statsOf(incomingPort);
+        stats.bytes += frame.wireLength();
+        if constexpr (ObserverPolicy::kEnabled) {
+            observer.onFrameReceived(framesProcessed, frame.sourceMAC, frame.destMAC, incomingPort);
+        }
+        if (!admits(frame, incomingPort)) {
+            return record(stats, Decision{ForwardKind::Drop, -1, Mask()}, frame.destMAC, incomingPort);
+        }
+
+        const FdbKey sourceKey(frame.sourceMAC, FdbKey::kDefaultVlan);
+        const MacTable::Timestamp stamp = now();
+        const LearnOutcome learned = table.learn(sourceKey, incomingPort, stamp);
+        countLearn(stats, learned);
+        scheduleAging(sourceKey, learned, stamp);
+        if constexpr (ObserverPolicy::kEnabled) {
+            observer.onLearn(frame.sourceMAC, incomingPort, learned);
+        }
+        return record(stats, decide(frame.destMAC, incomingPort), frame.destMAC, incomingPort);
+    }
+
+    /**
+     * @brief Header-only form with individual MAC parameters
+     */
+    Decision processFrame(MacAddress sourceMAC, MacAddress destMAC, int incomingPort) {
+        FrameView frame;
+        frame.destMAC = destMAC;
+        frame.sourceMAC = sourceMAC;
+        frame.etherType = EtherType::kIPv4;
+        return processFrame(frame, incomingPort);
+    }
+
+    /**
+     * @brief Processes a burst of frames in one call
+     *
+     * Same phases as Switch::processBurst(): one clock read per call, every
+     * source learned before any destination is looked up, and table buckets
+     * prefetched a phase ahead of use. Events are reported in burst order.
+     */
+    void processBurst(const FrameView* frames, const int* ports, std::size_t count, Decision* decisions) {
+        const MacTable::Timestamp stamp = now();
+        LearnOutcome learned[kMaxBurst];
+        bool admitted[kMaxBurst];
+
+        for (std::size_t base = 0; base < count; base += kMaxBurst) {
+            const std::size_t n = std::min(kMaxBurst, count - base);
+            const FrameView* burst = frames + base;
+            const int* burstPorts = ports + base;
+            Decision* burstDecisions = decisions + base;
+
+            // Phase 1: LEARNING for the whole burst
+            for (std::size_t i = 0; i < n; i++) {
+                admitted[i] = admits(burst[i], burstPorts[i]);
+                table.prefetch(FdbKey(burst[i].sourceMAC, FdbKey::kDefaultVlan));
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                if (!admitted[i]) {
+                    continue;
+                }
+                const FdbKey sourceKey(burst[i].sourceMAC, FdbKey::kDefaultVlan);
+                learned[i] = table.learn(sourceKey, burstPorts[i], stamp);
+                countLearn(statsOf(burstPorts[i]), learned[i]);
+                scheduleAging(sourceKey, learned[i], stamp);
+            }
+
+            // Phase 2: FORWARDING DECISIONS against the updated table
+            for (std::size_t i = 0; i < n; i++) {
+                if (admitted[i] && !burst[i].destMAC.isBroadcast()) {
+                    table.prefetch(FdbKey(burst[i].destMAC, FdbKey::kDefaultVlan));
+                }
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                burstDecisions[i] = admitted[i] ? decide(burst[i].destMAC, burstPorts[i])
+                                                : Decision{ForwardKind::Drop, -1, Mask()};
+            }
+
+            // Phase 3: statistics and reporting, in arrival order
+            for (std::size_t i = 0; i < n; i++) {
+                framesProcessed++;
+                PortStatistics& stats = statsOf(burstPorts[i]);
+                stats.bytes += burst[i].wireLength();
+                if constexpr (ObserverPolicy::kEnabled) {
+                    observer.onFrameReceived(framesProcessed, burst[i].sourceMAC,
+                                             burst[i].destMAC, burstPorts[i]);
+                    if (admitted[i]) {
+                        observer.onLearn(burst[i].sourceMAC, burstPorts[i], learned[i]);
+                    }
+                }
+                record(stats, burstDecisions[i], burst[i].destMAC, burstPorts[i]);
+            }
+        }
+
+        if constexpr (AgingPolicy::kEnabled && AgingPolicy::kBudgetPerBurst > 0) {
+            if (agingWheel->hasDueWork(stamp)) {
+                agingStep(AgingPolicy::kBudgetPerBurst);
+            }
+        }
+    }
+
+    /**
+     * @brief Forwarding rules for one destination (Switch::decide() over all ports)
+     */
+    Decision decide(MacAddress destMAC, int incomingPort) const {
+        if (destMAC.isBroadcast()) {
+            return {ForwardKind::Broadcast, -1, Mask::all().without(incomingPort)};
+        }
+        const int outPort = table.lookup(FdbKey(destMAC, FdbKey::kDefaultVlan));
+        if (!Mask::valid(outPort)) {
+            return {ForwardKind::UnknownUnicast, -1, Mask::all().without(incomingPort)};
+        }
+        if (outPort == incomingPort) {
+            return {ForwardKind::Filter, outPort, Mask()};
+        }
+        return {ForwardKind::Forward, outPort, Mask::single(outPort)};
+    }
+
+    /**
+     * @brief Removes aged-out entries (does nothing with NoAging)
+     */
+    void cleanupTable() { agingStep(0); }
+
+    /**
+     * @brief Performs a bounded slice of aging work
+     *
+     * @param budget Maximum scheduled entries to examine (0 = no limit)
+     * @return Number of entries removed
+     */
+    std::size_t agingStep(std::size_t budget) {
+        if constexpr (AgingPolicy::kEnabled) {
+            const std::size_t removed = agingWheel->advance(now(), table, budget,
+                [this](const MACTableEntry& entry, uint32_t elapsed) {
+                    if constexpr (ObserverPolicy::kEnabled) {
+                        observer.onAgeOut(entry.mac, elapsed, AgingPolicy::kClock);
+                    }
+                    (void)entry;
+                    (void)elapsed;
+                });
+            if constexpr (ObserverPolicy::kEnabled) {
+                observer.onAgingComplete(removed);
+            }
+            return removed;
+        } else {
+            (void)budget;
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Advances the simulation cycle (the logical clock)
+     */
+    void advanceCycle() { currentCycle++; }
+
+    void advanceCycles(uint32_t cycles) { currentCycle += cycles; }
+
+    uint32_t getCurrentCycle() const { return currentCycle; }
+
+    /**
+     * @brief Removes the addresses learned on one port
+     *
+     * @return Number of entries removed
+     * @throws std::invalid_argument if the port does not exist
+     */
+    std::size_t flushPort(int port) {
+        checkPort("flushPort", port);
+        return table.erasePorts(PortMask::single(port));
+    }
+
+    /**
+     * @brief Removes the addresses learned on any of a set of ports
+     */
+    std::size_t flushPorts(const Mask& ports) {
+        return ports.none() ? 0 : table.erasePorts(ports.toPortMask());
+    }
+
+    /**
+     * @brief Clears all learned MAC addresses
+     */
+    void clearMACTable() {
+        table.clear();
+        if constexpr (AgingPolicy::kEnabled) {
+            agingWheel->clear();
+        }
+        if constexpr (ObserverPolicy::kEnabled) {
+            observer.onTableCleared();
+        }
+    }
+
+    bool isLearned(MacAddress mac, uint16_t vlan = FdbKey::kDefaultVlan) const {
+        return table.lookup(FdbKey(mac, vlan)) != MacTable::kNoPort;
+    }
+
+    int getMACTableSize() const { return static_cast<int>(table.size()); }
+
+    /**
+     * @throws std::invalid_argument if the port does not exist
+     */
+    int getPortMACCount(int port) const {
+        checkPort("getPortMACCount", port);
+        return static_cast<int>(table.portCount(port));
+    }
+
+    /**
+     * @brief Counters summed over all ports
+     */
+    PortStatistics getStatistics() const {
+        PortStatistics total;
+        for (const PortStatistics& stats : portStats) {
+            total += stats;
+        }
+        return total;
+    }
+
+    /**
+     * @throws std::invalid_argument if the port does not exist
+     */
+    PortStatistics getPortStatistics(int port) const {
+        checkPort("getPortStatistics", port);
+        return portStats[port];
+    }
+
+    const TablePolicy& getTable() const { return table; }
+
+    ObserverPolicy& getObserver() { return observer; }
+
+private:
+    TablePolicy table;
+    ObserverPolicy observer;
+
+    // Expiry schedule (only allocated when AgingPolicy enables aging)
+    std::unique_ptr<AgingWheel> agingWheel;
+
+    // Reference point for wall-clock timestamps
+    std::chrono::steady_clock::time_point startTime;
+
+    // Simulation cycle counter (the logical clock epoch)
+    uint32_t currentCycle;
+
+    // Sequence number of the last frame received (observer numbering)
+    uint64_t framesProcessed;
+
+    // Counters indexed by port; 0 holds frames on non-existent ports
+    PortStatistics portStats[NumPorts + 1];
+
+    static bool admits(const FrameView& frame, int incomingPort) {
+        return Mask::valid(incomingPort) &&
+               (!frame.tagged || frame.vlan == 0 || frame.vlan == FdbKey::kDefaultVlan);
+    }
+
+    static void checkPort(const char* operation, int port) {
+        if (!Mask::valid(port)) {
+            throw std::invalid_argument(std::string(operation) + ": no such port " + std::to_string(port));
+        }
+    }
+
+    PortStatistics& statsOf(int port) { return portStats[Mask::valid(port) ? port : 0]; }
+
+    MacTable::Timestamp now() const {
+        if constexpr (AgingPolicy::kClock == AgingClock::Logical) {
+            return currentCycle;
+        } else {
+            return static_cast<MacTable::Timestamp>(std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now() - startTime).count());
+        }
+    }
+
+    static void countLearn(PortStatistics& stats, const LearnOutcome& outcome) {
+        stats.learned += outcome.result == LearnResult::Learned;
+        stats.moves += outcome.result == LearnResult::Moved;
+        stats.tableFull += outcome.result == LearnResult::TableFull;
+        stats.evictions += outcome.evicted();
+    }
+
+    void scheduleAging(FdbKey key, const LearnOutcome& outcome, MacTable::Timestamp stamp) {
+        if constexpr (AgingPolicy::kEnabled) {
+            if (outcome.result == LearnResult::Learned) {
+                agingWheel->schedule(key, stamp);
+            }
+        } else {
+            (void)key;
+            (void)outcome;
+            (void)stamp;
+        }
+    }
+
+    Decision record(PortStatistics& stats, const Decision& decision, MacAddress destMAC, int incomingPort) {
+        stats.decisions[static_cast<int>(decision.kind)]++;
+        if constexpr (ObserverPolicy::kEnabled) {
+            observer.onDecision(decision, destMAC, incomingPort);
+        }
+        (void)destMAC;
+        (void)incomingPort;
+        return decision;
+    }
+};
+
+#endif // BASIC_SWITCH_H
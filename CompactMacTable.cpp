@@ -0,0 +1,194 @@
+#include "CompactMacTable.h"
+#include <algorithm>
+
+CompactMacTable::CompactMacTable(std::size_t capacity, EvictionPolicy eviction)
+    : counts(PortMask::kMaxPorts + 1, 0), policy(eviction),
+      maxEntries(capacity > 0 ? capacity : kDefaultCapacity), count(0) {
+    // An 80% load keeps linear probe chains within a couple of cache lines;
+    // at least one slot always stays empty, which ends every probe
+    slotCount = std::max<std::size_t>(16, maxEntries + (maxEntries + 3) / 4);
+    entries.assign(slotCount, Entry{kEmptyKey, 0, 0, 0});
+    if (policy == EvictionPolicy::LRU) {
+        lruIndex = EvictionIndex(EvictionPolicy::LRU, slotCount);
+    }
+}
+
+std::size_t CompactMacTable::probe(uint64_t key) const {
+    std::size_t slot = homeSlot(key);
+    while (entries[slot].key != key && entries[slot].key != kEmptyKey) {
+        slot = nextSlot(slot);
+    }
+    return slot;
+}
+
+std::size_t CompactMacTable::victim(std::size_t start) {
+    if (policy == EvictionPolicy::LRU) {
+        return lruIndex.victim();
+    }
+    // CLOCK over the records' own flags; two full turns clear every mark
+    std::size_t slot = start;
+    for (std::size_t step = 0; step < 2 * slotCount; step++, slot = nextSlot(slot)) {
+        Entry& entry = entries[slot];
+        if (entry.key == kEmptyKey) {
+            continue;
+        }
+        if (entry.flags & kReferenced) {
+            entry.flags &= static_cast<uint16_t>(~kReferenced);
+        } else {
+            return slot;
+        }
+    }
+    return start;
+}
+
+LearnOutcome CompactMacTable::learn(FdbKey key, int port, Timestamp now) {
+    const uint64_t bits = key.toUint64();
+    std::size_t slot = probe(bits);
+
+    if (entries[slot].key == kEmptyKey) {
+        LearnOutcome outcome{LearnResult::Learned, port};
+        if (count >= maxEntries) {
+            if (policy == EvictionPolicy::NoLearn) {
+                return {LearnResult::TableFull, port};
+            }
+            const std::size_t evicted = victim(homeSlot(bits));
+            outcome.evictedKey = FdbKey::fromUint64(entries[evicted].key);
+            outcome.evictedPort = entries[evicted].port;
+            eraseSlot(evicted);
+            // Backward shifting may have moved the end of this key's probe chain
+            slot = probe(bits);
+        }
+        entries[slot] = Entry{bits, static_cast<uint16_t>(port), kReferenced, now};
+        counts[listOf(entries[slot].port)]++;
+        lruIndex.insert(slot);
+        count++;
+        return outcome;
+    }
+
+    Entry& entry = entries[slot];
+    entry.timestamp = now;
+    entry.flags |= kReferenced;
+    lruIndex.touch(slot);
+    if (entry.port != port) {
+        const int previous = entry.port;
+        counts[listOf(previous)]--;
+        entry.port = static_cast<uint16_t>(port);
+        counts[listOf(entry.port)]++;
+        return {LearnResult::Moved, previous};
+    }
+    return {LearnResult::Refreshed, port};
+}
+
+int CompactMacTable::lookup(FdbKey key) const {
+    const Entry& entry = entries[probe(key.toUint64())];
+    return entry.key == kEmptyKey ? kNoPort : entry.port;
+}
+
+bool CompactMacTable::find(FdbKey key, MACTableEntry& out) const {
+    const std::size_t slot = probe(key.toUint64());
+    if (entries[slot].key == kEmptyKey) {
+        return false;
+    }
+    out = entryAt(slot);
+    return true;
+}
+
+void CompactMacTable::eraseSlot(std::size_t slot) {
+    // Backward-shift deletion, moving whole records
+    counts[listOf(entries[slot].port)]--;
+    lruIndex.remove(slot);
+    std::size_t hole = slot;
+    std::size_t next = nextSlot(hole);
+    while (entries[next].key != kEmptyKey) {
+        const std::size_t home = homeSlot(entries[next].key);
+        if (distance(home, hole) < distance(home, next)) {
+            entries[hole] = entries[next];
+            lruIndex.relocate(next, hole);
+            hole = next;
+        }
+        next = nextSlot(next);
+    }
+    entries[hole].key = kEmptyKey;
+    count--;
+}
+
+bool CompactMacTable::erase(FdbKey key) {
+    const std::size_t slot = probe(key.toUint64());
+    if (entries[slot].key == kEmptyKey) {
+        return false;
+    }
+    eraseSlot(slot);
+    return true;
+}
+
+std::size_t CompactMacTable::eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) {
+    // Collect first: backward shifting would move unvisited entries into
+    // slots the scan has already passed
+    std::vector<uint64_t> victims;
+    for (std::size_t slot = 0; slot < slotCount; slot++) {
+        if (entries[slot].key != kEmptyKey && predicate(entryAt(slot))) {
+            victims.push_back(entries[slot].key);
+        }
+    }
+    for (uint64_t key : victims) {
+        eraseSlot(probe(key));
+    }
+    return victims.size();
+}
+
+std::size_t CompactMacTable::erasePorts(const PortMask& ports) {
+    // Flushing ports that hold nothing (the common case on a link flap) is free
+    PortMask occupied;
+    ports.forEach([&](int port) {
+        if (counts[listOf(port)] > 0) {
+            occupied.set(port);
+        }
+    });
+    if (occupied.none()) {
+        return 0;
+    }
+    std::vector<uint64_t> victims;
+    for (std::size_t slot = 0; slot < slotCount; slot++) {
+        if (entries[slot].key != kEmptyKey && occupied.test(entries[slot].port)) {
+            victims.push_back(entries[slot].key);
+        }
+    }
+    for (uint64_t key : victims) {
+        eraseSlot(probe(key));
+    }
+    return victims.size();
+}
+
+void CompactMacTable::forEach(const std::function<void(const MACTableEntry&)>& visit) const {
+    for (std::size_t slot = 0; slot < slotCount; slot++) {
+        if (entries[slot].key != kEmptyKey) {
+            visit(entryAt(slot));
+        }
+    }
+}
+
+void CompactMacTable::clear() {
+    for (Entry& entry : entries) {
+        entry.key = kEmptyKey;
+    }
+    std::fill(counts.begin(), counts.end(), 0);
+    lruIndex.clear();
+    count = 0;
+}
+
+MemoryUsage CompactMacTable::memoryUsage() const {
+    MemoryUsage usage;
+    usage.bytes = entries.capacity() * sizeof(Entry) + counts.capacity() * sizeof(uint32_t) +
+                  lruIndex.allocatedBytes();
+    usage.slots = slotCount;
+    usage.entries = count;
+    return usage;
+}
+
+void CompactMacTable::prefetch(FdbKey key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&entries[homeSlot(key.toUint64())]);
+#else
+    (void)key;
+#endif
+}
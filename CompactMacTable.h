@@ -0,0 +1,113 @@
+#ifndef COMPACT_MAC_TABLE_H
+#define COMPACT_MAC_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "EvictionIndex.h"
+#include "MacTable.h"
+
+/**
+ * @brief Open-addressing MAC table with one 16-byte record per slot
+ *
+ * Built for populations in the millions, where the table's footprint
+ * matters more than port flush speed. Each slot is one record: the packed
+ * (VLAN, MAC) key (48-bit MAC, 12-bit VID), a 16-bit port, flags and the
+ * 32-bit last-seen time. Four records share a cache line, so a hit, a
+ * refresh or a move touches one line where FlatMacTable's parallel arrays
+ * touch three.
+ *
+ * Nothing else is kept per slot. There are no per-port lists, so flushing a
+ * port scans the table (ports with no entries are skipped using per-port
+ * counts). CLOCK eviction keeps its reference bit in the record's flags and
+ * sweeps from the new key's home slot, the way a hashed CAM replaces within
+ * a bucket: a global hand would gather the free slots behind it and leave
+ * the rest of a heavily loaded table with no empty slot to end a probe. LRU
+ * needs list links, which do not fit, so an LRU table adds an EvictionIndex
+ * (8 bytes per slot). The slot count is not rounded to a power of two but
+ * sized to the capacity at an 80% load, and keys map to slots by a
+ * multiply-shift instead of a mask, so a full table costs 20 bytes per
+ * entry. Deletion uses backward shifting, as in FlatMacTable.
+ */
+class CompactMacTable final : public MacTable {
+public:
+    // Default capacity when none is given, in the range of real switch CAMs
+    static constexpr std::size_t kDefaultCapacity = 32768;
+
+    /**
+     * @param capacity Maximum entries (0 = kDefaultCapacity)
+     * @param eviction What learn() does when all capacity entries are in use
+     */
+    explicit CompactMacTable(std::size_t capacity = 0, EvictionPolicy eviction = EvictionPolicy::NoLearn);
+
+    LearnOutcome learn(FdbKey key, int port, Timestamp now) override;
+    int lookup(FdbKey key) const override;
+    bool find(FdbKey key, MACTableEntry& out) const override;
+    bool erase(FdbKey key) override;
+    std::size_t eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) override;
+    std::size_t erasePorts(const PortMask& ports) override;
+    std::size_t portCount(int port) const override { return counts[listOf(port)]; }
+    void forEach(const std::function<void(const MACTableEntry&)>& visit) const override;
+    void clear() override;
+    std::size_t size() const override { return count; }
+    std::size_t capacity() const override { return maxEntries; }
+    EvictionPolicy eviction() const override { return policy; }
+    void prefetch(FdbKey key) const override;
+    MemoryUsage memoryUsage() const override;
+    const char* name() const override { return "compact"; }
+
+private:
+    // Marks an unused slot; no 60-bit (VLAN, MAC) key can collide with it
+    static constexpr uint64_t kEmptyKey = ~0ULL;
+
+    // Set on every learn and refresh; cleared by a CLOCK sweep passing
+    static constexpr uint16_t kReferenced = 1;
+
+    struct alignas(16) Entry {
+        uint64_t key;           // Packed (VLAN, MAC), or kEmptyKey
+        uint16_t port;          // Learned port
+        uint16_t flags;         // kReferenced
+        Timestamp timestamp;    // Last-seen time
+    };
+    static_assert(sizeof(Entry) == 16, "CompactMacTable: an entry must stay 16 bytes");
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> counts;   // Entries per port; ports outside 1..kMaxPorts share 0
+    EvictionPolicy policy;
+    EvictionIndex lruIndex;         // Replacement order (LRU only)
+
+    std::size_t slotCount;      // Slots allocated (not a power of two)
+    std::size_t maxEntries;     // Entries allowed before learning fails
+    std::size_t count;          // Entries currently stored
+
+    static std::size_t listOf(int port) {
+        return PortMask::valid(port) ? static_cast<std::size_t>(port) : 0;
+    }
+
+    // High 32 bits of the hash scaled to the slot count (no division)
+    std::size_t homeSlot(uint64_t key) const {
+        return static_cast<std::size_t>(((FdbKey::fromUint64(key).hash() >> 32) * slotCount) >> 32);
+    }
+
+    std::size_t nextSlot(std::size_t slot) const { return slot + 1 == slotCount ? 0 : slot + 1; }
+
+    // Probe distance from a key's home slot, across the wrap-around
+    std::size_t distance(std::size_t home, std::size_t slot) const {
+        return slot >= home ? slot - home : slot + slotCount - home;
+    }
+
+    MACTableEntry entryAt(std::size_t slot) const {
+        const Entry& entry = entries[slot];
+        const FdbKey key = FdbKey::fromUint64(entry.key);
+        return MACTableEntry{key.mac(), entry.port, entry.timestamp, key.vlan()};
+    }
+
+    // Returns the slot holding key, or the empty slot that ends its probe chain
+    std::size_t probe(uint64_t key) const;
+
+    // Slot to evict from a full table to make room near start
+    std::size_t victim(std::size_t start);
+
+    void eraseSlot(std::size_t slot);
+};
+
+#endif // COMPACT_MAC_TABLE_H
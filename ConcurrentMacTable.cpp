@@ -0,0 +1,312 @@
+#include "ConcurrentMacTable.h"
+#include <thread>
+#include <vector>
+
+ConcurrentMacTable::ConcurrentMacTable(std::size_t capacity)
+    : maxEntries(capacity > 0 ? capacity : kDefaultCapacity), count(0), layoutSeq(0) {
+    // Keep the load factor at or below 75% so probe chains stay short and
+    // every chain ends in an empty slot
+    std::size_t slotCount = 16;
+    while (slotCount - slotCount / 4 < maxEntries) {
+        slotCount <<= 1;
+    }
+    slotMask = slotCount - 1;
+
+    slots.reset(new Slot[slotCount]);
+    for (std::size_t slot = 0; slot < slotCount; slot++) {
+        slots[slot].key.store(kEmptyKey, std::memory_order_relaxed);
+        slots[slot].state.store(0, std::memory_order_relaxed);
+    }
+    portIndex = PortIndex(slotCount);
+}
+
+uint32_t ConcurrentMacTable::readBegin() const {
+    uint32_t seq = layoutSeq.load(std::memory_order_acquire);
+    for (int spins = 0; seq & 1; spins++) {
+        // An erase is moving entries; it is short unless the writer was preempted
+        if (spins >= 64) {
+            std::this_thread::yield();
+        }
+        seq = layoutSeq.load(std::memory_order_acquire);
+    }
+    return seq;
+}
+
+bool ConcurrentMacTable::readValid(uint32_t seq) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return layoutSeq.load(std::memory_order_relaxed) == seq;
+}
+
+void ConcurrentMacTable::beginLayoutChange() {
+    layoutSeq.store(layoutSeq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ConcurrentMacTable::endLayoutChange() {
+    layoutSeq.store(layoutSeq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::size_t ConcurrentMacTable::probe(uint64_t key, uint64_t& found) const {
+    std::size_t slot = homeSlot(key);
+    // Bounded so a reader racing an erase cannot loop; the sequence check
+    // discards whatever it returns in that case
+    for (std::size_t step = 0; step <= slotMask; step++) {
+        found = slots[slot].key.load(std::memory_order_acquire);
+        if (found == kEmptyKey || found == key) {
+            return slot;
+        }
+        slot = (slot + 1) & slotMask;
+    }
+    found = kEmptyKey;
+    return slot;
+}
+
+LearnOutcome ConcurrentMacTable::learnLocked(uint64_t key, int port, Timestamp now) {
+    // Only mutex holders change the layout, so this probe is stable
+    uint64_t found;
+    const std::size_t slot = probe(key, found);
+    Slot& entry = slots[slot];
+
+    if (found == kEmptyKey) {
+        if (count.load(std::memory_order_relaxed) >= maxEntries) {
+            return {LearnResult::TableFull, port};
+        }
+        // Port and timestamp first: the release store of the key publishes them
+        entry.state.store(placeState(entry.state.load(std::memory_order_relaxed), port, now),
+                          std::memory_order_release);
+        entry.key.store(key, std::memory_order_release);
+        portIndex.insert(slot, port);
+        count.fetch_add(1, std::memory_order_relaxed);
+        return {LearnResult::Learned, port};
+    }
+
+    // Same entry, so the tag stays; lock-free refreshes may race the update
+    uint64_t old = entry.state.load(std::memory_order_relaxed);
+    while (!entry.state.compare_exchange_weak(old, packState(tagOf(old), port, now),
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+    }
+    const int previous = portOf(old);
+    if (previous != port) {
+        portIndex.remove(slot, previous);
+        portIndex.insert(slot, port);
+        return {LearnResult::Moved, previous};
+    }
+    return {LearnResult::Refreshed, port};
+}
+
+LearnOutcome ConcurrentMacTable::learn(FdbKey fdbKey, int port, Timestamp now) {
+    const uint64_t key = fdbKey.toUint64();
+
+    // Fast path: a known station seen again on its port only needs a new
+    // timestamp, written without the mutex
+    for (;;) {
+        const uint32_t seq = readBegin();
+        uint64_t found;
+        const std::size_t slot = probe(key, found);
+        Slot& entry = slots[slot];
+        uint64_t state = entry.state.load(std::memory_order_acquire);
+        if (found == kEmptyKey || portOf(state) != port) {
+            if (!readValid(seq)) {
+                continue;
+            }
+            break;
+        }
+        // The state word read must be this key's. A slot is re-placed by
+        // clearing its key, storing the new state and then the key, so a
+        // state read before the key is confirmed either is this entry's or
+        // predates it, and then its tag makes the CAS below fail
+        if (entry.key.load(std::memory_order_acquire) != key) {
+            continue;
+        }
+        // Fails if this slot was re-placed since: the store can only ever
+        // land on this key's entry, never on one shifted in by an erase
+        if (!entry.state.compare_exchange_strong(state, packState(tagOf(state), port, now),
+                                                 std::memory_order_relaxed)) {
+            continue;
+        }
+        // The entry may have been shifted away before the CAS, leaving the
+        // new time in the slot it left; the erase changed the sequence
+        if (readValid(seq)) {
+            return {LearnResult::Refreshed, port};
+        }
+    }
+
+    // New stations and moves change a slot's key or port; doing that under
+    // the mutex means no erase can shift the slot mid-update, and two workers
+    // moving one station each report the port they actually replaced
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return learnLocked(key, port, now);
+}
+
+int ConcurrentMacTable::lookup(FdbKey fdbKey) const {
+    const uint64_t key = fdbKey.toUint64();
+    for (;;) {
+        const uint32_t seq = readBegin();
+        uint64_t found;
+        const std::size_t slot = probe(key, found);
+        const int port = portOf(slots[slot].state.load(std::memory_order_relaxed));
+        if (readValid(seq)) {
+            return found == kEmptyKey ? kNoPort : port;
+        }
+    }
+}
+
+bool ConcurrentMacTable::find(FdbKey fdbKey, MACTableEntry& out) const {
+    const uint64_t key = fdbKey.toUint64();
+    for (;;) {
+        const uint32_t seq = readBegin();
+        uint64_t found;
+        const std::size_t slot = probe(key, found);
+        const MACTableEntry entry = entryAt(slot, key);
+        if (!readValid(seq)) {
+            continue;
+        }
+        if (found == kEmptyKey) {
+            return false;
+        }
+        out = entry;
+        return true;
+    }
+}
+
+void ConcurrentMacTable::eraseSlot(std::size_t slot) {
+    // Backward-shift deletion, as in FlatMacTable
+    portIndex.remove(slot, portOf(slots[slot].state.load(std::memory_order_relaxed)));
+    std::size_t hole = slot;
+    std::size_t next = (hole + 1) & slotMask;
+    for (;;) {
+        const uint64_t key = slots[next].key.load(std::memory_order_relaxed);
+        if (key == kEmptyKey) {
+            break;
+        }
+        const std::size_t home = homeSlot(key);
+        const std::size_t distNext = (next - home) & slotMask;
+        const std::size_t distHole = (hole - home) & slotMask;
+        if (distHole < distNext) {
+            // Key cleared, new tag, then the key: a learner that reads the
+            // new state also sees the cleared key, so it cannot mistake the
+            // moved entry for its own, and refreshes prepared against the
+            // hole's old entry fail on the tag
+            const uint64_t moved = slots[next].state.load(std::memory_order_relaxed);
+            const uint64_t old = slots[hole].state.load(std::memory_order_relaxed);
+            slots[hole].key.store(kEmptyKey, std::memory_order_relaxed);
+            slots[hole].state.store(placeState(old, portOf(moved), timestampOf(moved)),
+                                    std::memory_order_release);
+            slots[hole].key.store(key, std::memory_order_release);
+            portIndex.relocate(next, hole, portOf(moved));
+            hole = next;
+        }
+        next = (next + 1) & slotMask;
+    }
+    const uint64_t old = slots[hole].state.load(std::memory_order_relaxed);
+    slots[hole].state.store(placeState(old, 0, 0), std::memory_order_relaxed);
+    slots[hole].key.store(kEmptyKey, std::memory_order_release);
+    count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool ConcurrentMacTable::erase(FdbKey key) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    uint64_t found;
+    const std::size_t slot = probe(key.toUint64(), found);
+    if (found == kEmptyKey) {
+        return false;
+    }
+    beginLayoutChange();
+    eraseSlot(slot);
+    endLayoutChange();
+    return true;
+}
+
+std::size_t ConcurrentMacTable::eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    // Collect first: backward shifting would move unvisited entries into
+    // slots the scan has already passed
+    std::vector<uint64_t> victims;
+    for (std::size_t slot = 0; slot <= slotMask; slot++) {
+        const uint64_t key = slots[slot].key.load(std::memory_order_acquire);
+        if (key != kEmptyKey && predicate(entryAt(slot, key))) {
+            victims.push_back(key);
+        }
+    }
+    if (victims.empty()) {
+        return 0;
+    }
+
+    beginLayoutChange();
+    std::size_t removed = 0;
+    for (uint64_t key : victims) {
+        uint64_t found;
+        const std::size_t slot = probe(key, found);
+        if (found != kEmptyKey) {
+            eraseSlot(slot);
+            removed++;
+        }
+    }
+    endLayoutChange();
+    return removed;
+}
+
+std::size_t ConcurrentMacTable::erasePorts(const PortMask& ports) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    std::size_t removed = 0;
+    ports.forEach([&](int port) {
+        if (portIndex.count(port) == 0) {
+            return;
+        }
+        beginLayoutChange();
+        // Erasing a list's head makes its successor (possibly shifted) the new head
+        for (uint32_t slot = portIndex.first(port); slot != PortIndex::kNone;
+             slot = portIndex.first(port)) {
+            eraseSlot(slot);
+            removed++;
+        }
+        endLayoutChange();
+    });
+    return removed;
+}
+
+std::size_t ConcurrentMacTable::portCount(int port) const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return portIndex.count(port);
+}
+
+void ConcurrentMacTable::forEach(const std::function<void(const MACTableEntry&)>& visit) const {
+    // Holding the mutex keeps entries from shifting, so each is seen once
+    std::lock_guard<std::mutex> lock(writeMutex);
+    for (std::size_t slot = 0; slot <= slotMask; slot++) {
+        const uint64_t key = slots[slot].key.load(std::memory_order_acquire);
+        if (key != kEmptyKey) {
+            visit(entryAt(slot, key));
+        }
+    }
+}
+
+void ConcurrentMacTable::clear() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    beginLayoutChange();
+    for (std::size_t slot = 0; slot <= slotMask; slot++) {
+        slots[slot].key.store(kEmptyKey, std::memory_order_relaxed);
+    }
+    portIndex.clear();
+    count.store(0, std::memory_order_relaxed);
+    endLayoutChange();
+}
+
+MemoryUsage ConcurrentMacTable::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    MemoryUsage usage;
+    usage.bytes = (slotMask + 1) * sizeof(Slot) + portIndex.allocatedBytes();
+    usage.slots = slotMask + 1;
+    usage.entries = count.load(std::memory_order_relaxed);
+    return usage;
+}
+
+void ConcurrentMacTable::prefetch(FdbKey key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&slots[homeSlot(key.toUint64())]);
+#else
+    (void)key;
+#endif
+}
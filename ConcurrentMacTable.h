@@ -0,0 +1,136 @@
+#ifndef CONCURRENT_MAC_TABLE_H
+#define CONCURRENT_MAC_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "MacTable.h"
+#include "PortIndex.h"
+
+/**
+ * @brief Open-addressing MAC table safe for concurrent learners and lookups
+ *
+ * Built for the multi-worker pipeline, where every worker looks up
+ * destinations and refreshes sources on every frame, while new stations,
+ * deletions and aging are comparatively rare:
+ *
+ * - Each slot holds its (VLAN, MAC) key in one atomic word and its port and
+ *   last-seen time in another, together with a tag that changes whenever a
+ *   different entry is placed in the slot. A key is published last and only
+ *   changes under the writer mutex, so lookups are wait-free loads.
+ * - Refreshes, by far the most common learn, take no lock: one CAS on the
+ *   port and time word, which fails if the slot was re-placed after it was
+ *   read, so a refresh racing an erase never stamps another station.
+ * - Insertions and station moves take a writer mutex. Insertions fill an
+ *   empty slot at the end of a probe chain and never move existing entries,
+ *   so readers need no retry. Two workers moving the same station are
+ *   serialized and each reports the port it actually replaced.
+ * - Erasure uses backward shifting like FlatMacTable, which does move
+ *   entries. It runs under a table-wide sequence lock; readers and learners
+ *   that overlap a shift see the sequence change and retry.
+ *
+ * Lookups only ever wait on an erase in progress, never on inserts or on
+ * each other. The per-port lists of a PortIndex only change with a slot's
+ * key or port, so they are kept under the writer mutex and refreshes never
+ * touch them.
+ */
+class ConcurrentMacTable final : public MacTable {
+public:
+    // Default capacity when none is given, in the range of real switch CAMs
+    static constexpr std::size_t kDefaultCapacity = 32768;
+
+    /**
+     * @param capacity Maximum entries (0 = kDefaultCapacity)
+     */
+    explicit ConcurrentMacTable(std::size_t capacity = 0);
+
+    LearnOutcome learn(FdbKey key, int port, Timestamp now) override;
+    int lookup(FdbKey key) const override;
+    bool find(FdbKey key, MACTableEntry& out) const override;
+    bool erase(FdbKey key) override;
+    std::size_t eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) override;
+    std::size_t erasePorts(const PortMask& ports) override;
+    std::size_t portCount(int port) const override;
+    void forEach(const std::function<void(const MACTableEntry&)>& visit) const override;
+    void clear() override;
+    std::size_t size() const override { return count.load(std::memory_order_relaxed); }
+    std::size_t capacity() const override { return maxEntries; }
+    void prefetch(FdbKey key) const override;
+    MemoryUsage memoryUsage() const override;
+    const char* name() const override { return "concurrent"; }
+
+private:
+    // Marks an unused slot; no 60-bit (VLAN, MAC) key can equal it
+    static constexpr uint64_t kEmptyKey = ~0ULL;
+
+    // State word layout: placement tag, port, last-seen time
+    static constexpr int kTagShift = 44;
+    static constexpr uint64_t kPortMask = 0xFFF;    // Ports up to 4095
+    static constexpr uint64_t kTagMask = (1ULL << (64 - kTagShift)) - 1;
+
+    struct Slot {
+        std::atomic<uint64_t> key;          // Packed FdbKey, or kEmptyKey
+        std::atomic<uint64_t> state;        // packState(tag, port, timestamp)
+    };
+
+    static uint64_t packState(uint64_t tag, int port, Timestamp timestamp) {
+        return (tag & kTagMask) << kTagShift |
+               (static_cast<uint64_t>(port) & kPortMask) << 32 | timestamp;
+    }
+    static uint64_t tagOf(uint64_t state) { return state >> kTagShift; }
+    static int portOf(uint64_t state) { return static_cast<int>((state >> 32) & kPortMask); }
+    static Timestamp timestampOf(uint64_t state) { return static_cast<Timestamp>(state); }
+
+    // State for a new entry in a slot whose state was old: a fresh tag fails
+    // any refresh CAS prepared against the slot's previous contents
+    static uint64_t placeState(uint64_t old, int port, Timestamp timestamp) {
+        return packState(tagOf(old) + 1, port, timestamp);
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slotMask;           // Slot count - 1 (slot count is a power of two)
+    std::size_t maxEntries;         // Entries allowed before learning fails
+    std::atomic<std::size_t> count; // Entries currently stored
+
+    // Even when the layout is stable, odd while an erase is shifting entries
+    std::atomic<uint32_t> layoutSeq;
+
+    // Serializes insertions, erasures and whole-table operations
+    mutable std::mutex writeMutex;
+
+    // Occupied slots per port; guarded by writeMutex
+    PortIndex portIndex;
+
+    std::size_t homeSlot(uint64_t key) const {
+        return static_cast<std::size_t>(FdbKey::fromUint64(key).hash()) & slotMask;
+    }
+
+    // Entry in a slot whose key was read as key
+    MACTableEntry entryAt(std::size_t slot, uint64_t key) const {
+        const FdbKey fdbKey = FdbKey::fromUint64(key);
+        const uint64_t state = slots[slot].state.load(std::memory_order_relaxed);
+        return MACTableEntry{fdbKey.mac(), portOf(state), timestampOf(state), fdbKey.vlan()};
+    }
+
+    // Returns the slot holding key, or the empty slot that ends its chain;
+    // found receives the slot's key as read (key or kEmptyKey)
+    std::size_t probe(uint64_t key, uint64_t& found) const;
+
+    // Seqlock read side: waits for a stable layout and returns its sequence
+    uint32_t readBegin() const;
+
+    // True if no erase started since readBegin() returned seq
+    bool readValid(uint32_t seq) const;
+
+    // Inserts or moves an entry; caller holds writeMutex
+    LearnOutcome learnLocked(uint64_t key, int port, Timestamp now);
+
+    // Backward-shift removal; caller holds writeMutex inside an odd layoutSeq
+    void eraseSlot(std::size_t slot);
+
+    void beginLayoutChange();
+    void endLayoutChange();
+};
+
+#endif // CONCURRENT_MAC_TABLE_H
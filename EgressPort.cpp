@@ -0,0 +1,115 @@
+#include "EgressPort.h"
+#include <stdexcept>
+
+EgressPort::EgressPort(const EgressConfig& config)
+    : quantum(config.quantum), strictClasses(config.strictClasses),
+      drrCursor(kClasses - 1 - config.strictClasses), freshVisit(true),
+      lineRate(config.lineRate), credit(0), backlog(0) {
+    if (config.queueDepth == 0) {
+        throw std::invalid_argument("EgressPort: queue depth must be at least 1");
+    }
+    if (config.strictClasses < 0 || config.strictClasses > kClasses) {
+        throw std::invalid_argument("EgressPort: strict classes must be between 0 and 8");
+    }
+    for (int tc = 0; tc < kClasses - strictClasses; ++tc) {
+        if (quantum[tc] == 0) {
+            throw std::invalid_argument("EgressPort: DRR quantum must be at least 1 byte");
+        }
+    }
+
+    for (EgressQueue& queue : queues) {
+        queue = EgressQueue(config.queueDepth);
+    }
+    deficit.fill(0);
+}
+
+bool EgressPort::enqueue(const PacketDescriptor& descriptor) {
+    const int tc = descriptor.trafficClass;
+    QueueCounters& stats = counters[tc];
+    if (!queues[tc].push(descriptor)) {
+        stats.dropped++;
+        return false;
+    }
+    stats.enqueued++;
+    if (queues[tc].size() > stats.maxDepth) {
+        stats.maxDepth = queues[tc].size();
+    }
+    backlog++;
+    return true;
+}
+
+bool EgressPort::dequeue(uint32_t now, PacketDescriptor& out) {
+    const int tc = selectClass();
+    if (tc < 0) {
+        return false;
+    }
+    out = queues[tc].front();
+    commit(tc, now);
+    return true;
+}
+
+int EgressPort::selectClass() {
+    if (backlog == 0) {
+        return -1;
+    }
+
+    // Strict classes, highest first
+    for (int tc = kClasses - 1; tc >= kClasses - strictClasses; --tc) {
+        if (!queues[tc].empty()) {
+            return tc;
+        }
+    }
+
+    // Deficit round robin over the rest. Some queue is non-empty, and it
+    // gains a quantum each round, so this ends once its deficit covers the
+    // head frame.
+    for (;;) {
+        const int tc = drrCursor;
+        if (queues[tc].empty()) {
+            deficit[tc] = 0;
+            advanceDrr();
+            continue;
+        }
+        if (freshVisit) {
+            deficit[tc] += quantum[tc];
+            freshVisit = false;
+        }
+        if (queues[tc].front().length <= deficit[tc]) {
+            return tc;
+        }
+        advanceDrr();
+    }
+}
+
+void EgressPort::commit(int trafficClass, uint32_t now) {
+    EgressQueue& queue = queues[trafficClass];
+    const PacketDescriptor& head = queue.front();
+
+    QueueCounters& stats = counters[trafficClass];
+    const uint32_t sojourn = now - head.enqueueCycle;
+    stats.transmitted++;
+    stats.bytesTransmitted += head.length;
+    stats.sojournTotal += sojourn;
+    if (sojourn > stats.sojournMax) {
+        stats.sojournMax = sojourn;
+    }
+
+    if (trafficClass < kClasses - strictClasses) {
+        deficit[trafficClass] -= head.length;
+        queue.pop();
+        if (queue.empty()) {
+            // An empty queue may not save up its allowance
+            deficit[trafficClass] = 0;
+            advanceDrr();
+        }
+    } else {
+        queue.pop();
+    }
+    backlog--;
+}
+
+void EgressPort::advanceDrr() {
+    // Classes below the strict ones, visited from high to low
+    drrCursor = (drrCursor == 0) ? kClasses - 1 - strictClasses : drrCursor - 1;
+    freshVisit = true;
+}
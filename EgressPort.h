@@ -0,0 +1,136 @@
+#ifndef EGRESS_PORT_H
+#define EGRESS_PORT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "EgressQueue.h"
+
+/**
+ * @brief Output-side settings shared by every port of a switch
+ */
+struct EgressConfig {
+    static constexpr int kTrafficClasses = 8;
+
+    std::size_t queueDepth = 128;   // Frames per traffic class queue; more are tail-dropped
+    uint32_t lineRate = 0;          // Bytes each port may send per simulation cycle (0 = unlimited)
+    int strictClasses = 1;          // Highest classes served by strict priority (0-8)
+
+    // DRR quantum in bytes for each class below the strict ones
+    std::array<uint32_t, kTrafficClasses> quantum = {1536, 1536, 1536, 1536, 1536, 1536, 1536, 1536};
+};
+
+/**
+ * @brief Output side of one switch port: 8 class queues and their scheduler
+ *
+ * Traffic class 7 is the highest. The top strictClasses classes are served
+ * by strict priority: nothing else is sent while one of them has a frame.
+ * The remaining classes share what is left by deficit round robin, each
+ * receiving its quantum of bytes per round, so their long-run shares are
+ * proportional to their quanta regardless of frame sizes.
+ *
+ * Line rate is enforced with byte credit: every cycle adds lineRate bytes
+ * and a frame is sent only when its whole length is covered. Credit left
+ * over by a frame that does not fit carries to the next cycle, so frames
+ * larger than one cycle's rate still go out; an idle port does not bank
+ * credit.
+ */
+class EgressPort {
+public:
+    /**
+     * @throws std::invalid_argument if the configuration is out of range
+     */
+    explicit EgressPort(const EgressConfig& config);
+
+    /**
+     * @brief True if a frame of this class would be accepted
+     */
+    bool hasRoom(int trafficClass) const { return !queues[trafficClass].full(); }
+
+    /**
+     * @brief Queues a descriptor in its traffic class
+     *
+     * @return false (and counts a drop) if that queue is full
+     */
+    bool enqueue(const PacketDescriptor& descriptor);
+
+    /**
+     * @brief Records a frame refused without calling enqueue()
+     */
+    void countDrop(int trafficClass) { counters[trafficClass].dropped++; }
+
+    /**
+     * @brief Removes the next frame in scheduling order, ignoring line rate
+     *
+     * @param now Current cycle, for sojourn accounting
+     * @return false if every queue is empty
+     */
+    bool dequeue(uint32_t now, PacketDescriptor& out);
+
+    /**
+     * @brief Sends what one cycle of line rate allows
+     *
+     * @param now Current cycle, for sojourn accounting
+     * @param send Called with each descriptor removed
+     * @return Number of frames sent
+     */
+    template <typename Fn>
+    std::size_t serviceCycle(uint32_t now, Fn send) {
+        if (backlog == 0) {
+            return 0;
+        }
+        credit += lineRate;
+        std::size_t sent = 0;
+        for (int tc = selectClass(); tc >= 0; tc = selectClass()) {
+            const PacketDescriptor& head = queues[tc].front();
+            if (lineRate > 0 && head.length > credit) {
+                break;  // Resumes with this frame next cycle
+            }
+            if (lineRate > 0) {
+                credit -= head.length;
+            }
+            const PacketDescriptor descriptor = head;
+            commit(tc, now);
+            send(descriptor);
+            sent++;
+        }
+        if (backlog == 0) {
+            credit = 0;
+        }
+        return sent;
+    }
+
+    /**
+     * @brief Frames waiting in all classes
+     */
+    std::size_t size() const { return backlog; }
+
+    std::size_t size(int trafficClass) const { return queues[trafficClass].size(); }
+
+    const QueueCounters& getCounters(int trafficClass) const { return counters[trafficClass]; }
+
+private:
+    static constexpr int kClasses = EgressConfig::kTrafficClasses;
+
+    std::array<EgressQueue, kClasses> queues;
+    std::array<QueueCounters, kClasses> counters;
+    std::array<uint32_t, kClasses> quantum;
+    std::array<uint32_t, kClasses> deficit;     // DRR byte allowance left this round
+    int strictClasses;
+    int drrCursor;          // DRR class currently being served
+    bool freshVisit;        // drrCursor has not yet received its quantum this round
+    uint32_t lineRate;
+    uint32_t credit;        // Bytes that may still be sent (line rate)
+    std::size_t backlog;
+
+    // Class whose head frame goes next, or -1 if all queues are empty.
+    // Grants DRR quanta as it moves but does not remove anything.
+    int selectClass();
+
+    // Removes the head of a class chosen by selectClass()
+    void commit(int trafficClass, uint32_t now);
+
+    void advanceDrr();
+};
+
+#endif // EGRESS_PORT_H
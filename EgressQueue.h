@@ -0,0 +1,92 @@
+#ifndef EGRESS_QUEUE_H
+#define EGRESS_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PacketPool.h"
+
+/**
+ * @brief What an egress queue holds for one frame: a pooled buffer, not a copy
+ */
+struct PacketDescriptor {
+    PacketPool::Handle buffer;  // Frame data in the switch's PacketPool
+    uint16_t length;            // Frame length in bytes
+    uint8_t trafficClass;       // Queue the frame was placed in (0-7)
+    uint32_t enqueueCycle;      // Simulation cycle it was queued in (for sojourn time)
+};
+
+/**
+ * @brief Counters kept for every egress queue
+ */
+struct QueueCounters {
+    uint64_t enqueued = 0;          // Frames accepted
+    uint64_t dropped = 0;           // Frames refused because the queue was full
+    uint64_t transmitted = 0;       // Frames sent
+    uint64_t bytesTransmitted = 0;
+    std::size_t maxDepth = 0;       // Deepest the queue has been, in frames
+    uint64_t sojournTotal = 0;      // Sum of cycles spent queued by sent frames
+    uint32_t sojournMax = 0;        // Longest time a sent frame was queued, in cycles
+
+    double meanSojourn() const {
+        return transmitted > 0 ? static_cast<double>(sojournTotal) / transmitted : 0.0;
+    }
+};
+
+/**
+ * @brief Bounded FIFO of packet descriptors (one traffic class of one port)
+ *
+ * A fixed ring sized once at construction. A push beyond the configured
+ * depth fails, which is the tail drop of a real output buffer.
+ */
+class EgressQueue {
+public:
+    /**
+     * @param depth Maximum frames held
+     */
+    explicit EgressQueue(std::size_t depth = 0) : limit(depth), head(0), count(0) {
+        std::size_t slots = 1;
+        while (slots < depth) {
+            slots <<= 1;
+        }
+        ring.resize(slots);
+    }
+
+    /**
+     * @return false if the queue already holds depth frames
+     */
+    bool push(const PacketDescriptor& descriptor) {
+        if (count >= limit) {
+            return false;
+        }
+        ring[(head + count) & (ring.size() - 1)] = descriptor;
+        count++;
+        return true;
+    }
+
+    /**
+     * @brief The oldest descriptor; the queue must not be empty
+     */
+    const PacketDescriptor& front() const { return ring[head]; }
+
+    /**
+     * @brief Removes the oldest descriptor; the queue must not be empty
+     */
+    void pop() {
+        head = (head + 1) & (ring.size() - 1);
+        count--;
+    }
+
+    std::size_t size() const { return count; }
+    std::size_t depth() const { return limit; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count >= limit; }
+
+private:
+    std::vector<PacketDescriptor> ring;     // Size is a power of two >= depth
+    std::size_t limit;
+    std::size_t head;                       // Index of the oldest descriptor
+    std::size_t count;
+};
+
+#endif // EGRESS_QUEUE_H
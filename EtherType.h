@@ -0,0 +1,77 @@
+#ifndef ETHER_TYPE_H
+#define ETHER_TYPE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Well-known EtherType values and their names
+ *
+ * Frames carry the EtherType as the 16-bit number from the wire; names are
+ * only produced for display and accepted for convenience when building
+ * frames by hand.
+ */
+struct EtherType {
+    static constexpr uint16_t kIPv4 = 0x0800;
+    static constexpr uint16_t kARP = 0x0806;
+    static constexpr uint16_t kVLAN = 0x8100;   // IEEE 802.1Q tag
+    static constexpr uint16_t kIPv6 = 0x86DD;
+    static constexpr uint16_t kLACP = 0x8809;   // Slow protocols
+    static constexpr uint16_t kQinQ = 0x88A8;   // IEEE 802.1ad service tag
+    static constexpr uint16_t kLLDP = 0x88CC;
+
+    /**
+     * @brief Short name of a well-known EtherType ("IPv4", "ARP", ...)
+     *
+     * @return The name, or nullptr if the value is not a well-known type
+     */
+    static const char* name(uint16_t type) {
+        switch (type) {
+            case kIPv4: return "IPv4";
+            case kARP:  return "ARP";
+            case kVLAN: return "VLAN";
+            case kIPv6: return "IPv6";
+            case kLACP: return "LACP";
+            case kQinQ: return "QinQ";
+            case kLLDP: return "LLDP";
+            default:    return nullptr;
+        }
+    }
+
+    /**
+     * @brief Parses a well-known name or a hex value such as "0x88B5"
+     *
+     * @return true if the text named an EtherType
+     */
+    static bool parse(std::string_view text, uint16_t& out) {
+        static constexpr uint16_t known[] = {kIPv4, kARP, kVLAN, kIPv6, kLACP, kQinQ, kLLDP};
+        for (uint16_t type : known) {
+            if (text == name(type)) {
+                out = type;
+                return true;
+            }
+        }
+        if (text.size() < 3 || text.size() > 6 || text[0] != '0' || (text[1] != 'x' && text[1] != 'X')) {
+            return false;
+        }
+        uint16_t value = 0;
+        for (char c : text.substr(2)) {
+            int digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                digit = c - 'A' + 10;
+            } else {
+                return false;
+            }
+            value = static_cast<uint16_t>((value << 4) | digit);
+        }
+        out = value;
+        return true;
+    }
+};
+
+#endif // ETHER_TYPE_H
@@ -0,0 +1,196 @@
+#ifndef EVICTION_INDEX_H
+#define EVICTION_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MacTable.h"
+
+/**
+ * @brief Picks the entry a full table gives up to learn a new station
+ *
+ * Like PortIndex, this is threaded through a table's slots: the caller
+ * reports every insertion, refresh, removal and slot-to-slot move, and asks
+ * for a victim slot when the table is full. Every operation is O(1)
+ * (CLOCK's sweep is amortized O(1)) and nothing is allocated after
+ * construction.
+ *
+ * - LRU keeps occupied slots on one doubly linked list in last-seen order;
+ *   a refresh moves the slot to the front and the victim is the back. Each
+ *   slot's links share one 8-byte record, so a refresh touches the slot and
+ *   its two neighbours.
+ * - CLOCK keeps a state byte per slot. A refresh only marks the slot as
+ *   referenced; the victim search sweeps the byte array from where it last
+ *   stopped, clearing marks until it meets an unmarked slot. A refresh is one
+ *   store and the sweep reads memory sequentially.
+ *
+ * With EvictionPolicy::NoLearn every call returns at once and no arrays are
+ * allocated.
+ */
+class EvictionIndex {
+public:
+    static constexpr uint32_t kNone = ~0u;
+
+    /**
+     * @param policy How victims are chosen
+     * @param slots Number of slots in the table being indexed
+     */
+    explicit EvictionIndex(EvictionPolicy policy = EvictionPolicy::NoLearn, std::size_t slots = 0)
+        : policy(policy), head(kNone), tail(kNone), hand(0) {
+        if (policy == EvictionPolicy::LRU) {
+            links.assign(slots, Link{kNone, kNone});
+        } else if (policy == EvictionPolicy::Clock) {
+            states.assign(slots, kEmpty);
+        }
+    }
+
+    EvictionPolicy getPolicy() const { return policy; }
+
+    /**
+     * @brief True if a full table should evict rather than refuse to learn
+     */
+    bool evicts() const { return policy != EvictionPolicy::NoLearn; }
+
+    /**
+     * @brief Adds a newly filled slot as the most recently seen
+     */
+    void insert(std::size_t slot) {
+        if (policy == EvictionPolicy::LRU) {
+            pushFront(static_cast<uint32_t>(slot));
+        } else if (policy == EvictionPolicy::Clock) {
+            states[slot] = kReferenced;
+        }
+    }
+
+    /**
+     * @brief Records that the entry in a slot was seen again
+     */
+    void touch(std::size_t slot) {
+        if (policy == EvictionPolicy::LRU) {
+            if (head != slot) {
+                unlink(static_cast<uint32_t>(slot));
+                pushFront(static_cast<uint32_t>(slot));
+            }
+        } else if (policy == EvictionPolicy::Clock) {
+            states[slot] = kReferenced;
+        }
+    }
+
+    /**
+     * @brief Forgets a slot whose entry was removed
+     */
+    void remove(std::size_t slot) {
+        if (policy == EvictionPolicy::LRU) {
+            unlink(static_cast<uint32_t>(slot));
+        } else if (policy == EvictionPolicy::Clock) {
+            states[slot] = kEmpty;
+        }
+    }
+
+    /**
+     * @brief Records that an entry moved from one slot to another, empty one
+     *
+     * The entry keeps its recency.
+     */
+    void relocate(std::size_t from, std::size_t to) {
+        if (policy == EvictionPolicy::LRU) {
+            const uint32_t target = static_cast<uint32_t>(to);
+            links[to] = links[from];
+            if (links[to].prev != kNone) {
+                links[links[to].prev].next = target;
+            } else {
+                head = target;
+            }
+            if (links[to].next != kNone) {
+                links[links[to].next].prev = target;
+            } else {
+                tail = target;
+            }
+        } else if (policy == EvictionPolicy::Clock) {
+            states[to] = states[from];
+            states[from] = kEmpty;
+        }
+    }
+
+    /**
+     * @brief The slot to evict, or kNone if no slot is occupied
+     *
+     * The slot stays indexed; the caller removes it with its entry.
+     */
+    uint32_t victim() {
+        if (policy == EvictionPolicy::LRU) {
+            return tail;
+        }
+        if (policy == EvictionPolicy::Clock && !states.empty()) {
+            // Two full turns clear every mark, so an occupied slot turns up by then
+            for (std::size_t step = 0; step < 2 * states.size(); step++) {
+                const std::size_t slot = hand;
+                hand = hand + 1 == states.size() ? 0 : hand + 1;
+                if (states[slot] == kReferenced) {
+                    states[slot] = kUnreferenced;
+                } else if (states[slot] == kUnreferenced) {
+                    return static_cast<uint32_t>(slot);
+                }
+            }
+        }
+        return kNone;
+    }
+
+    /**
+     * @brief Heap bytes held by the replacement order
+     */
+    std::size_t allocatedBytes() const {
+        return links.capacity() * sizeof(Link) + states.capacity() * sizeof(uint8_t);
+    }
+
+    /**
+     * @brief Forgets every slot
+     */
+    void clear() {
+        head = tail = kNone;
+        hand = 0;
+        std::fill(states.begin(), states.end(), kEmpty);
+    }
+
+private:
+    struct Link {
+        uint32_t prev;      // More recently seen slot
+        uint32_t next;      // Less recently seen slot
+    };
+
+    enum State : uint8_t { kEmpty, kUnreferenced, kReferenced };
+
+    EvictionPolicy policy;
+    std::vector<Link> links;        // LRU list links, per slot
+    std::vector<uint8_t> states;    // CLOCK state, per slot
+    uint32_t head;                  // Most recently seen slot (LRU)
+    uint32_t tail;                  // Least recently seen slot (LRU)
+    std::size_t hand;               // Next slot the CLOCK sweep looks at
+
+    void pushFront(uint32_t slot) {
+        links[slot] = Link{kNone, head};
+        if (head != kNone) {
+            links[head].prev = slot;
+        } else {
+            tail = slot;
+        }
+        head = slot;
+    }
+
+    void unlink(uint32_t slot) {
+        const Link link = links[slot];
+        if (link.prev != kNone) {
+            links[link.prev].next = link.next;
+        } else {
+            head = link.next;
+        }
+        if (link.next != kNone) {
+            links[link.next].prev = link.prev;
+        } else {
+            tail = link.prev;
+        }
+    }
+};
+
+#endif // EVICTION_INDEX_H
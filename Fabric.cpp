@@ -0,0 +1,884 @@
+#include "Fabric.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+// ANSI color codes for better output readability
+#define RESET   "\033[0m"
+#define CYAN    "\033[36m"
+
+namespace {
+
+constexpr uint64_t kNsPerSecond = 1000000000ULL;
+
+} // namespace
+
+/**
+ * @brief Reusable barrier for the partition threads of one run
+ *
+ * Waiting threads keep calling an idle function, so a partition stuck at
+ * the barrier still empties its mailboxes for senders that are waiting for
+ * room.
+ */
+class Fabric::WindowBarrier {
+public:
+    explicit WindowBarrier(int count) : count(count), arrived(0), generation(0) {}
+
+    template <typename Idle>
+    void wait(Idle&& idle) {
+        const uint32_t current = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.store(current + 1, std::memory_order_release);
+            return;
+        }
+        for (int spins = 0; generation.load(std::memory_order_acquire) == current; spins++) {
+            idle();
+            if (spins >= 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    const int count;
+    std::atomic<int> arrived;
+    std::atomic<uint32_t> generation;
+};
+
+Fabric::Fabric(const FabricConfig& config)
+    : switchTemplate(config.switchConfig), maxHops(config.maxHops),
+      partitionCount(config.partitions), useSpanningTree(config.spanningTree),
+      started(false), parallel(false),
+      lookahead(UINT64_MAX), currentTime(0), framesInjected(0), injectDrops(0) {
+    if (maxHops < 1 || maxHops > UINT8_MAX) {
+        throw std::invalid_argument("Fabric: maxHops must be between 1 and 255");
+    }
+    if (partitionCount < 1 || partitionCount > kMaxPartitions) {
+        throw std::invalid_argument("Fabric: partitions must be between 1 and " +
+                                    std::to_string(kMaxPartitions));
+    }
+    for (int p = 0; p < partitionCount; p++) {
+        partitions.push_back(std::make_unique<Partition>(config.frameBuffers, config.bufferSize));
+    }
+}
+
+void Fabric::checkNotStarted(const char* caller) const {
+    if (started) {
+        throw std::invalid_argument(std::string(caller) +
+                                    ": the topology is fixed once frames are injected");
+    }
+}
+
+int Fabric::addSwitch(int numPorts) {
+    SwitchConfig config = switchTemplate;
+    config.numPorts = numPorts;
+    return addSwitch(config);
+}
+
+int Fabric::addSwitch(const SwitchConfig& config) {
+    checkNotStarted("addSwitch");
+    SwitchConfig nodeConfig = config;
+    nodeConfig.observer = nullptr;
+    nodeConfig.agingClock = AgingClock::Logical;
+    nodeConfig.packetBuffers = 0;     // Links do the queuing
+
+    Node node;
+    node.sw = std::make_unique<Switch>(nodeConfig);
+    node.channelOf.assign(nodeConfig.numPorts, -1);
+    node.partition = 0;
+    node.bridgePriority = SpanningTree::kDefaultPriority;
+    nodes.push_back(std::move(node));
+    return static_cast<int>(nodes.size() - 1);
+}
+
+void Fabric::checkPort(int switchId, int port, const char* caller) const {
+    if (switchId < 0 || switchId >= getSwitchCount()) {
+        throw std::invalid_argument(std::string(caller) + ": no such switch " +
+                                    std::to_string(switchId));
+    }
+    if (port < 1 || port > static_cast<int>(nodes[switchId].channelOf.size())) {
+        throw std::invalid_argument(std::string(caller) + ": switch " + std::to_string(switchId) +
+                                    " has no port " + std::to_string(port));
+    }
+}
+
+bool Fabric::isEdgePort(int switchId, int port) const {
+    checkPort(switchId, port, "isEdgePort");
+    return nodes[switchId].channelOf[port - 1] < 0;
+}
+
+int Fabric::connect(int switchA, int portA, int switchB, int portB, const LinkConfig& link) {
+    checkNotStarted("connect");
+    checkPort(switchA, portA, "connect");
+    checkPort(switchB, portB, "connect");
+    if (switchA == switchB && portA == portB) {
+        throw std::invalid_argument("connect: a port cannot be linked to itself");
+    }
+    if (!isEdgePort(switchA, portA) || !isEdgePort(switchB, portB)) {
+        throw std::invalid_argument("connect: port is already linked");
+    }
+    if (!(link.bandwidthGbps > 0.0)) {
+        throw std::invalid_argument("connect: bandwidth must be positive");
+    }
+
+    const double nsPerByte = 8.0 / link.bandwidthGbps;
+    const uint64_t bufferNs = static_cast<uint64_t>(link.bufferBytes * nsPerByte);
+    const int linkId = getLinkCount();
+    channels.push_back(Channel{static_cast<uint32_t>(switchA), static_cast<uint16_t>(portA),
+                               static_cast<uint32_t>(switchB), static_cast<uint16_t>(portB),
+                               link.latencyNs, nsPerByte, bufferNs, 0, true, LinkStatistics()});
+    channels.push_back(Channel{static_cast<uint32_t>(switchB), static_cast<uint16_t>(portB),
+                               static_cast<uint32_t>(switchA), static_cast<uint16_t>(portA),
+                               link.latencyNs, nsPerByte, bufferNs, 0, true, LinkStatistics()});
+    nodes[switchA].channelOf[portA - 1] = 2 * linkId;
+    nodes[switchB].channelOf[portB - 1] = 2 * linkId + 1;
+    return linkId;
+}
+
+int Fabric::getPartitionOf(int switchId) const {
+    if (switchId < 0 || switchId >= getSwitchCount()) {
+        throw std::invalid_argument("getPartitionOf: no such switch " + std::to_string(switchId));
+    }
+    if (started) {
+        return static_cast<int>(nodes[switchId].partition);
+    }
+    // Contiguous blocks of IDs: builders number neighbouring switches together
+    return static_cast<int>(static_cast<int64_t>(switchId) * partitionCount / getSwitchCount());
+}
+
+uint64_t Fabric::getLookahead() const {
+    uint64_t smallest = UINT64_MAX;
+    for (const Channel& channel : channels) {
+        if (getPartitionOf(static_cast<int>(channel.fromNode)) !=
+            getPartitionOf(static_cast<int>(channel.toNode))) {
+            // Serialization takes at least 1 ns on top of the latency
+            smallest = std::min(smallest, channel.latencyNs + 1);
+        }
+    }
+    return smallest;
+}
+
+void Fabric::start() {
+    if (started) {
+        return;
+    }
+    for (int id = 0; id < getSwitchCount(); id++) {
+        nodes[id].partition = static_cast<uint32_t>(getPartitionOf(id));
+    }
+    lookahead = getLookahead();
+    mailboxes.resize(static_cast<std::size_t>(partitionCount) * partitionCount);
+    for (int from = 0; from < partitionCount; from++) {
+        for (int to = 0; to < partitionCount; to++) {
+            if (from != to) {
+                mailboxes[static_cast<std::size_t>(from) * partitionCount + to] =
+                    std::make_unique<Mailbox>(kMailboxSize);
+            }
+        }
+    }
+    started = true;
+
+    if (useSpanningTree) {
+        spanningTree = std::make_unique<SpanningTree>();
+        for (const Node& node : nodes) {
+            spanningTree->addBridge(node.bridgePriority);
+        }
+        for (int link = 0; link < getLinkCount(); link++) {
+            const Channel& channel = channels[2 * static_cast<std::size_t>(link)];
+            spanningTree->addLink(static_cast<int>(channel.fromNode), channel.fromPort,
+                                  static_cast<int>(channel.toNode), channel.toPort,
+                                  SpanningTree::pathCost(8.0 / channel.nsPerByte));
+            if (!channel.up) {
+                spanningTree->setLinkUp(link, false);
+            }
+        }
+        spanningTree->compute();
+        applyPortRoles(false);
+    }
+}
+
+void Fabric::applyPortRoles(bool flush) {
+    std::vector<PortMask> stale(nodes.size());
+    std::vector<char> changedRoots(nodes.size(), 0);
+    bool topologyChange = false;
+    for (const PortRoleChange& change : spanningTree->takeChanges()) {
+        const bool forwarding = isForwardingRole(change.current);
+        getSwitch(change.bridge).setPortState(
+            change.port, forwarding ? PortState::Forwarding : PortState::Discarding);
+        if (isForwardingRole(change.previous) && !forwarding) {
+            stale[change.bridge].set(change.port);
+        } else if (!isForwardingRole(change.previous) && forwarding) {
+            topologyChange = true;
+            changedRoots[spanningTree->getRootBridge(change.bridge)] = 1;
+        }
+    }
+    if (!flush) {
+        return;
+    }
+
+    // As with an RSTP topology change notice, every bridge of the tree
+    // forgets what it learned over links, but not its hosts
+    for (std::size_t id = 0; id < nodes.size(); id++) {
+        PortMask ports = stale[id];
+        if (topologyChange && changedRoots[spanningTree->getRootBridge(static_cast<int>(id))]) {
+            for (std::size_t port = 1; port <= nodes[id].channelOf.size(); port++) {
+                if (nodes[id].channelOf[port - 1] >= 0) {
+                    ports.set(static_cast<int>(port));
+                }
+            }
+        }
+        if (ports.any()) {
+            nodes[id].sw->flushPorts(ports);
+        }
+    }
+}
+
+void Fabric::setLinkUp(int linkId, bool up) {
+    if (linkId < 0 || linkId >= getLinkCount()) {
+        throw std::invalid_argument("setLinkUp: no such link " + std::to_string(linkId));
+    }
+    Channel& forward = channels[2 * static_cast<std::size_t>(linkId)];
+    Channel& reverse = channels[2 * static_cast<std::size_t>(linkId) + 1];
+    if (forward.up == up) {
+        return;
+    }
+    forward.up = up;
+    reverse.up = up;
+    if (!up) {
+        nodes[forward.fromNode].sw->flushPort(forward.fromPort);
+        nodes[reverse.fromNode].sw->flushPort(reverse.fromPort);
+    }
+    if (spanningTree) {
+        spanningTree->setLinkUp(linkId, up);
+        applyPortRoles(true);
+    }
+}
+
+void Fabric::setBridgePriority(int switchId, uint16_t priority) {
+    if (switchId < 0 || switchId >= getSwitchCount()) {
+        throw std::invalid_argument("setBridgePriority: no such switch " + std::to_string(switchId));
+    }
+    nodes[switchId].bridgePriority = priority;
+    if (spanningTree) {
+        spanningTree->setPriority(switchId, priority);
+        spanningTree->compute();
+        applyPortRoles(true);
+    }
+}
+
+bool Fabric::inject(uint64_t timeNs, int switchId, int port, const FrameView& frame) {
+    checkPort(switchId, port, "inject");
+    if (timeNs < currentTime) {
+        throw std::invalid_argument("inject: time " + std::to_string(timeNs) +
+                                    " is before the current time " + std::to_string(currentTime));
+    }
+    start();
+    Partition& part = *partitions[nodes[switchId].partition];
+    const PacketPool::Handle buffer = part.pool.allocate(frame, 1);
+    if (buffer == PacketPool::kInvalidHandle) {
+        injectDrops++;
+        return false;
+    }
+    schedule(part, timeNs, static_cast<uint32_t>(switchId), static_cast<uint16_t>(port), 0,
+             ++framesInjected, buffer);
+    return true;
+}
+
+bool Fabric::step() {
+    start();
+    Partition* next = nullptr;
+    for (const auto& part : partitions) {
+        if (!part->events.empty() &&
+            (next == nullptr || Later()(next->events.top(), part->events.top()))) {
+            next = part.get();
+        }
+    }
+    if (next == nullptr) {
+        return false;
+    }
+    const Event event = next->events.top();
+    next->events.pop();
+    next->currentTime = event.time;
+    currentTime = event.time;
+    handle(*next, event);
+    next->eventsProcessed++;
+    settle();
+    return true;
+}
+
+uint64_t Fabric::run(uint64_t untilNs) {
+    start();
+    uint64_t processed = 0;
+    if (partitionCount > 1) {
+        processed = runParallel(untilNs);
+        for (const auto& part : partitions) {
+            currentTime = std::max(currentTime, part->currentTime);
+        }
+    } else {
+        Partition& part = *partitions[0];
+        while (!part.events.empty() && part.events.top().time <= untilNs) {
+            const Event event = part.events.top();
+            part.events.pop();
+            part.currentTime = event.time;
+            handle(part, event);
+            part.eventsProcessed++;
+            processed++;
+        }
+        currentTime = std::max(currentTime, part.currentTime);
+    }
+    if (untilNs != UINT64_MAX && untilNs > currentTime) {
+        currentTime = untilNs;
+    }
+    return processed;
+}
+
+void Fabric::handle(Partition& part, const Event& event) {
+    Node& node = nodes[event.node];
+    Switch& sw = *node.sw;
+    const uint64_t now = part.currentTime;
+
+    // Frames in flight when their link went down are lost
+    const int32_t inbound = node.channelOf[event.port - 1];
+    if (inbound >= 0 && !channels[inbound].up) {
+        part.linkDownDrops++;
+        part.pool.release(event.buffer);
+        return;
+    }
+
+    // Whole simulated seconds are the switch's aging clock
+    const uint32_t second = static_cast<uint32_t>(now / kNsPerSecond);
+    if (second != sw.getCurrentCycle()) {
+        sw.advanceCycles(second - sw.getCurrentCycle());
+    }
+
+    // A burst of one, so the switch also runs its bounded aging step
+    const FrameView frame = part.pool.view(event.buffer);
+    const int port = event.port;
+    ForwardDecision decision;
+    sw.processBurst(&frame, &port, 1, &decision);
+
+    const bool mayForward = event.hops + 1 < maxHops;
+    const uint64_t wireBytes = frame.wireLength() + kWireOverhead;
+    uint32_t references = 0;
+    decision.egressPorts.forEach([&](int out) {
+        const int32_t channelId = node.channelOf[out - 1];
+        if (channelId < 0) {
+            part.framesDelivered++;
+            if (deliveryHandler && parallel) {
+                part.deliveries.push_back(Delivery{event, static_cast<uint16_t>(out)});
+                references++;
+            } else if (deliveryHandler) {
+                deliveryHandler(static_cast<int>(event.node), out, frame, now);
+            }
+            return;
+        }
+        if (!mayForward) {
+            part.hopLimitDrops++;
+            return;
+        }
+
+        // The link sends one frame at a time; a busy link delays this one
+        Channel& channel = channels[channelId];
+        if (!channel.up) {
+            part.linkDownDrops++;
+            return;
+        }
+        const uint64_t start = std::max(now, channel.busyUntil);
+        if (channel.bufferNs > 0 && start - now > channel.bufferNs) {
+            channel.stats.drops++;
+            return;
+        }
+        const uint64_t serialization =
+            std::max<uint64_t>(1, static_cast<uint64_t>(wireBytes * channel.nsPerByte + 0.5));
+        channel.busyUntil = start + serialization;
+        channel.stats.frames++;
+        channel.stats.bytes += wireBytes;
+        channel.stats.busyNs += serialization;
+
+        const uint64_t arrival = channel.busyUntil + channel.latencyNs;
+        const uint8_t hops = static_cast<uint8_t>(event.hops + 1);
+        const uint32_t target = nodes[channel.toNode].partition;
+        if (target == node.partition) {
+            schedule(part, arrival, channel.toNode, channel.toPort, hops, 0, event.buffer);
+        } else {
+            send(node.partition, target,
+                 Transfer{arrival, channel.toNode, channel.toPort, hops, event.buffer});
+        }
+        references++;
+    });
+
+    // Each copy in flight holds the buffer; this arrival is done with it
+    if (references > 0) {
+        part.pool.retain(event.buffer, references);
+    }
+    part.pool.release(event.buffer);
+}
+
+void Fabric::send(uint32_t from, uint32_t to, const Transfer& transfer) {
+    Mailbox& box = mailbox(from, to);
+    if (box.backlog.empty() && box.ring.tryPush(transfer)) {
+        box.unreleased.push_back(transfer.buffer);
+    } else {
+        box.backlog.push_back(transfer);
+    }
+}
+
+bool Fabric::flushBacklog(uint32_t from) {
+    bool flushed = true;
+    for (int to = 0; to < partitionCount; to++) {
+        if (static_cast<uint32_t>(to) == from) {
+            continue;
+        }
+        Mailbox& box = mailbox(from, static_cast<uint32_t>(to));
+        if (box.backlog.empty()) {
+            continue;
+        }
+        const std::size_t pushed = box.ring.pushBulk(box.backlog.data(), box.backlog.size());
+        for (std::size_t i = 0; i < pushed; i++) {
+            box.unreleased.push_back(box.backlog[i].buffer);
+        }
+        box.backlog.erase(box.backlog.begin(), box.backlog.begin() + pushed);
+        flushed = flushed && box.backlog.empty();
+    }
+    return flushed;
+}
+
+void Fabric::drainInbox(uint32_t to) {
+    constexpr std::size_t kBatch = 64;
+    Partition& part = *partitions[to];
+    Transfer batch[kBatch];
+    for (int from = 0; from < partitionCount; from++) {
+        if (static_cast<uint32_t>(from) == to) {
+            continue;
+        }
+        Mailbox& box = mailbox(static_cast<uint32_t>(from), to);
+        const PacketPool& sender = partitions[from]->pool;
+        std::size_t count;
+        while ((count = box.ring.popBulk(batch, kBatch)) > 0) {
+            for (std::size_t i = 0; i < count; i++) {
+                const Transfer& transfer = batch[i];
+                const PacketPool::Handle buffer = part.pool.allocate(sender.view(transfer.buffer), 1);
+                if (buffer == PacketPool::kInvalidHandle) {
+                    part.transferDrops++;
+                    continue;
+                }
+                schedule(part, transfer.time, transfer.node, transfer.port, transfer.hops, 0, buffer);
+            }
+            // Publishes that the sender's buffers have been read
+            box.copied.store(box.copied.load(std::memory_order_relaxed) + count,
+                             std::memory_order_release);
+        }
+    }
+}
+
+void Fabric::releaseCopied(uint32_t from) {
+    PacketPool& pool = partitions[from]->pool;
+    for (int to = 0; to < partitionCount; to++) {
+        if (static_cast<uint32_t>(to) == from) {
+            continue;
+        }
+        Mailbox& box = mailbox(from, static_cast<uint32_t>(to));
+        const uint64_t copied = box.copied.load(std::memory_order_acquire);
+        for (; box.released < copied; box.released++) {
+            pool.release(box.unreleased.front());
+            box.unreleased.pop_front();
+        }
+    }
+}
+
+void Fabric::settle() {
+    // Single-threaded: hand every transfer to its partition
+    if (partitionCount == 1) {
+        return;
+    }
+    bool flushed;
+    do {
+        flushed = true;
+        for (int p = 0; p < partitionCount; p++) {
+            flushed = flushBacklog(static_cast<uint32_t>(p)) && flushed;
+        }
+        for (int p = 0; p < partitionCount; p++) {
+            drainInbox(static_cast<uint32_t>(p));
+        }
+    } while (!flushed);
+    for (int p = 0; p < partitionCount; p++) {
+        releaseCopied(static_cast<uint32_t>(p));
+    }
+}
+
+void Fabric::dispatchDeliveries() {
+    // Replays edge deliveries in the order a sequential run would make them
+    std::vector<std::pair<const Delivery*, const PacketPool*>> order;
+    for (const auto& part : partitions) {
+        for (const Delivery& delivery : part->deliveries) {
+            order.emplace_back(&delivery, &part->pool);
+        }
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        if (Later()(b.first->event, a.first->event)) {
+            return true;
+        }
+        if (Later()(a.first->event, b.first->event)) {
+            return false;
+        }
+        return a.first->port < b.first->port;
+    });
+    for (const auto& entry : order) {
+        const Delivery& delivery = *entry.first;
+        deliveryHandler(static_cast<int>(delivery.event.node), delivery.port,
+                        entry.second->view(delivery.event.buffer), delivery.event.time);
+    }
+}
+
+uint64_t Fabric::runParallel(uint64_t untilNs) {
+    WindowBarrier barrier(partitionCount);
+    std::vector<uint64_t> processed(partitionCount, 0);
+    parallel = true;
+    std::vector<std::thread> workers;
+    for (int p = 1; p < partitionCount; p++) {
+        workers.emplace_back([this, p, untilNs, &barrier, &processed] {
+            processed[p] = runPartition(static_cast<uint32_t>(p), untilNs, barrier);
+        });
+    }
+    processed[0] = runPartition(0, untilNs, barrier);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    parallel = false;
+
+    // Every transfer was copied before the last barrier
+    uint64_t total = 0;
+    for (int p = 0; p < partitionCount; p++) {
+        releaseCopied(static_cast<uint32_t>(p));
+        total += processed[p];
+    }
+    return total;
+}
+
+uint64_t Fabric::runPartition(uint32_t index, uint64_t untilNs, WindowBarrier& barrier) {
+    Partition& part = *partitions[index];
+    auto idle = [this, index] { drainInbox(index); };
+    const uint64_t windowLimit = untilNs == UINT64_MAX ? UINT64_MAX : untilNs + 1;
+    uint64_t processed = 0;
+
+    part.nextTime = part.events.empty() ? UINT64_MAX : part.events.top().time;
+    barrier.wait(idle);
+    for (;;) {
+        uint64_t earliest = UINT64_MAX;
+        for (const auto& other : partitions) {
+            earliest = std::min(earliest, other->nextTime);
+        }
+        for (const Delivery& delivery : part.deliveries) {
+            part.pool.release(delivery.event.buffer);
+        }
+        part.deliveries.clear();
+        if (earliest == UINT64_MAX || earliest > untilNs) {
+            break;
+        }
+
+        // Nothing another partition sends can arrive before windowEnd
+        const uint64_t windowEnd =
+            std::min(earliest > UINT64_MAX - lookahead ? UINT64_MAX : earliest + lookahead,
+                     windowLimit);
+        while (!part.events.empty() && part.events.top().time < windowEnd) {
+            const Event event = part.events.top();
+            part.events.pop();
+            part.currentTime = event.time;
+            handle(part, event);
+            part.eventsProcessed++;
+            processed++;
+        }
+        while (!flushBacklog(index)) {
+            drainInbox(index);
+            std::this_thread::yield();
+        }
+        barrier.wait(idle);
+
+        // No one sends until the next window, so this empties the inbox
+        drainInbox(index);
+        releaseCopied(index);
+        if (index == 0 && deliveryHandler) {
+            dispatchDeliveries();
+        }
+        part.nextTime = part.events.empty() ? UINT64_MAX : part.events.top().time;
+        barrier.wait(idle);
+    }
+    return processed;
+}
+
+std::size_t Fabric::pendingEvents() const {
+    std::size_t pending = 0;
+    for (const auto& part : partitions) {
+        pending += part->events.size();
+    }
+    return pending;
+}
+
+uint64_t Fabric::getEventsProcessed() const {
+    uint64_t total = 0;
+    for (const auto& part : partitions) {
+        total += part->eventsProcessed;
+    }
+    return total;
+}
+
+uint64_t Fabric::getFramesDelivered() const {
+    uint64_t total = 0;
+    for (const auto& part : partitions) {
+        total += part->framesDelivered;
+    }
+    return total;
+}
+
+uint64_t Fabric::getHopLimitDrops() const {
+    uint64_t total = 0;
+    for (const auto& part : partitions) {
+        total += part->hopLimitDrops;
+    }
+    return total;
+}
+
+uint64_t Fabric::getLinkDownDrops() const {
+    uint64_t total = 0;
+    for (const auto& part : partitions) {
+        total += part->linkDownDrops;
+    }
+    return total;
+}
+
+uint64_t Fabric::getTransferDrops() const {
+    uint64_t total = 0;
+    for (const auto& part : partitions) {
+        total += part->transferDrops;
+    }
+    return total;
+}
+
+uint64_t Fabric::getLinkDrops() const {
+    uint64_t drops = 0;
+    for (const Channel& channel : channels) {
+        drops += channel.stats.drops;
+    }
+    return drops;
+}
+
+void Fabric::printStatistics() const {
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              Fabric Statistics                 ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    std::cout << "Switches:                " << nodes.size() << "\n";
+    std::cout << "Links:                   " << getLinkCount() << "\n";
+    std::cout << "Simulated Time:          " << std::fixed << std::setprecision(3)
+              << currentTime / 1e6 << " ms\n";
+    if (partitionCount > 1) {
+        std::cout << "Partitions:              " << partitionCount;
+        if (lookahead != UINT64_MAX) {
+            std::cout << " (lookahead " << lookahead << " ns)";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "Events Processed:        " << getEventsProcessed() << "\n";
+    std::cout << "Frames Injected:         " << framesInjected << "\n";
+    std::cout << "Frames Delivered:        " << getFramesDelivered() << "\n";
+    std::cout << "Hop Limit Drops:         " << getHopLimitDrops() << "\n";
+    std::cout << "Link Buffer Drops:       " << getLinkDrops() << "\n";
+    std::cout << "Link Down Drops:         " << getLinkDownDrops() << "\n";
+    std::cout << "Injection Drops:         " << injectDrops << "\n";
+    if (partitionCount > 1) {
+        std::cout << "Cross-Partition Drops:   " << getTransferDrops() << "\n";
+    }
+    if (spanningTree) {
+        int discarding = 0;
+        for (int link = 0; link < spanningTree->getLinkCount(); link++) {
+            for (bool sideB : {false, true}) {
+                if (!isForwardingRole(spanningTree->getRole(link, sideB))) {
+                    discarding++;
+                }
+            }
+        }
+        std::cout << "Spanning Tree:           root S" << spanningTree->getRootBridge(0) << ", "
+                  << discarding << " discarding ports, " << spanningTree->getTopologyChanges()
+                  << " topology changes\n";
+    }
+    std::size_t peakBuffers = 0;
+    std::size_t capacity = 0;
+    for (const auto& part : partitions) {
+        peakBuffers += part->pool.getPeakInUse();
+        capacity += part->pool.getCapacity();
+    }
+    std::cout << "Frames In Flight:        " << pendingEvents() << " (peak buffers "
+              << peakBuffers << "/" << capacity << ")\n";
+
+    double busiest = 0.0;
+    double total = 0.0;
+    for (const Channel& channel : channels) {
+        const double utilization = channel.stats.utilization(currentTime);
+        busiest = std::max(busiest, utilization);
+        total += utilization;
+    }
+    if (!channels.empty()) {
+        std::cout << "Link Utilization:        " << std::setprecision(1)
+                  << 100.0 * total / channels.size() << "% mean, "
+                  << 100.0 * busiest << "% busiest\n";
+    }
+    std::cout << "\n";
+}
+
+void Fabric::printLinkStatistics(std::size_t limit) const {
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              Link Utilization                  ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+
+    std::vector<std::size_t> order(channels.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        return channels[a].stats.busyNs > channels[b].stats.busyNs;
+    });
+    if (limit > 0 && limit < order.size()) {
+        order.resize(limit);
+    }
+
+    std::cout << std::left << std::setw(7) << "Link" << std::setw(24) << "Direction"
+              << std::right << std::setw(12) << "Frames" << std::setw(14) << "Bytes"
+              << std::setw(8) << "Drops" << std::setw(9) << "Util" << "\n";
+    std::cout << std::string(74, '-') << "\n";
+    for (std::size_t id : order) {
+        const Channel& channel = channels[id];
+        const std::string direction = "S" + std::to_string(channel.fromNode) + ":P" +
+                                      std::to_string(channel.fromPort) + " -> S" +
+                                      std::to_string(channel.toNode) + ":P" +
+                                      std::to_string(channel.toPort);
+        std::cout << std::left << std::setw(7) << id / 2 << std::setw(24) << direction
+                  << std::right << std::setw(12) << channel.stats.frames
+                  << std::setw(14) << channel.stats.bytes << std::setw(8) << channel.stats.drops
+                  << std::setw(8) << std::fixed << std::setprecision(1)
+                  << 100.0 * channel.stats.utilization(currentTime) << "%\n";
+    }
+    std::cout << "\n";
+}
+
+void Fabric::printSpanningTree() const {
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              Spanning Tree                     ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    if (!spanningTree) {
+        std::cout << "Spanning tree not running\n\n";
+        return;
+    }
+
+    // Discarding ports per switch, from the links' point of view
+    std::vector<std::string> discarding(nodes.size());
+    for (int link = 0; link < spanningTree->getLinkCount(); link++) {
+        const Channel& channel = channels[2 * static_cast<std::size_t>(link)];
+        for (bool sideB : {false, true}) {
+            const PortRole role = spanningTree->getRole(link, sideB);
+            if (isForwardingRole(role)) {
+                continue;
+            }
+            const uint32_t node = sideB ? channel.toNode : channel.fromNode;
+            const int port = sideB ? channel.toPort : channel.fromPort;
+            discarding[node] += (discarding[node].empty() ? "" : " ") + std::to_string(port) +
+                                (role == PortRole::Disabled ? "(down)" :
+                                 role == PortRole::Backup ? "(backup)" : "");
+        }
+    }
+
+    std::cout << std::left << std::setw(8) << "Switch" << std::setw(8) << "Root"
+              << std::setw(11) << "Root Port" << std::setw(11) << "Root Cost"
+              << "Discarding Ports" << "\n";
+    std::cout << std::string(58, '-') << "\n";
+    for (std::size_t id = 0; id < nodes.size(); id++) {
+        const int bridge = static_cast<int>(id);
+        const int rootPort = spanningTree->getRootPort(bridge);
+        std::cout << std::left << std::setw(8) << ("S" + std::to_string(id))
+                  << std::setw(8) << ("S" + std::to_string(spanningTree->getRootBridge(bridge)))
+                  << std::setw(11) << (rootPort == 0 ? "-" : std::to_string(rootPort))
+                  << std::setw(11) << spanningTree->getRootPathCost(bridge)
+                  << (discarding[id].empty() ? "-" : discarding[id]) << "\n";
+    }
+    std::cout << "\n";
+}
+
+std::vector<EdgePort> buildTree(Fabric& fabric, int switches, int fanout, int hostPorts,
+                                const LinkConfig& link) {
+    if (switches < 1 || fanout < 1 || hostPorts < 0) {
+        throw std::invalid_argument("buildTree: need at least one switch and a fanout of 1");
+    }
+    const int ports = 1 + fanout + hostPorts;
+    if (ports > PortMask::kMaxPorts) {
+        throw std::invalid_argument("buildTree: fanout plus host ports exceeds " +
+                                    std::to_string(PortMask::kMaxPorts - 1));
+    }
+
+    const int base = fabric.getSwitchCount();
+    for (int k = 0; k < switches; k++) {
+        fabric.addSwitch(ports);
+    }
+    for (int k = 1; k < switches; k++) {
+        const int parent = (k - 1) / fanout;
+        const int slot = (k - 1) % fanout;
+        fabric.connect(base + parent, 2 + slot, base + k, 1, link);
+    }
+
+    // Take the root's uplink and the child ports nothing hangs off out of
+    // the default VLAN, so floods do not leave the fabric through them
+    for (int k = 0; k < switches; k++) {
+        Switch& sw = fabric.getSwitch(base + k);
+        PortMask members = sw.getVlanMembers(FdbKey::kDefaultVlan);
+        if (k == 0) {
+            members.reset(1);
+        }
+        for (int slot = 0; slot < fanout; slot++) {
+            if (k * fanout + slot + 1 >= switches) {
+                members.reset(2 + slot);
+            }
+        }
+        sw.setVlanMembers(FdbKey::kDefaultVlan, members);
+    }
+
+    std::vector<EdgePort> edges;
+    edges.reserve(static_cast<std::size_t>(switches) * hostPorts);
+    for (int k = 0; k < switches; k++) {
+        for (int h = 0; h < hostPorts; h++) {
+            edges.push_back(EdgePort{base + k, fanout + 2 + h});
+        }
+    }
+    return edges;
+}
+
+std::vector<EdgePort> buildLeafSpine(Fabric& fabric, int spines, int leaves, int hostPorts,
+                                     const LinkConfig& link) {
+    if (spines < 1 || leaves < 1 || hostPorts < 0) {
+        throw std::invalid_argument("buildLeafSpine: need at least one spine and one leaf");
+    }
+    if (leaves > PortMask::kMaxPorts || spines + hostPorts > PortMask::kMaxPorts) {
+        throw std::invalid_argument("buildLeafSpine: too many ports per switch");
+    }
+
+    const int base = fabric.getSwitchCount();
+    for (int s = 0; s < spines; s++) {
+        fabric.addSwitch(leaves);
+    }
+    const int firstLeaf = base + spines;
+    for (int l = 0; l < leaves; l++) {
+        fabric.addSwitch(spines + hostPorts);
+        for (int s = 0; s < spines; s++) {
+            fabric.connect(base + s, l + 1, firstLeaf + l, s + 1, link);
+        }
+    }
+
+    std::vector<EdgePort> edges;
+    edges.reserve(static_cast<std::size_t>(leaves) * hostPorts);
+    for (int l = 0; l < leaves; l++) {
+        for (int h = 0; h < hostPorts; h++) {
+            edges.push_back(EdgePort{firstLeaf + l, spines + 1 + h});
+        }
+    }
+    return edges;
+}
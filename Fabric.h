@@ -0,0 +1,460 @@
+#ifndef FABRIC_H
+#define FABRIC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "FrameView.h"
+#include "PacketPool.h"
+#include "SpanningTree.h"
+#include "SpscRing.h"
+#include "Switch.h"
+
+/**
+ * @brief Properties of one point-to-point link between two switch ports
+ */
+struct LinkConfig {
+    uint64_t latencyNs = 1000;      // Propagation delay, each direction
+    double bandwidthGbps = 10.0;    // Line rate, each direction
+    uint64_t bufferBytes = 0;       // Output backlog beyond which frames are dropped (0 = unbounded)
+};
+
+/**
+ * @brief Counters for one direction of a link
+ */
+struct LinkStatistics {
+    uint64_t frames = 0;        // Frames sent
+    uint64_t bytes = 0;         // Bytes sent, framing overhead included
+    uint64_t busyNs = 0;        // Time spent serializing frames
+    uint64_t drops = 0;         // Frames refused because the backlog was full
+
+    /**
+     * @brief Fraction of an interval the link was transmitting
+     */
+    double utilization(uint64_t elapsedNs) const {
+        return elapsedNs > 0 ? static_cast<double>(busyNs) / elapsedNs : 0.0;
+    }
+};
+
+/**
+ * @brief Construction-time settings for a Fabric
+ */
+struct FabricConfig {
+    SwitchConfig switchConfig;              // Template for addSwitch(ports)
+    std::size_t frameBuffers = 8192;        // Frames each partition can hold at once
+    std::size_t bufferSize = PacketPool::kDefaultBufferSize;
+    int maxHops = 32;                       // Switches a frame may cross (bounds loops)
+    int partitions = 1;                     // Threads the switches are split across (1 = sequential)
+    bool spanningTree = false;              // Run RSTP port roles on the links
+};
+
+/**
+ * @brief Network of switches joined by links, run by a discrete-event scheduler
+ *
+ * The only event is a frame arriving on a switch port. Handling it runs the
+ * switch's normal learning and forwarding, then computes when each copy
+ * reaches the far end of its link: a link serializes one frame at a time at
+ * its bandwidth, then adds its latency. Those arrivals go into a priority
+ * queue ordered by time, so idle links and switches cost nothing and the
+ * simulation jumps straight from one arrival to the next.
+ *
+ * Ports without a link are edge ports. Frames forwarded to them are
+ * delivered: counted and passed to the delivery handler.
+ *
+ * Frame bytes live in one PacketPool for the whole fabric. A flood of N
+ * copies shares one buffer, and each pending arrival holds a reference, so
+ * a frame crossing many switches is copied only when injected.
+ *
+ * Switches run on their logical clock in whole seconds of simulated time,
+ * so agingTimeout is in simulated seconds. A frame that has crossed
+ * maxHops switches is dropped instead of forwarded again, which keeps a
+ * flooding loop finite when the topology has one.
+ *
+ * With FabricConfig::spanningTree the links run a SpanningTree, starting
+ * from the topology fixed at the first injection. Root and designated ports
+ * forward; alternate and backup ports discard, which breaks every loop.
+ * Link failures and recoveries (setLinkUp()) reconverge incrementally, the
+ * way RSTP does on point-to-point links, without waiting for timers. Switches
+ * flush only the ports that stopped forwarding, and, when a port starts
+ * forwarding (a topology change), the linked ports of every switch in that
+ * tree; addresses learned on host ports survive.
+ *
+ * With more than one partition, run() splits the switches into contiguous
+ * blocks of IDs and runs each block on its own thread (conservative
+ * parallel simulation in YAWNS windows). A frame sent over a link takes at
+ * least latency + 1 ns to arrive, so the smallest such delay among links
+ * between partitions is a lookahead: once every partition knows the
+ * earliest pending event T, all of them can process events before
+ * T + lookahead without hearing from each other. Frames for another
+ * partition go through a lock-free mailbox and are picked up at the window
+ * barrier. Events are ordered by (time, switch, port, injection number),
+ * which does not depend on the partitioning, so every switch sees the same
+ * frames in the same order and counters, tables and deliveries come out
+ * identical to a sequential run (unless a pool runs out of buffers). The
+ * delivery handler is then called on the thread calling run(), in
+ * sequential order, at the end of each window.
+ *
+ * The topology is fixed once the first frame is injected.
+ */
+class Fabric {
+public:
+    // Preamble (8), FCS (4) and inter-frame gap (12) added to each frame on a link
+    static constexpr uint64_t kWireOverhead = 24;
+
+    // Upper bound on FabricConfig::partitions
+    static constexpr int kMaxPartitions = 64;
+
+    /**
+     * @brief Called for each frame leaving the fabric on an edge port
+     */
+    using DeliveryHandler = std::function<void(int switchId, int port, const FrameView& frame,
+                                               uint64_t timeNs)>;
+
+    /**
+     * @throws std::invalid_argument if frameBuffers, bufferSize, maxHops or
+     *         partitions is out of range
+     */
+    explicit Fabric(const FabricConfig& config = FabricConfig());
+
+    Fabric(const Fabric&) = delete;
+    Fabric& operator=(const Fabric&) = delete;
+
+    /**
+     * @brief Adds a switch built from the template configuration
+     *
+     * @return The new switch's ID (0, 1, 2, ...)
+     * @throws std::invalid_argument once frames have been injected
+     */
+    int addSwitch(int numPorts);
+
+    /**
+     * @brief Adds a switch with its own configuration
+     *
+     * The observer is ignored and the aging clock forced to logical.
+     */
+    int addSwitch(const SwitchConfig& config);
+
+    /**
+     * @brief Joins two ports with a full-duplex link
+     *
+     * @return The link's ID (0, 1, 2, ...)
+     * @throws std::invalid_argument if a switch or port does not exist, a port
+     *         is already linked, the link parameters are out of range, or
+     *         frames have already been injected
+     */
+    int connect(int switchA, int portA, int switchB, int portB, const LinkConfig& link = LinkConfig());
+
+    /**
+     * @brief Schedules a frame to arrive on a switch port
+     *
+     * The frame is copied into the pool of the switch's partition.
+     *
+     * @param timeNs Arrival time; must not be earlier than now()
+     * @return false if the pool was full or the frame too large
+     * @throws std::invalid_argument if the switch or port does not exist or
+     *         the time is in the past
+     */
+    bool inject(uint64_t timeNs, int switchId, int port, const FrameView& frame);
+
+    /**
+     * @brief Takes a link down or brings it back up
+     *
+     * Frames on a down link, and those still in flight on it, are lost;
+     * both of its ports are flushed. With a spanning tree the port roles
+     * are updated too. Call it between runs, not from a delivery handler.
+     *
+     * @throws std::invalid_argument if the link does not exist
+     */
+    void setLinkUp(int linkId, bool up);
+
+    bool isLinkUp(int linkId) const { return channels.at(2 * static_cast<std::size_t>(linkId)).up; }
+
+    /**
+     * @brief Sets a switch's bridge priority (lower wins root election)
+     *
+     * Once the tree is running this recomputes it.
+     *
+     * @throws std::invalid_argument if the switch does not exist
+     */
+    void setBridgePriority(int switchId, uint16_t priority);
+
+    /**
+     * @brief The spanning tree, or nullptr when disabled or before the first injection
+     */
+    const SpanningTree* getSpanningTree() const { return spanningTree.get(); }
+
+    /**
+     * @brief Processes events in time order up to and including a time
+     *
+     * @return Number of events processed
+     */
+    uint64_t run(uint64_t untilNs = UINT64_MAX);
+
+    /**
+     * @brief Processes at most one event, on the calling thread
+     *
+     * @return false if no event was pending
+     */
+    bool step();
+
+    void setDeliveryHandler(DeliveryHandler handler) { deliveryHandler = std::move(handler); }
+
+    Switch& getSwitch(int switchId) { return *nodes.at(switchId).sw; }
+    const Switch& getSwitch(int switchId) const { return *nodes.at(switchId).sw; }
+
+    int getSwitchCount() const { return static_cast<int>(nodes.size()); }
+    int getLinkCount() const { return static_cast<int>(channels.size() / 2); }
+    int getPartitionCount() const { return partitionCount; }
+
+    /**
+     * @brief Partition that runs a switch
+     */
+    int getPartitionOf(int switchId) const;
+
+    /**
+     * @brief Window length of parallel runs: the smallest delay of a link
+     *        between partitions (UINT64_MAX if there is none)
+     */
+    uint64_t getLookahead() const;
+
+    /**
+     * @brief True if the port has no link (frames sent there leave the fabric)
+     */
+    bool isEdgePort(int switchId, int port) const;
+
+    /**
+     * @brief Counters of one direction of a link
+     *
+     * @param reverse false for A to B as passed to connect(), true for B to A
+     */
+    const LinkStatistics& getLinkStatistics(int linkId, bool reverse = false) const {
+        return channels.at(2 * static_cast<std::size_t>(linkId) + (reverse ? 1 : 0)).stats;
+    }
+
+    // Simulated time of the last event processed
+    uint64_t now() const { return currentTime; }
+
+    std::size_t pendingEvents() const;
+    uint64_t getEventsProcessed() const;
+    uint64_t getFramesInjected() const { return framesInjected; }
+    uint64_t getFramesDelivered() const;
+    uint64_t getHopLimitDrops() const;
+    uint64_t getLinkDrops() const;
+
+    // Frames refused at injection because the pool had no room
+    uint64_t getInjectDrops() const { return injectDrops; }
+
+    // Frames lost crossing to a partition whose pool had no room
+    uint64_t getTransferDrops() const;
+
+    // Frames sent onto, or in flight on, a link that was down
+    uint64_t getLinkDownDrops() const;
+
+    /**
+     * @brief Displays fabric-wide totals
+     */
+    void printStatistics() const;
+
+    /**
+     * @brief Displays frames, bytes and utilization of every link direction
+     *
+     * @param limit Print only the busiest this many directions (0 = all)
+     */
+    void printLinkStatistics(std::size_t limit = 0) const;
+
+    /**
+     * @brief Displays each switch's root port and cost and its discarding ports
+     */
+    void printSpanningTree() const;
+
+private:
+    // Mailbox slots per ordered pair of partitions
+    static constexpr std::size_t kMailboxSize = 1024;
+
+    struct Event {
+        uint64_t time;
+        uint32_t node;
+        uint16_t port;
+        uint8_t hops;               // Switches crossed so far
+        uint64_t order;             // Injection number, or 0 for a link arrival
+        PacketPool::Handle buffer;
+    };
+
+    // A link delivers at most one frame per nanosecond to a port, so
+    // (time, node, port, order) is unique and the same in every partitioning
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            if (a.time != b.time) {
+                return a.time > b.time;
+            }
+            if (a.node != b.node) {
+                return a.node > b.node;
+            }
+            if (a.port != b.port) {
+                return a.port > b.port;
+            }
+            return a.order > b.order;
+        }
+    };
+
+    // One direction of a link
+    struct Channel {
+        uint32_t fromNode;
+        uint16_t fromPort;
+        uint32_t toNode;
+        uint16_t toPort;
+        uint64_t latencyNs;
+        double nsPerByte;
+        uint64_t bufferNs;          // Backlog allowed, as transmit time (0 = unbounded)
+        uint64_t busyUntil;         // When the frame being sent finishes
+        bool up;
+        LinkStatistics stats;
+    };
+
+    struct Node {
+        std::unique_ptr<Switch> sw;
+        std::vector<int32_t> channelOf;     // Outgoing channel per port - 1, or -1 at the edge
+        uint32_t partition;
+        uint16_t bridgePriority;
+    };
+
+    // Frame arriving in another partition; the buffer is in the sender's pool
+    struct Transfer {
+        uint64_t time;
+        uint32_t node;
+        uint16_t port;
+        uint8_t hops;
+        PacketPool::Handle buffer;
+    };
+
+    // Frame left at an edge port during a parallel window, with the key of
+    // the event that sent it so deliveries can be replayed in sequential order
+    struct Delivery {
+        Event event;
+        uint16_t port;
+    };
+
+    // Frames sent from one partition to another. The receiver copies each
+    // frame into its own pool and counts it in copied; the sender then
+    // releases its buffer
+    struct Mailbox {
+        explicit Mailbox(std::size_t capacity) : ring(capacity) {}
+
+        SpscRing<Transfer> ring;
+        alignas(64) std::atomic<uint64_t> copied{0};   // Receiver-owned
+        std::vector<Transfer> backlog;                  // Sender-owned: waiting for ring space
+        std::deque<PacketPool::Handle> unreleased;      // Sender-owned: pushed, maybe not copied
+        uint64_t released = 0;                          // Sender-owned
+    };
+
+    // Switches run by one thread, with the events and buffers they own
+    struct alignas(64) Partition {
+        Partition(std::size_t buffers, std::size_t bufferSize) : pool(buffers, bufferSize) {}
+
+        PacketPool pool;
+        std::priority_queue<Event, std::vector<Event>, Later> events;
+        std::vector<Delivery> deliveries;   // Parallel windows only: waiting for the handler
+        uint64_t currentTime = 0;
+        uint64_t nextTime = UINT64_MAX;     // Earliest pending event, published at barriers
+        uint64_t eventsProcessed = 0;
+        uint64_t framesDelivered = 0;
+        uint64_t hopLimitDrops = 0;
+        uint64_t transferDrops = 0;
+        uint64_t linkDownDrops = 0;
+    };
+
+    class WindowBarrier;
+
+    SwitchConfig switchTemplate;
+    int maxHops;
+    int partitionCount;
+    std::vector<Node> nodes;
+    std::vector<Channel> channels;          // Link i is channels 2i (A to B) and 2i+1 (B to A)
+    std::vector<std::unique_ptr<Partition>> partitions;
+    std::vector<std::unique_ptr<Mailbox>> mailboxes;    // [from * partitionCount + to]
+    DeliveryHandler deliveryHandler;
+    bool useSpanningTree;
+    std::unique_ptr<SpanningTree> spanningTree;
+
+    bool started;                           // Topology fixed and partitions assigned
+    bool parallel;                          // Worker threads are running a window loop
+    uint64_t lookahead;
+    uint64_t currentTime;
+    uint64_t framesInjected;
+    uint64_t injectDrops;
+
+    void checkPort(int switchId, int port, const char* caller) const;
+    void checkNotStarted(const char* caller) const;
+    void start();
+
+    /**
+     * @brief Applies the spanning tree's role changes to the switches
+     *
+     * @param flush Flush ports that stopped forwarding and, after a topology
+     *        change, the linked ports of the affected trees
+     */
+    void applyPortRoles(bool flush);
+
+    Mailbox& mailbox(uint32_t from, uint32_t to) {
+        return *mailboxes[static_cast<std::size_t>(from) * partitionCount + to];
+    }
+
+    static void schedule(Partition& part, uint64_t time, uint32_t node, uint16_t port,
+                         uint8_t hops, uint64_t order, PacketPool::Handle buffer) {
+        part.events.push(Event{time, node, port, hops, order, buffer});
+    }
+
+    void handle(Partition& part, const Event& event);
+    void send(uint32_t from, uint32_t to, const Transfer& transfer);
+    bool flushBacklog(uint32_t from);
+    void drainInbox(uint32_t to);
+    void releaseCopied(uint32_t from);
+    void dispatchDeliveries();
+    void settle();
+    uint64_t runParallel(uint64_t untilNs);
+    uint64_t runPartition(uint32_t index, uint64_t untilNs, WindowBarrier& barrier);
+};
+
+/**
+ * @brief A switch port where a host is attached
+ */
+struct EdgePort {
+    int switchId;
+    int port;
+};
+
+/**
+ * @brief Adds a tree of switches to a fabric
+ *
+ * Switch k (counting from the first one added here) hangs off switch
+ * (k - 1) / fanout. Every switch has port 1 as its uplink (unused on the
+ * root), ports 2..fanout+1 for children and hostPorts edge ports after
+ * those. Ports left without a link, other than host ports, are removed from
+ * the default VLAN. A tree has no loops, so floods end at the leaves.
+ *
+ * @return Every edge port, switch by switch
+ * @throws std::invalid_argument if switches, fanout or hostPorts is out of range
+ */
+std::vector<EdgePort> buildTree(Fabric& fabric, int switches, int fanout, int hostPorts,
+                                const LinkConfig& link = LinkConfig());
+
+/**
+ * @brief Adds a two-tier leaf/spine fabric
+ *
+ * Every leaf links to every spine: leaf ports 1..spines are uplinks and
+ * hostPorts edge ports follow; spine port l+1 goes to leaf l. With more than
+ * one spine the topology has loops, which a plain learning switch floods
+ * around until FabricConfig::maxHops stops them.
+ *
+ * @return Every edge port, leaf by leaf
+ * @throws std::invalid_argument if spines, leaves or hostPorts is out of range
+ */
+std::vector<EdgePort> buildLeafSpine(Fabric& fabric, int spines, int leaves, int hostPorts,
+                                     const LinkConfig& link = LinkConfig());
+
+#endif // FABRIC_H
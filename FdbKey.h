@@ -0,0 +1,74 @@
+#ifndef FDB_KEY_H
+#define FDB_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "MacAddress.h"
+
+/**
+ * @brief Forwarding table key: a VLAN ID and a MAC address in one 64-bit word
+ *
+ * The 48-bit address occupies the low bits as in MacAddress and the 12-bit
+ * VID sits above it, so the same station on two VLANs is two independent
+ * entries while a key is still compared, copied and hashed as one integer.
+ * A bare MacAddress converts to a key on the default VLAN, which is where
+ * every frame lives on a switch without VLAN configuration.
+ */
+class FdbKey {
+public:
+    static constexpr uint16_t kDefaultVlan = 1;     // 802.1Q default PVID
+    static constexpr uint16_t kMaxVlan = 4094;      // 0 and 4095 are reserved
+    static constexpr uint64_t kVlanMask = 0xFFF;
+
+    constexpr FdbKey() : bits(0) {}
+
+    constexpr FdbKey(MacAddress mac, uint16_t vlan = kDefaultVlan)
+        : bits(((vlan & kVlanMask) << 48) | mac.toUint64()) {}
+
+    /**
+     * @brief Rebuilds a key from toUint64()
+     */
+    static constexpr FdbKey fromUint64(uint64_t value) {
+        return FdbKey(MacAddress(value), static_cast<uint16_t>(value >> 48));
+    }
+
+    constexpr MacAddress mac() const { return MacAddress(bits); }
+    constexpr uint16_t vlan() const { return static_cast<uint16_t>(bits >> 48); }
+    constexpr uint64_t toUint64() const { return bits; }
+
+    /**
+     * @brief Full-avalanche mix (MurmurHash3's fmix64) of all 60 key bits
+     *
+     * Every input bit reaches every output bit, so tables that index with
+     * the low bits (hash() & mask) spread keys that differ only in VID. A
+     * single multiply, as in MacAddress::hash(), only carries a bit upwards:
+     * the VID (bits 48-59) would never reach a small table's index.
+     */
+    constexpr uint64_t hash() const {
+        uint64_t h = bits;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        return h ^ (h >> 33);
+    }
+
+    constexpr bool operator==(const FdbKey& other) const { return bits == other.bits; }
+    constexpr bool operator!=(const FdbKey& other) const { return bits != other.bits; }
+    constexpr bool operator<(const FdbKey& other) const { return bits < other.bits; }
+
+private:
+    uint64_t bits;
+};
+
+namespace std {
+template <>
+struct hash<FdbKey> {
+    std::size_t operator()(const FdbKey& key) const noexcept {
+        return static_cast<std::size_t>(key.hash());
+    }
+};
+} // namespace std
+
+#endif // FDB_KEY_H
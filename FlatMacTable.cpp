@@ -0,0 +1,174 @@
+#include "FlatMacTable.h"
+#include <algorithm>
+
+FlatMacTable::FlatMacTable(std::size_t capacity, EvictionPolicy eviction)
+    : maxEntries(capacity > 0 ? capacity : kDefaultCapacity), count(0) {
+    // Keep the load factor at or below 75% so probe chains stay short
+    std::size_t slots = 16;
+    while (slots - slots / 4 < maxEntries) {
+        slots <<= 1;
+    }
+    slotMask = slots - 1;
+
+    keys.assign(slots, kEmptyKey);
+    ports.assign(slots, 0);
+    timestamps.assign(slots, 0);
+    portIndex = PortIndex(slots);
+    evictionIndex = EvictionIndex(eviction, slots);
+}
+
+std::size_t FlatMacTable::probe(uint64_t key) const {
+    std::size_t slot = homeSlot(key);
+    while (keys[slot] != key && keys[slot] != kEmptyKey) {
+        slot = (slot + 1) & slotMask;
+    }
+    return slot;
+}
+
+LearnOutcome FlatMacTable::learn(FdbKey key, int port, Timestamp now) {
+    const uint64_t bits = key.toUint64();
+    std::size_t slot = probe(bits);
+
+    if (keys[slot] == kEmptyKey) {
+        LearnOutcome outcome{LearnResult::Learned, port};
+        if (count >= maxEntries) {
+            if (!evictionIndex.evicts()) {
+                return {LearnResult::TableFull, port};
+            }
+            const std::size_t victim = evictionIndex.victim();
+            outcome.evictedKey = FdbKey::fromUint64(keys[victim]);
+            outcome.evictedPort = ports[victim];
+            eraseSlot(victim);
+            // Backward shifting may have moved the end of this key's probe chain
+            slot = probe(bits);
+        }
+        keys[slot] = bits;
+        ports[slot] = static_cast<uint16_t>(port);
+        timestamps[slot] = now;
+        portIndex.insert(slot, ports[slot]);
+        evictionIndex.insert(slot);
+        count++;
+        return outcome;
+    }
+
+    timestamps[slot] = now;
+    evictionIndex.touch(slot);
+    if (ports[slot] != port) {
+        int previous = ports[slot];
+        portIndex.remove(slot, previous);
+        ports[slot] = static_cast<uint16_t>(port);
+        portIndex.insert(slot, ports[slot]);
+        return {LearnResult::Moved, previous};
+    }
+    return {LearnResult::Refreshed, port};
+}
+
+int FlatMacTable::lookup(FdbKey key) const {
+    const std::size_t slot = probe(key.toUint64());
+    return keys[slot] == kEmptyKey ? kNoPort : ports[slot];
+}
+
+bool FlatMacTable::find(FdbKey key, MACTableEntry& out) const {
+    const std::size_t slot = probe(key.toUint64());
+    if (keys[slot] == kEmptyKey) {
+        return false;
+    }
+    out = entryAt(slot);
+    return true;
+}
+
+void FlatMacTable::eraseSlot(std::size_t slot) {
+    // Backward-shift deletion: pull later members of the probe chain into the
+    // hole as long as doing so does not move them before their home slot
+    portIndex.remove(slot, ports[slot]);
+    evictionIndex.remove(slot);
+    std::size_t hole = slot;
+    std::size_t next = (hole + 1) & slotMask;
+    while (keys[next] != kEmptyKey) {
+        const std::size_t home = homeSlot(keys[next]);
+        const std::size_t distNext = (next - home) & slotMask;
+        const std::size_t distHole = (hole - home) & slotMask;
+        if (distHole < distNext) {
+            keys[hole] = keys[next];
+            ports[hole] = ports[next];
+            timestamps[hole] = timestamps[next];
+            portIndex.relocate(next, hole, ports[next]);
+            evictionIndex.relocate(next, hole);
+            hole = next;
+        }
+        next = (next + 1) & slotMask;
+    }
+    keys[hole] = kEmptyKey;
+    count--;
+}
+
+bool FlatMacTable::erase(FdbKey key) {
+    const std::size_t slot = probe(key.toUint64());
+    if (keys[slot] == kEmptyKey) {
+        return false;
+    }
+    eraseSlot(slot);
+    return true;
+}
+
+std::size_t FlatMacTable::eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) {
+    // Collect first: backward shifting would move unvisited entries into
+    // slots the scan has already passed
+    std::vector<uint64_t> victims;
+    for (std::size_t slot = 0; slot <= slotMask; slot++) {
+        if (keys[slot] != kEmptyKey &&
+            predicate(entryAt(slot))) {
+            victims.push_back(keys[slot]);
+        }
+    }
+    for (uint64_t key : victims) {
+        eraseSlot(probe(key));
+    }
+    return victims.size();
+}
+
+std::size_t FlatMacTable::erasePorts(const PortMask& ports) {
+    // Erasing a list's head makes its successor (possibly shifted) the new head
+    std::size_t removed = 0;
+    ports.forEach([&](int port) {
+        for (uint32_t slot = portIndex.first(port); slot != PortIndex::kNone;
+             slot = portIndex.first(port)) {
+            eraseSlot(slot);
+            removed++;
+        }
+    });
+    return removed;
+}
+
+void FlatMacTable::forEach(const std::function<void(const MACTableEntry&)>& visit) const {
+    for (std::size_t slot = 0; slot <= slotMask; slot++) {
+        if (keys[slot] != kEmptyKey) {
+            visit(entryAt(slot));
+        }
+    }
+}
+
+void FlatMacTable::clear() {
+    std::fill(keys.begin(), keys.end(), kEmptyKey);
+    portIndex.clear();
+    evictionIndex.clear();
+    count = 0;
+}
+
+MemoryUsage FlatMacTable::memoryUsage() const {
+    MemoryUsage usage;
+    usage.bytes = keys.capacity() * sizeof(uint64_t) + ports.capacity() * sizeof(uint16_t) +
+                  timestamps.capacity() * sizeof(Timestamp) + portIndex.allocatedBytes() +
+                  evictionIndex.allocatedBytes();
+    usage.slots = slotMask + 1;
+    usage.entries = count;
+    return usage;
+}
+
+void FlatMacTable::prefetch(FdbKey key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&keys[homeSlot(key.toUint64())]);
+#else
+    (void)key;
+#endif
+}
@@ -0,0 +1,78 @@
+#ifndef FLAT_MAC_TABLE_H
+#define FLAT_MAC_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "EvictionIndex.h"
+#include "MacTable.h"
+#include "PortIndex.h"
+
+/**
+ * @brief Fixed-capacity open-addressing MAC table
+ *
+ * Models a hardware CAM: the table is sized once at construction and never
+ * allocates afterwards. Slots are probed linearly and stored as separate
+ * arrays (structure of arrays), so a probe sequence only touches the dense
+ * key array; the port and timestamp arrays are read once the key matches.
+ * Deletion uses backward shifting instead of tombstones, which keeps probe
+ * chains short under heavy aging churn. A PortIndex links the slots of each
+ * port, so flushing a port costs one erase per entry on it. When the table is
+ * full, an EvictionIndex over the same slots picks the entry to replace.
+ */
+class FlatMacTable final : public MacTable {
+public:
+    // Default capacity when none is given, in the range of real switch CAMs
+    static constexpr std::size_t kDefaultCapacity = 32768;
+
+    /**
+     * @param capacity Maximum entries (0 = kDefaultCapacity)
+     * @param eviction What learn() does when all capacity entries are in use
+     */
+    explicit FlatMacTable(std::size_t capacity = 0, EvictionPolicy eviction = EvictionPolicy::NoLearn);
+
+    LearnOutcome learn(FdbKey key, int port, Timestamp now) override;
+    int lookup(FdbKey key) const override;
+    bool find(FdbKey key, MACTableEntry& out) const override;
+    bool erase(FdbKey key) override;
+    std::size_t eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) override;
+    std::size_t erasePorts(const PortMask& ports) override;
+    std::size_t portCount(int port) const override { return portIndex.count(port); }
+    void forEach(const std::function<void(const MACTableEntry&)>& visit) const override;
+    void clear() override;
+    std::size_t size() const override { return count; }
+    std::size_t capacity() const override { return maxEntries; }
+    EvictionPolicy eviction() const override { return evictionIndex.getPolicy(); }
+    void prefetch(FdbKey key) const override;
+    MemoryUsage memoryUsage() const override;
+    const char* name() const override { return "flat"; }
+
+private:
+    // Marks an unused slot; no 60-bit (VLAN, MAC) key can collide with it
+    static constexpr uint64_t kEmptyKey = ~0ULL;
+
+    std::vector<uint64_t> keys;         // Packed (VLAN, MAC) per slot, or kEmptyKey
+    std::vector<uint16_t> ports;        // Learned port per slot
+    std::vector<Timestamp> timestamps;  // Last-seen time per slot
+    PortIndex portIndex;                // Occupied slots per port
+    EvictionIndex evictionIndex;        // Replacement order of occupied slots
+
+    std::size_t slotMask;       // Slot count - 1 (slot count is a power of two)
+    std::size_t maxEntries;     // Entries allowed before learning fails
+    std::size_t count;          // Entries currently stored
+
+    std::size_t homeSlot(uint64_t key) const {
+        return static_cast<std::size_t>(FdbKey::fromUint64(key).hash()) & slotMask;
+    }
+
+    MACTableEntry entryAt(std::size_t slot) const {
+        const FdbKey key = FdbKey::fromUint64(keys[slot]);
+        return MACTableEntry{key.mac(), ports[slot], timestamps[slot], key.vlan()};
+    }
+
+    // Returns the slot holding key, or the empty slot that ends its probe chain
+    std::size_t probe(uint64_t key) const;
+
+    void eraseSlot(std::size_t slot);
+};
+
+#endif // FLAT_MAC_TABLE_H
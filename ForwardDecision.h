@@ -0,0 +1,44 @@
+#ifndef FORWARD_DECISION_H
+#define FORWARD_DECISION_H
+
+#include "PortMask.h"
+
+/**
+ * @brief The forwarding action chosen for a frame
+ */
+enum class ForwardKind {
+    Forward,        // Known unicast: send out of exactly one port
+    Filter,         // Destination is on the ingress segment: drop
+    Broadcast,      // FF:FF:FF:FF:FF:FF: flood all ports except ingress
+    UnknownUnicast, // Destination not learned: flood all ports except ingress
+    Drop,           // Not admitted: the ingress port is not in the frame's VLAN
+    Blocked,        // Not forwarded: the ingress port is not in the Forwarding state
+    Multicast       // Registered multicast group: send to its members and router ports
+};
+
+// Number of ForwardKind values, for tables indexed by kind
+constexpr int kForwardKinds = 7;
+
+/**
+ * @brief Result of Switch::processFrame()
+ *
+ * Callers that model the output side act on this value directly instead of
+ * parsing the console trace. The egress set is any port mask type, so a
+ * BasicSwitch with a fixed port count returns a mask no wider than it needs.
+ */
+template <typename Mask>
+struct BasicForwardDecision {
+    ForwardKind kind;
+    int outPort;            // Egress port for Forward (and the filtering port for Filter), otherwise -1
+    Mask egressPorts;       // Every port the frame leaves on (empty when filtered or dropped)
+
+    // Multicast to a registered group is not a flood: it reaches only the group
+    bool isFlood() const {
+        return kind == ForwardKind::Broadcast || kind == ForwardKind::UnknownUnicast;
+    }
+};
+
+// Decision of the runtime-configured switches, over the full 256-port mask
+using ForwardDecision = BasicForwardDecision<PortMask>;
+
+#endif // FORWARD_DECISION_H
@@ -1,34 +1,100 @@
 #ifndef FRAME_H
 #define FRAME_H
 
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include "EtherType.h"
+#include "FrameView.h"
+#include "MacAddress.h"
 
 /**
  * @brief Represents an Ethernet Frame (OSI Layer 2)
  * 
  * This struct models a simplified Ethernet frame containing:
- * - Source MAC address (48-bit, represented as string)
- * - Destination MAC address (48-bit, represented as string)
+ * - Source MAC address (48-bit, packed binary)
+ * - Destination MAC address (48-bit, packed binary)
  * - EtherType field (e.g., 0x0800 for IPv4, 0x0806 for ARP)
  * - Payload data
+ * 
+ * Frame owns its payload. Code that only inspects frames held in another
+ * buffer should use FrameView instead; view() converts the other way.
  */
 struct Frame {
-    std::string sourceMAC;      // Source MAC address (e.g., "AA:BB:CC:DD:EE:FF")
-    std::string destMAC;        // Destination MAC address
-    std::string etherType;      // Protocol type (e.g., "IPv4", "ARP")
+    MacAddress sourceMAC;       // Source MAC address (e.g., AA:BB:CC:DD:EE:FF)
+    MacAddress destMAC;         // Destination MAC address
+    uint16_t etherType;         // Protocol type as on the wire (see EtherType)
+    bool tagged = false;        // Sent with an 802.1Q tag carrying vlan and priority
+    uint8_t priority = 0;       // 802.1p priority (0-7); selects the egress traffic class
+    uint16_t vlan = 0;          // VLAN ID of a tagged frame (0 = priority-tagged)
     std::string payload;        // Frame payload/data
     
     /**
-     * @brief Constructs a new Frame object
+     * @brief Constructs a new Frame object from binary addresses
      * 
      * @param src Source MAC address
      * @param dest Destination MAC address
-     * @param type EtherType/Protocol
+     * @param type EtherType value
+     * @param data Payload data (moved in)
+     */
+    Frame(MacAddress src, MacAddress dest, uint16_t type = EtherType::kIPv4, std::string data = {})
+        : sourceMAC(src), destMAC(dest), etherType(type), payload(std::move(data)) {}
+
+    /**
+     * @brief Constructs a Frame naming its EtherType
+     * 
+     * @param type EtherType name ("IPv4", "ARP", ...) or hex value ("0x88B5")
+     * @throws std::invalid_argument if type is not a known name or hex value
+     */
+    Frame(MacAddress src, MacAddress dest, std::string_view type, std::string data = {})
+        : Frame(src, dest, parseEtherType(type), std::move(data)) {}
+
+    /**
+     * @brief Constructs a new Frame object from MAC address text
+     * 
+     * @param src Source MAC address (e.g., "AA:BB:CC:DD:EE:FF")
+     * @param dest Destination MAC address
+     * @param type EtherType value
      * @param data Payload data
+     * @throws std::invalid_argument if either address is malformed
+     */
+    Frame(std::string_view src, std::string_view dest,
+          uint16_t type = EtherType::kIPv4, std::string data = {})
+        : Frame(MacAddress::fromString(src), MacAddress::fromString(dest), type, std::move(data)) {}
+
+    /**
+     * @brief Copies a viewed frame, payload included, into owned storage
      */
-    Frame(const std::string& src, const std::string& dest, 
-          const std::string& type = "IPv4", const std::string& data = "")
-        : sourceMAC(src), destMAC(dest), etherType(type), payload(data) {}
+    explicit Frame(const FrameView& view)
+        : Frame(view.sourceMAC, view.destMAC, view.etherType, std::string(view.payload)) {
+        tagged = view.tagged;
+        priority = view.priority;
+        vlan = view.vlan;
+    }
+
+    /**
+     * @brief Non-owning view of this frame; valid while the frame is unchanged
+     */
+    FrameView view() const {
+        FrameView v;
+        v.destMAC = destMAC;
+        v.sourceMAC = sourceMAC;
+        v.etherType = etherType;
+        v.tagged = tagged;
+        v.priority = priority;
+        v.vlan = vlan;
+        v.payload = payload;
+        return v;
+    }
+
+private:
+    static uint16_t parseEtherType(std::string_view name) {
+        uint16_t type;
+        if (!EtherType::parse(name, type)) {
+            throw std::invalid_argument("Frame: unknown EtherType '" + std::string(name) + "'");
+        }
+        return type;
+    }
 };
 
 #endif // FRAME_H
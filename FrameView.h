@@ -0,0 +1,104 @@
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "MacAddress.h"
+
+/**
+ * @brief Non-owning view of an Ethernet frame held in someone else's buffer
+ *
+ * The header fields are decoded into binary form, while the payload is a
+ * view into the original bytes, so creating a FrameView never allocates or
+ * copies frame data. The buffer (a capture file mapping, a ring slot) must
+ * outlive the view.
+ */
+struct FrameView {
+    // Destination (6) + source (6) + EtherType (2)
+    static constexpr std::size_t kHeaderLength = 14;
+
+    // 802.1Q tag: TPID (2) + TCI (2), between the source address and EtherType
+    static constexpr std::size_t kTagLength = 4;
+
+    // 802.1Q tag protocol identifier (same value as EtherType::kVLAN)
+    static constexpr uint16_t kTagType = 0x8100;
+
+    MacAddress destMAC;         // Destination MAC address
+    MacAddress sourceMAC;       // Source MAC address
+    uint16_t etherType = 0;     // EtherType of the payload (after any 802.1Q tag)
+    bool tagged = false;        // Carries an 802.1Q tag
+    uint8_t priority = 0;       // 802.1p priority (0-7); selects the egress traffic class
+    uint16_t vlan = 0;          // VLAN ID from the tag (0 = untagged or priority-tagged)
+    std::string_view payload;   // Bytes after the header, not copied
+
+    /**
+     * @brief Decodes the Ethernet header of a raw frame in place
+     *
+     * An 802.1Q tag is decoded into tagged, priority and vlan, and etherType
+     * is the one that follows it.
+     *
+     * @param data Frame bytes, starting with the destination address
+     * @param length Number of bytes available at data
+     * @param out Receives the decoded view on success
+     * @return false if the frame is shorter than an Ethernet header
+     */
+    static bool parse(const uint8_t* data, std::size_t length, FrameView& out) {
+        if (length < kHeaderLength) {
+            return false;
+        }
+        out.destMAC = MacAddress::fromBytes(data);
+        out.sourceMAC = MacAddress::fromBytes(data + 6);
+        out.etherType = static_cast<uint16_t>((data[12] << 8) | data[13]);
+        std::size_t header = kHeaderLength;
+        if (out.etherType == kTagType && length >= kHeaderLength + kTagLength) {
+            const uint16_t tci = static_cast<uint16_t>((data[14] << 8) | data[15]);
+            out.tagged = true;
+            out.priority = static_cast<uint8_t>(tci >> 13);
+            out.vlan = tci & 0x0FFF;
+            out.etherType = static_cast<uint16_t>((data[16] << 8) | data[17]);
+            header += kTagLength;
+        } else {
+            out.tagged = false;
+            out.priority = 0;
+            out.vlan = 0;
+        }
+        out.payload = std::string_view(reinterpret_cast<const char*>(data) + header,
+                                       length - header);
+        return true;
+    }
+
+    /**
+     * @brief Size of the frame on the wire (header, tag and payload, no FCS)
+     */
+    std::size_t wireLength() const {
+        return kHeaderLength + (tagged ? kTagLength : 0) + payload.size();
+    }
+
+    /**
+     * @brief Serializes the frame in wire format
+     *
+     * @param out Buffer of at least wireLength() bytes
+     */
+    void write(uint8_t* out) const {
+        destMAC.toBytes(out);
+        sourceMAC.toBytes(out + 6);
+        uint8_t* next = out + 12;
+        if (tagged) {
+            const uint16_t tci = static_cast<uint16_t>((priority << 13) | (vlan & 0x0FFF));
+            next[0] = static_cast<uint8_t>(kTagType >> 8);
+            next[1] = static_cast<uint8_t>(kTagType);
+            next[2] = static_cast<uint8_t>(tci >> 8);
+            next[3] = static_cast<uint8_t>(tci);
+            next += kTagLength;
+        }
+        next[0] = static_cast<uint8_t>(etherType >> 8);
+        next[1] = static_cast<uint8_t>(etherType);
+        if (!payload.empty()) {
+            std::memcpy(next + 2, payload.data(), payload.size());
+        }
+    }
+};
+
+#endif // FRAME_VIEW_H
@@ -0,0 +1,175 @@
+#include "HashMacTable.h"
+#include <algorithm>
+
+HashMacTable::HashMacTable(std::size_t capacity, EvictionPolicy eviction)
+    : entries(0, std::hash<FdbKey>(), std::equal_to<FdbKey>(), CountingAllocator<Node>(&mapBytes)),
+      maxEntries(capacity), portLists(PortMask::kMaxPorts + 1) {
+    if (maxEntries > 0) {
+        entries.reserve(maxEntries);
+        // An unbounded table is never full, so it never evicts
+        evictionIndex = EvictionIndex(eviction, maxEntries);
+    }
+    if (evictionIndex.evicts()) {
+        slotNodes.assign(maxEntries, nullptr);
+        resetSlots();
+    }
+}
+
+void HashMacTable::resetSlots() {
+    freeSlots.resize(maxEntries);
+    for (std::size_t i = 0; i < maxEntries; i++) {
+        freeSlots[i] = static_cast<uint32_t>(maxEntries - 1 - i);
+    }
+}
+
+void HashMacTable::track(Node& node) {
+    if (evictionIndex.evicts()) {
+        node.second.slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotNodes[node.second.slot] = &node;
+        evictionIndex.insert(node.second.slot);
+    }
+}
+
+void HashMacTable::untrack(const Node& node) {
+    if (evictionIndex.evicts()) {
+        evictionIndex.remove(node.second.slot);
+        freeSlots.push_back(node.second.slot);
+    }
+}
+
+void HashMacTable::link(Node& node) {
+    PortList& list = listOf(node.second.port);
+    node.second.prevOnPort = nullptr;
+    node.second.nextOnPort = list.head;
+    if (list.head) {
+        list.head->second.prevOnPort = &node;
+    }
+    list.head = &node;
+    list.count++;
+}
+
+void HashMacTable::unlink(Node& node) {
+    PortList& list = listOf(node.second.port);
+    if (node.second.prevOnPort) {
+        node.second.prevOnPort->second.nextOnPort = node.second.nextOnPort;
+    } else {
+        list.head = node.second.nextOnPort;
+    }
+    if (node.second.nextOnPort) {
+        node.second.nextOnPort->second.prevOnPort = node.second.prevOnPort;
+    }
+    list.count--;
+}
+
+LearnOutcome HashMacTable::learn(FdbKey key, int port, Timestamp now) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        LearnOutcome outcome{LearnResult::Learned, port};
+        if (maxEntries > 0 && entries.size() >= maxEntries) {
+            if (!evictionIndex.evicts()) {
+                return {LearnResult::TableFull, port};
+            }
+            Node& victim = *slotNodes[evictionIndex.victim()];
+            outcome.evictedKey = victim.first;
+            outcome.evictedPort = victim.second.port;
+            erase(victim.first);
+        }
+        Node& node = *entries.emplace(key, Value{port, now, nullptr, nullptr, 0}).first;
+        link(node);
+        track(node);
+        return outcome;
+    }
+
+    it->second.timestamp = now;
+    evictionIndex.touch(it->second.slot);
+    if (it->second.port != port) {
+        int previous = it->second.port;
+        unlink(*it);
+        it->second.port = port;
+        link(*it);
+        return {LearnResult::Moved, previous};
+    }
+    return {LearnResult::Refreshed, port};
+}
+
+int HashMacTable::lookup(FdbKey key) const {
+    auto it = entries.find(key);
+    return it == entries.end() ? kNoPort : it->second.port;
+}
+
+bool HashMacTable::find(FdbKey key, MACTableEntry& out) const {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    out = entryOf(*it);
+    return true;
+}
+
+bool HashMacTable::erase(FdbKey key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    unlink(*it);
+    untrack(*it);
+    entries.erase(it);
+    return true;
+}
+
+std::size_t HashMacTable::eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) {
+    std::size_t removed = 0;
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (predicate(entryOf(*it))) {
+            unlink(*it);
+            untrack(*it);
+            it = entries.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+std::size_t HashMacTable::erasePorts(const PortMask& ports) {
+    std::size_t removed = 0;
+    ports.forEach([&](int port) {
+        PortList& list = listOf(port);
+        while (list.head) {
+            const FdbKey key = list.head->first;
+            untrack(*list.head);
+            list.head = list.head->second.nextOnPort;
+            entries.erase(key);
+            removed++;
+        }
+        list.count = 0;
+    });
+    return removed;
+}
+
+void HashMacTable::forEach(const std::function<void(const MACTableEntry&)>& visit) const {
+    for (const auto& entry : entries) {
+        visit(entryOf(entry));
+    }
+}
+
+void HashMacTable::clear() {
+    entries.clear();
+    std::fill(portLists.begin(), portLists.end(), PortList{});
+    if (evictionIndex.evicts()) {
+        evictionIndex.clear();
+        resetSlots();
+    }
+}
+
+MemoryUsage HashMacTable::memoryUsage() const {
+    MemoryUsage usage;
+    usage.bytes = mapBytes + portLists.capacity() * sizeof(PortList) +
+                  slotNodes.capacity() * sizeof(Node*) + freeSlots.capacity() * sizeof(uint32_t) +
+                  evictionIndex.allocatedBytes();
+    usage.slots = entries.bucket_count();
+    usage.entries = entries.size();
+    return usage;
+}
@@ -0,0 +1,131 @@
+#ifndef HASH_MAC_TABLE_H
+#define HASH_MAC_TABLE_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "EvictionIndex.h"
+#include "MacTable.h"
+
+/**
+ * @brief MAC table backed by std::unordered_map
+ *
+ * This is the original engine: simple and unbounded by default, but every
+ * entry is a separately allocated node, so each learn and lookup chases a
+ * pointer into a cold cache line.
+ *
+ * Map nodes never move, so each entry also links to the previous and next
+ * entry on its port; flushing a port walks that list instead of the table.
+ * A bounded table that evicts also gives each entry one of capacity fixed
+ * slot numbers, which an EvictionIndex orders for replacement.
+ *
+ * The map allocates through a counting allocator, so memoryUsage() reports
+ * the node and bucket bytes actually requested (malloc's own header on each
+ * node comes on top).
+ */
+class HashMacTable final : public MacTable {
+private:
+    struct Value;
+    using Node = std::pair<const FdbKey, Value>;
+
+    struct Value {
+        int port;
+        Timestamp timestamp;
+        Node* prevOnPort;
+        Node* nextOnPort;
+        uint32_t slot;      // Eviction slot (only used when the table evicts)
+    };
+
+    struct PortList {
+        Node* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    // std::allocator that adds what it hands out to a byte counter
+    template <typename T>
+    struct CountingAllocator {
+        using value_type = T;
+
+        std::size_t* allocated;
+
+        explicit CountingAllocator(std::size_t* allocated) : allocated(allocated) {}
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>& other) : allocated(other.allocated) {}
+
+        T* allocate(std::size_t n) {
+            T* p = std::allocator<T>().allocate(n);
+            *allocated += n * sizeof(T);
+            return p;
+        }
+        void deallocate(T* p, std::size_t n) {
+            *allocated -= n * sizeof(T);
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        template <typename U>
+        bool operator==(const CountingAllocator<U>& other) const { return allocated == other.allocated; }
+        template <typename U>
+        bool operator!=(const CountingAllocator<U>& other) const { return allocated != other.allocated; }
+    };
+
+    // Bytes held by the map's nodes and bucket array; declared before the map it counts for
+    std::size_t mapBytes = 0;
+
+    std::unordered_map<FdbKey, Value, std::hash<FdbKey>, std::equal_to<FdbKey>,
+                       CountingAllocator<Node>> entries;
+
+    // Maximum entries (0 = unbounded)
+    std::size_t maxEntries;
+
+    // Entries per port; ports outside 1..PortMask::kMaxPorts share list 0
+    std::vector<PortList> portLists;
+
+    EvictionIndex evictionIndex;
+    std::vector<Node*> slotNodes;       // Entry holding each eviction slot
+    std::vector<uint32_t> freeSlots;    // Eviction slots not in use
+
+    PortList& listOf(int port) { return portLists[PortMask::valid(port) ? port : 0]; }
+    const PortList& listOf(int port) const { return portLists[PortMask::valid(port) ? port : 0]; }
+
+    void link(Node& node);
+    void unlink(Node& node);
+
+    // Give an entry an eviction slot, and take it back
+    void track(Node& node);
+    void untrack(const Node& node);
+    void resetSlots();
+
+    static MACTableEntry entryOf(const std::pair<const FdbKey, Value>& entry) {
+        return MACTableEntry{entry.first.mac(), entry.second.port, entry.second.timestamp,
+                             entry.first.vlan()};
+    }
+
+public:
+    /**
+     * @param capacity Maximum entries (0 = unbounded)
+     * @param eviction What learn() does when a bounded table is full
+     */
+    explicit HashMacTable(std::size_t capacity = 0, EvictionPolicy eviction = EvictionPolicy::NoLearn);
+
+    // The map's allocator points at this table's counter
+    HashMacTable(const HashMacTable&) = delete;
+    HashMacTable& operator=(const HashMacTable&) = delete;
+
+    LearnOutcome learn(FdbKey key, int port, Timestamp now) override;
+    int lookup(FdbKey key) const override;
+    bool find(FdbKey key, MACTableEntry& out) const override;
+    bool erase(FdbKey key) override;
+    std::size_t eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) override;
+    std::size_t erasePorts(const PortMask& ports) override;
+    std::size_t portCount(int port) const override { return listOf(port).count; }
+    void forEach(const std::function<void(const MACTableEntry&)>& visit) const override;
+    void clear() override;
+    std::size_t size() const override { return entries.size(); }
+    std::size_t capacity() const override { return maxEntries; }
+    EvictionPolicy eviction() const override { return evictionIndex.getPolicy(); }
+    void reserve(std::size_t count) override { entries.reserve(count); }
+    MemoryUsage memoryUsage() const override;
+    const char* name() const override { return "hash"; }
+};
+
+#endif // HASH_MAC_TABLE_H
@@ -0,0 +1,231 @@
+#include "LinkAggregation.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "EtherType.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define LAG_CRC_X86 1
+#endif
+
+namespace {
+
+constexpr uint8_t kProtocolTcp = 6;
+constexpr uint8_t kProtocolUdp = 17;
+
+// Byte-at-a-time table for the reflected Castagnoli polynomial
+struct CrcTable {
+    uint32_t value[256];
+
+    constexpr CrcTable() : value() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (crc & 1 ? 0x82F63B78u : 0);
+            }
+            value[i] = crc;
+        }
+    }
+};
+
+constexpr CrcTable kCrc;
+
+uint32_t crcScalar(const uint8_t* p, std::size_t length, uint32_t crc) {
+    for (std::size_t i = 0; i < length; i++) {
+        crc = kCrc.value[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef LAG_CRC_X86
+
+__attribute__((target("sse4.2")))
+uint32_t crcSse42(const uint8_t* p, std::size_t length, uint32_t crc) {
+    uint64_t wide = crc;
+    for (; length >= 8; p += 8, length -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<uint32_t>(wide);
+    for (; length > 0; p++, length--) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+    return crc;
+}
+
+bool detectSse42() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+const bool kHasSse42 = detectSse42();
+
+#endif // LAG_CRC_X86
+
+// Appends the IP addresses (and, for L4 hashing, the ports) of a frame
+std::size_t ipFields(const FrameView& frame, bool ports, uint8_t* out) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(frame.payload.data());
+    const std::size_t length = frame.payload.size();
+    std::size_t header = 0;
+    uint8_t protocol = 0;
+    std::size_t written = 0;
+
+    if (frame.etherType == EtherType::kIPv4 && length >= 20 && (p[0] >> 4) == 4) {
+        header = std::size_t(p[0] & 0x0F) * 4;
+        std::memcpy(out, p + 12, 8);
+        written = 8;
+        // Only the first fragment carries the ports; hash every fragment alike
+        const bool fragment = (p[6] & 0x3F) != 0 || p[7] != 0;
+        protocol = fragment ? 0 : p[9];
+    } else if (frame.etherType == EtherType::kIPv6 && length >= 40 && (p[0] >> 4) == 6) {
+        header = 40;
+        std::memcpy(out, p + 8, 32);
+        written = 32;
+        protocol = p[6];        // Extension headers are not walked
+    } else {
+        return 0;
+    }
+    if (ports && (protocol == kProtocolTcp || protocol == kProtocolUdp) && header + 4 <= length) {
+        std::memcpy(out + written, p + header, 4);
+        written += 4;
+    }
+    return written;
+}
+
+} // namespace
+
+LinkAggregation::LinkAggregation(int numPorts)
+    : aggregator(std::max(numPorts, 0) + 1), groups(std::max(numPorts, 0) + 1),
+      load(std::max(numPorts, 0) + 1, 0), numPorts(numPorts) {
+    for (std::size_t port = 0; port < aggregator.size(); port++) {
+        aggregator[port] = static_cast<int>(port);
+    }
+}
+
+int LinkAggregation::add(const PortMask& members) {
+    if (members.none()) {
+        throw std::invalid_argument("LinkAggregation: a LAG needs at least one member");
+    }
+    if (members != (members & PortMask::firstPorts(numPorts))) {
+        throw std::invalid_argument("LinkAggregation: member port out of range");
+    }
+    if ((members & aggregated).any()) {
+        throw std::invalid_argument("LinkAggregation: port " +
+                                    std::to_string((members & aggregated).first()) +
+                                    " is already in a LAG");
+    }
+    const int id = members.first();
+    Group& group = groups[id];
+    group.members = members;
+    group.active.clear();
+    members.forEach([&](int port) {
+        aggregator[port] = id;
+        group.active.push_back(port);
+    });
+    aggregators.set(id);
+    aggregated |= members;
+    secondaries |= members.without(id);
+    return id;
+}
+
+void LinkAggregation::remove(int lag) {
+    if (lag < 1 || lag > numPorts || !isLag(lag)) {
+        throw std::invalid_argument("LinkAggregation: " + std::to_string(lag) + " is not a LAG");
+    }
+    Group& group = groups[lag];
+    group.members.forEach([&](int port) { aggregator[port] = port; });
+    aggregated.andNot(group.members);
+    secondaries.andNot(group.members);
+    aggregators.reset(lag);
+    group = Group{};
+}
+
+int LinkAggregation::setActive(int port, bool active) {
+    if (port < 1 || port > numPorts || !aggregated.test(port)) {
+        throw std::invalid_argument("LinkAggregation: port " + std::to_string(port) +
+                                    " is not in a LAG");
+    }
+    std::vector<int>& links = groups[aggregator[port]].active;
+    auto it = std::lower_bound(links.begin(), links.end(), port);
+    const bool present = it != links.end() && *it == port;
+    if (active && !present) {
+        links.insert(it, port);
+    } else if (!active && present) {
+        links.erase(it);
+    }
+    return static_cast<int>(links.size());
+}
+
+PortMask LinkAggregation::membersOf(int lag) const {
+    return lag >= 1 && lag <= numPorts && isLag(lag) ? groups[lag].members : PortMask();
+}
+
+PortMask LinkAggregation::distribute(PortMask egress, uint32_t hash) {
+    egress.andNot(secondaries);
+    PortMask lags = egress;
+    lags &= aggregators;
+    lags.forEach([&](int lag) {
+        egress.reset(lag);
+        const int member = select(lag, hash);
+        if (member != 0) {
+            egress.set(member);
+            load[member]++;
+        }
+    });
+    return egress;
+}
+
+double LinkAggregation::imbalance(int lag) const {
+    if (lag < 1 || lag > numPorts || !isLag(lag) || groups[lag].active.empty()) {
+        return 0.0;
+    }
+    uint64_t total = 0;
+    uint64_t busiest = 0;
+    for (int port : groups[lag].active) {
+        total += load[port];
+        busiest = std::max(busiest, load[port]);
+    }
+    return total == 0 ? 1.0 : static_cast<double>(busiest) * groups[lag].active.size() / total;
+}
+
+void LinkAggregation::clearLoad() {
+    std::fill(load.begin(), load.end(), 0);
+}
+
+uint32_t LinkAggregation::flowHash(const FrameView& frame, LagHash fields) {
+    // IPv6 addresses (32) + ports (4) + MACs as two packed words (16)
+    uint8_t key[56];
+    std::size_t length = 0;
+    if (fields != LagHash::L2) {
+        length = ipFields(frame, fields == LagHash::L3L4, key);
+    }
+    if (fields != LagHash::L3L4 || length == 0) {
+        // Whole words rather than 12 address bytes: two CRC steps, no tail
+        const uint64_t macs[2] = {frame.sourceMAC.toUint64(), frame.destMAC.toUint64()};
+        std::memcpy(key + length, macs, sizeof(macs));
+        length += sizeof(macs);
+    }
+    return crc32c(key, length);
+}
+
+uint32_t LinkAggregation::crc32c(const void* data, std::size_t length, uint32_t crc) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+#ifdef LAG_CRC_X86
+    if (kHasSse42) {
+        return ~crcSse42(p, length, ~crc);
+    }
+#endif
+    return ~crcScalar(p, length, ~crc);
+}
+
+const char* LinkAggregation::crcImplementation() {
+#ifdef LAG_CRC_X86
+    if (kHasSse42) {
+        return "sse4.2";
+    }
+#endif
+    return "scalar";
+}
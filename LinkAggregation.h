@@ -0,0 +1,169 @@
+#ifndef LINK_AGGREGATION_H
+#define LINK_AGGREGATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FrameView.h"
+#include "PortMask.h"
+
+/**
+ * @brief Header fields a LAG hashes to pick the member a frame leaves on
+ *
+ * Named after the Linux bonding xmit_hash_policy values. Fields a frame does
+ * not have (L3 on ARP, L4 on fragments and non-TCP/UDP) are left out, so
+ * such frames fall back to the fields they do carry.
+ */
+enum class LagHash {
+    L2,         // Source and destination MAC
+    L2L3,       // MACs and IP addresses
+    L3L4        // IP addresses and TCP/UDP ports (MACs without IP)
+};
+
+/**
+ * @brief Link aggregation groups (802.1AX) of a switch
+ *
+ * A LAG bundles member ports into one logical port. It is identified by its
+ * lowest member port, the aggregator: the MAC table learns stations behind
+ * any member against that ID, so traffic arriving over different links of
+ * the same server is never a station move, and the ID takes part in flood
+ * sets like any other port. On the way out, a flow hash of the frame picks
+ * one active member, so a flow always uses one link (keeping its frames in
+ * order) while different flows spread over all of them.
+ *
+ * Member selection multiplies the 32-bit hash by the active member count
+ * and keeps the high word, which avoids a division. Each member counts the
+ * frames sent on it, to show how evenly a hash spreads a workload.
+ */
+class LinkAggregation {
+public:
+    /**
+     * @param numPorts Ports of the switch (members are 1..numPorts)
+     */
+    explicit LinkAggregation(int numPorts = 0);
+
+    /**
+     * @brief Bundles ports into a LAG
+     *
+     * @return The LAG ID (lowest member port)
+     * @throws std::invalid_argument if the set is empty, or a port does not
+     *         exist or already belongs to a LAG
+     */
+    int add(const PortMask& members);
+
+    /**
+     * @brief Splits a LAG back into individual ports
+     *
+     * @throws std::invalid_argument if lag is not a LAG ID
+     */
+    void remove(int lag);
+
+    /**
+     * @brief Marks a member link up or down (as LACP would report it)
+     *
+     * Down members get no traffic; their flows move to the others.
+     *
+     * @return Active members left in the LAG
+     * @throws std::invalid_argument if the port is not in a LAG
+     */
+    int setActive(int port, bool active);
+
+    /**
+     * @brief Logical port a physical port belongs to (the port itself if not aggregated)
+     */
+    int aggregatorOf(int port) const { return aggregator[port]; }
+
+    bool isLag(int port) const { return aggregators.test(port); }
+
+    bool empty() const { return aggregators.none(); }
+
+    /**
+     * @brief IDs of every LAG, as a mask
+     */
+    const PortMask& getLags() const { return aggregators; }
+
+    /**
+     * @brief Member ports of a LAG (empty if port is not a LAG ID)
+     */
+    PortMask membersOf(int lag) const;
+
+    /**
+     * @brief Active member a flow leaves a LAG on, or 0 if every member is down
+     */
+    int select(int lag, uint32_t hash) const {
+        const std::vector<int>& links = groups[lag].active;
+        if (links.empty()) {
+            return 0;
+        }
+        return links[(static_cast<uint64_t>(hash) * links.size()) >> 32];
+    }
+
+    /**
+     * @brief Whether an egress set involves a LAG and must be distributed
+     */
+    bool involves(const PortMask& egress) const {
+        PortMask lagPorts = egress;
+        lagPorts &= aggregated;
+        return lagPorts.any();
+    }
+
+    /**
+     * @brief Replaces each LAG in an egress set by the member chosen for a flow
+     *
+     * Non-aggregator members are removed first, so a flood sends one copy
+     * per LAG and never returns to the LAG it came from (whose ID the
+     * caller has already removed). Chosen members are counted.
+     */
+    PortMask distribute(PortMask egress, uint32_t hash);
+
+    /**
+     * @brief Counts a frame sent on a member
+     */
+    void countEgress(int port) { load[port]++; }
+
+    /**
+     * @brief Frames sent on a member port since the last clearLoad()
+     */
+    uint64_t getLoad(int port) const { return load[port]; }
+
+    /**
+     * @brief Busiest active member's load over the mean (1.0 = perfectly even)
+     */
+    double imbalance(int lag) const;
+
+    void clearLoad();
+
+    /**
+     * @brief Flow hash of a frame
+     *
+     * CRC32C of the selected fields, using the SSE4.2 CRC instruction when
+     * the CPU has it.
+     */
+    static uint32_t flowHash(const FrameView& frame, LagHash fields);
+
+    /**
+     * @brief CRC32C (Castagnoli) of a buffer, continuing from crc
+     */
+    static uint32_t crc32c(const void* data, std::size_t length, uint32_t crc = 0);
+
+    /**
+     * @brief CRC implementation in use: "sse4.2" or "scalar"
+     */
+    static const char* crcImplementation();
+
+private:
+    struct Group {
+        PortMask members;
+        std::vector<int> active;        // Members with their link up, ascending
+    };
+
+    std::vector<int> aggregator;        // Logical port of each port, indexed by port
+    std::vector<Group> groups;          // Indexed by LAG ID
+    std::vector<uint64_t> load;         // Frames sent, indexed by port
+    PortMask aggregators;               // LAG IDs
+    PortMask aggregated;                // Every LAG member
+    PortMask secondaries;               // Members other than the LAG IDs
+    int numPorts;
+};
+
+#endif // LINK_AGGREGATION_H
@@ -0,0 +1,291 @@
+#include "MacAddress.h"
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define MAC_SIMD_X86 1
+#endif
+
+namespace {
+
+// Maps an ASCII character to its hex value, or 0xFF if it is not a hex digit
+struct HexTable {
+    uint8_t value[256];
+
+    constexpr HexTable() : value() {
+        for (int i = 0; i < 256; i++) {
+            value[i] = 0xFF;
+        }
+        for (int i = 0; i < 10; i++) {
+            value['0' + i] = static_cast<uint8_t>(i);
+        }
+        for (int i = 0; i < 6; i++) {
+            value['A' + i] = static_cast<uint8_t>(10 + i);
+            value['a' + i] = static_cast<uint8_t>(10 + i);
+        }
+    }
+};
+
+constexpr HexTable kHex;
+constexpr char kDigits[] = "0123456789ABCDEF";
+
+#ifdef MAC_SIMD_X86
+
+// Text positions of the twelve hex digits and five separators within one
+// address; the last digit (position 16) lies past a 16-byte load and is
+// inserted separately
+#define MAC_DIGIT_LANES 0, 1, 3, 4, 6, 7, 9, 10, 12, 13, 15, -1, -1, -1, -1, -1
+#define MAC_SEPARATOR_LANES 2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+#define MAC_PAIR_WEIGHTS 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1
+
+constexpr int kDigitMask = 0x0FFF;      // movemask bits of the twelve digit lanes
+constexpr int kSeparatorMask = 0x001F;  // movemask bits of the five separator lanes
+
+bool isSeparator(char c) {
+    return c == ':' || c == '-';
+}
+
+// Octets in lanes 0-5 (first octet lowest) as a packed 48-bit address
+uint64_t packOctets(uint64_t lanes) {
+    return __builtin_bswap64(lanes) >> 16;
+}
+
+/**
+ * @brief Decodes one 17-character address
+ *
+ * Digits are gathered with a byte shuffle, classified as 0-9 or a-f/A-F with
+ * signed compares (bytes over 0x7F compare negative and fail both), decoded
+ * with a blend, and pairs are combined by a multiply-add of (16, 1).
+ */
+__attribute__((target("sse4.1")))
+bool parseSse41(const char* text, uint64_t& out) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    __m128i digits = _mm_shuffle_epi8(raw, _mm_setr_epi8(MAC_DIGIT_LANES));
+    digits = _mm_insert_epi8(digits, text[16], 11);
+    const __m128i separators = _mm_shuffle_epi8(raw, _mm_setr_epi8(MAC_SEPARATOR_LANES));
+
+    const __m128i lower = _mm_or_si128(digits, _mm_set1_epi8(0x20));
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmplt_epi8(digits, _mm_set1_epi8('9' + 1)));
+    const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    const int digitBits = _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+    const int separatorBits = _mm_movemask_epi8(_mm_cmpeq_epi8(separators, _mm_set1_epi8(text[2])));
+    if ((digitBits & kDigitMask) != kDigitMask || (separatorBits & kSeparatorMask) != kSeparatorMask ||
+        !isSeparator(text[2])) {
+        return false;
+    }
+
+    const __m128i values = _mm_blendv_epi8(_mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)),
+                                           _mm_sub_epi8(digits, _mm_set1_epi8('0')), isDigit);
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_setr_epi8(MAC_PAIR_WEIGHTS));
+    out = packOctets(static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_packus_epi16(pairs, pairs))));
+    return true;
+}
+
+/**
+ * @brief Decodes two 17-character addresses, one per 128-bit lane
+ *
+ * Same steps as parseSse41(); AVX2 shuffles and multiply-adds work within
+ * each lane, so the two addresses never mix.
+ *
+ * @return Bit 0 set if the first address is valid, bit 1 for the second
+ */
+__attribute__((target("avx2")))
+int parseAvx2Pair(const char* first, const char* second, uint64_t& outFirst, uint64_t& outSecond) {
+    const __m256i raw = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(second)), 1);
+    __m256i digits = _mm256_shuffle_epi8(raw, _mm256_setr_epi8(MAC_DIGIT_LANES, MAC_DIGIT_LANES));
+    digits = _mm256_insert_epi8(digits, first[16], 11);
+    digits = _mm256_insert_epi8(digits, second[16], 27);
+    const __m256i separators =
+        _mm256_shuffle_epi8(raw, _mm256_setr_epi8(MAC_SEPARATOR_LANES, MAC_SEPARATOR_LANES));
+    const __m256i expected = _mm256_setr_m128i(_mm_set1_epi8(first[2]), _mm_set1_epi8(second[2]));
+
+    const __m256i lower = _mm256_or_si256(digits, _mm256_set1_epi8(0x20));
+    const __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(digits, _mm256_set1_epi8('0' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), digits));
+    const __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                              _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    const uint32_t digitBits =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)));
+    const uint32_t separatorBits =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(separators, expected)));
+
+    const __m256i values = _mm256_blendv_epi8(_mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)),
+                                              _mm256_sub_epi8(digits, _mm256_set1_epi8('0')), isDigit);
+    const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_setr_epi8(MAC_PAIR_WEIGHTS, MAC_PAIR_WEIGHTS));
+    const __m256i octets = _mm256_packus_epi16(pairs, pairs);
+    outFirst = packOctets(static_cast<uint64_t>(_mm256_extract_epi64(octets, 0)));
+    outSecond = packOctets(static_cast<uint64_t>(_mm256_extract_epi64(octets, 2)));
+
+    int valid = 0;
+    if ((digitBits & kDigitMask) == kDigitMask &&
+        (separatorBits & kSeparatorMask) == kSeparatorMask && isSeparator(first[2])) {
+        valid |= 1;
+    }
+    if (((digitBits >> 16) & kDigitMask) == kDigitMask &&
+        ((separatorBits >> 16) & kSeparatorMask) == kSeparatorMask && isSeparator(second[2])) {
+        valid |= 2;
+    }
+    return valid;
+}
+
+enum class BatchParser { Scalar, Sse41, Avx2 };
+
+BatchParser detectBatchParser() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return BatchParser::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return BatchParser::Sse41;
+    }
+    return BatchParser::Scalar;
+}
+
+const BatchParser kBatchParser = detectBatchParser();
+
+#endif // MAC_SIMD_X86
+
+} // namespace
+
+bool MacAddress::parse(std::string_view text, MacAddress& out) {
+    if (text.size() != kTextLength) {
+        return false;
+    }
+
+    const char separator = text[2];
+    if (separator != ':' && separator != '-') {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < 6; i++) {
+        const std::size_t pos = i * 3;
+        if (i > 0 && text[pos - 1] != separator) {
+            return false;
+        }
+        uint8_t hi = kHex.value[static_cast<uint8_t>(text[pos])];
+        uint8_t lo = kHex.value[static_cast<uint8_t>(text[pos + 1])];
+        if ((hi | lo) & 0xF0) {
+            return false;
+        }
+        value = (value << 8) | static_cast<uint64_t>((hi << 4) | lo);
+    }
+
+    out = MacAddress(value);
+    return true;
+}
+
+std::size_t MacAddress::parseBatch(const std::string_view* texts, std::size_t count,
+                                   MacAddress* out, bool* valid) {
+    std::size_t parsed = 0;
+    auto scalar = [&](std::size_t i) {
+        const bool ok = parse(texts[i], out[i]);
+        if (!ok) {
+            out[i] = MacAddress();
+        }
+        if (valid) {
+            valid[i] = ok;
+        }
+        parsed += ok;
+    };
+#ifdef MAC_SIMD_X86
+    // Vector paths only see exactly 17 characters, so every load is in bounds
+    auto store = [&](std::size_t i, bool ok, uint64_t value) {
+        out[i] = MacAddress(ok ? value : 0);
+        if (valid) {
+            valid[i] = ok;
+        }
+        parsed += ok;
+    };
+    std::size_t i = 0;
+    if (kBatchParser == BatchParser::Avx2) {
+        for (; i + 1 < count; i += 2) {
+            if (texts[i].size() != kTextLength || texts[i + 1].size() != kTextLength) {
+                scalar(i);
+                scalar(i + 1);
+                continue;
+            }
+            uint64_t first, second;
+            const int ok = parseAvx2Pair(texts[i].data(), texts[i + 1].data(), first, second);
+            store(i, ok & 1, first);
+            store(i + 1, ok & 2, second);
+        }
+    }
+    if (kBatchParser != BatchParser::Scalar) {
+        for (; i < count; i++) {
+            if (texts[i].size() != kTextLength) {
+                scalar(i);
+                continue;
+            }
+            uint64_t value;
+            const bool ok = parseSse41(texts[i].data(), value);
+            store(i, ok, value);
+        }
+    }
+    for (; i < count; i++) {
+        scalar(i);
+    }
+#else
+    for (std::size_t i = 0; i < count; i++) {
+        scalar(i);
+    }
+#endif
+    return parsed;
+}
+
+const char* MacAddress::batchParser() {
+#ifdef MAC_SIMD_X86
+    switch (kBatchParser) {
+    case BatchParser::Avx2:
+        return "avx2";
+    case BatchParser::Sse41:
+        return "sse4.1";
+    default:
+        break;
+    }
+#endif
+    return "scalar";
+}
+
+void MacAddress::classifyBatch(const MacAddress* macs, std::size_t count, uint8_t* flags) {
+    for (std::size_t i = 0; i < count; i++) {
+        flags[i] = macs[i].flags();
+    }
+}
+
+MacAddress MacAddress::fromString(std::string_view text) {
+    MacAddress mac;
+    if (!parse(text, mac)) {
+        throw std::invalid_argument("invalid MAC address: " + std::string(text));
+    }
+    return mac;
+}
+
+void MacAddress::format(char* out) const {
+    for (int i = 0; i < 6; i++) {
+        const uint8_t octet = static_cast<uint8_t>(bits >> (40 - 8 * i));
+        out[i * 3] = kDigits[octet >> 4];
+        out[i * 3 + 1] = kDigits[octet & 0x0F];
+        if (i < 5) {
+            out[i * 3 + 2] = ':';
+        }
+    }
+}
+
+std::string MacAddress::toString() const {
+    std::string text(kTextLength, '\0');
+    format(&text[0]);
+    return text;
+}
+
+std::ostream& operator<<(std::ostream& os, MacAddress mac) {
+    char text[MacAddress::kTextLength];
+    mac.format(text);
+    return os << std::string_view(text, MacAddress::kTextLength);
+}
@@ -0,0 +1,170 @@
+#ifndef MAC_ADDRESS_H
+#define MAC_ADDRESS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A 48-bit Ethernet MAC address packed into a 64-bit integer
+ *
+ * The six octets are stored in transmission order in the low 48 bits, so the
+ * first octet ("AA" in "AA:BB:CC:DD:EE:FF") occupies bits 40-47. Comparing,
+ * copying and hashing an address is a single integer operation, which keeps
+ * the per-frame cost of table lookups independent of the text representation.
+ */
+class MacAddress {
+public:
+    static constexpr uint64_t kMask = 0xFFFFFFFFFFFFULL;   // Low 48 bits
+    static constexpr std::size_t kTextLength = 17;          // "AA:BB:CC:DD:EE:FF"
+
+    // Bits returned by flags()
+    static constexpr uint8_t kGroupFlag = 0x01;         // I/G bit: multicast or broadcast
+    static constexpr uint8_t kLocalFlag = 0x02;         // U/L bit: locally administered
+    static constexpr uint8_t kBroadcastFlag = 0x04;     // FF:FF:FF:FF:FF:FF
+
+    constexpr MacAddress() : bits(0) {}
+    constexpr explicit MacAddress(uint64_t value) : bits(value & kMask) {}
+
+    /**
+     * @brief Parses a colon (or dash) separated MAC address
+     *
+     * Accepts exactly six two-digit hex octets, upper or lower case.
+     *
+     * @param text Address text, e.g. "AA:BB:CC:DD:EE:FF"
+     * @param out Receives the parsed address on success
+     * @return true if the text was a well-formed MAC address
+     */
+    static bool parse(std::string_view text, MacAddress& out);
+
+    /**
+     * @brief Parses a MAC address, throwing on malformed input
+     *
+     * @throws std::invalid_argument if the text is not a valid MAC address
+     */
+    static MacAddress fromString(std::string_view text);
+
+    /**
+     * @brief Parses many addresses in one pass
+     *
+     * Accepts the same text as parse(). Well-formed 17-character addresses
+     * are decoded with SSE4.1 (one at a time) or AVX2 (two at
+     * a time) when the CPU has them, checking every digit and separator with
+     * vector compares instead of per-character branches; anything else takes
+     * the scalar path.
+     *
+     * @param texts Address texts
+     * @param count Number of texts
+     * @param out Receives one address per text (zero for malformed ones)
+     * @param valid If not null, receives true or false per text
+     * @return Number of texts that were well-formed
+     */
+    static std::size_t parseBatch(const std::string_view* texts, std::size_t count,
+                                  MacAddress* out, bool* valid = nullptr);
+
+    /**
+     * @brief Instruction set parseBatch() uses on this CPU ("avx2", "sse4.1" or "scalar")
+     */
+    static const char* batchParser();
+
+    /**
+     * @brief Reads six octets in transmission order, e.g. from a frame header
+     *
+     * @param octets Pointer to at least six bytes
+     */
+    static constexpr MacAddress fromBytes(const uint8_t* octets) {
+        return MacAddress((uint64_t(octets[0]) << 40) | (uint64_t(octets[1]) << 32) |
+                          (uint64_t(octets[2]) << 24) | (uint64_t(octets[3]) << 16) |
+                          (uint64_t(octets[4]) << 8) | uint64_t(octets[5]));
+    }
+
+    /**
+     * @brief Writes the six octets in transmission order
+     *
+     * @param out Buffer of at least six bytes
+     */
+    void toBytes(uint8_t* out) const {
+        for (int i = 0; i < 6; i++) {
+            out[i] = static_cast<uint8_t>(bits >> (40 - 8 * i));
+        }
+    }
+
+    /**
+     * @brief The all-ones broadcast address FF:FF:FF:FF:FF:FF
+     */
+    static constexpr MacAddress broadcast() { return MacAddress(kMask); }
+
+    /**
+     * @brief Writes the canonical "AA:BB:CC:DD:EE:FF" form
+     *
+     * @param out Buffer of at least kTextLength characters (not terminated)
+     */
+    void format(char* out) const;
+
+    /**
+     * @brief Returns the canonical upper-case text representation
+     */
+    std::string toString() const;
+
+    constexpr uint64_t toUint64() const { return bits; }
+
+    constexpr bool isBroadcast() const { return bits == kMask; }
+
+    // I/G bit: least significant bit of the first octet
+    constexpr bool isMulticast() const { return (bits >> 40) & 0x01; }
+
+    // U/L bit: second least significant bit of the first octet
+    constexpr bool isLocallyAdministered() const { return (bits >> 40) & 0x02; }
+
+    /**
+     * @brief Broadcast, group and local bits at once, without branches
+     *
+     * The I/G and U/L bits are the low two bits of the first octet, so they
+     * map straight onto kGroupFlag and kLocalFlag.
+     */
+    constexpr uint8_t flags() const {
+        return static_cast<uint8_t>(((bits >> 40) & 0x03) | (static_cast<uint8_t>(bits == kMask) << 2));
+    }
+
+    /**
+     * @brief Computes flags() for many addresses (a loop compilers vectorize)
+     */
+    static void classifyBatch(const MacAddress* macs, std::size_t count, uint8_t* flags);
+
+    /**
+     * @brief Mixes the address bits into a well-distributed hash
+     *
+     * Vendor OUIs make the upper octets highly repetitive, so the raw value
+     * is a poor bucket index; a multiplicative mix spreads all 48 bits.
+     */
+    constexpr uint64_t hash() const {
+        uint64_t h = bits * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 29);
+    }
+
+    constexpr bool operator==(const MacAddress& other) const { return bits == other.bits; }
+    constexpr bool operator!=(const MacAddress& other) const { return bits != other.bits; }
+    constexpr bool operator<(const MacAddress& other) const { return bits < other.bits; }
+
+private:
+    uint64_t bits;
+};
+
+/**
+ * @brief Streams the canonical "AA:BB:CC:DD:EE:FF" form
+ */
+std::ostream& operator<<(std::ostream& os, MacAddress mac);
+
+namespace std {
+template <>
+struct hash<MacAddress> {
+    std::size_t operator()(const MacAddress& mac) const noexcept {
+        return static_cast<std::size_t>(mac.hash());
+    }
+};
+} // namespace std
+
+#endif // MAC_ADDRESS_H
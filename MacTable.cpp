@@ -0,0 +1,53 @@
+#include "MacTable.h"
+#include <stdexcept>
+#include "CompactMacTable.h"
+#include "ConcurrentMacTable.h"
+#include "FlatMacTable.h"
+#include "HashMacTable.h"
+
+namespace {
+
+/**
+ * @brief Distinct home slots of one MAC on VLANs 1..vlans, in a table indexed
+ *        by hash() & (slots - 1) as FlatMacTable and ConcurrentMacTable are
+ */
+constexpr int homeSlotsAcrossVlans(int vlans, std::size_t slots) {
+    bool used[4096] = {};
+    int distinct = 0;
+    for (int vlan = 1; vlan <= vlans; vlan++) {
+        const FdbKey key(MacAddress(0x001122334455ULL), static_cast<uint16_t>(vlan));
+        const std::size_t slot = static_cast<std::size_t>(key.hash()) & (slots - 1);
+        if (!used[slot]) {
+            used[slot] = true;
+            distinct++;
+        }
+    }
+    return distinct;
+}
+
+// Keys that differ only in VID must not share a home slot. Uniform hashing
+// gives about 2589 distinct slots for 4094 keys in 4096, and 62 for 64 in 1024.
+static_assert(homeSlotsAcrossVlans(FdbKey::kMaxVlan, 4096) > 2400,
+              "FdbKey::hash: VLAN bits do not reach the low bits of the hash");
+static_assert(homeSlotsAcrossVlans(64, 1024) >= 56,
+              "FdbKey::hash: VLAN bits do not reach the low bits of the hash");
+
+} // namespace
+
+std::unique_ptr<MacTable> MacTable::create(TableEngine engine, std::size_t capacity,
+                                           EvictionPolicy eviction) {
+    switch (engine) {
+        case TableEngine::Concurrent:
+            if (eviction != EvictionPolicy::NoLearn) {
+                throw std::invalid_argument("MacTable: the concurrent engine cannot evict entries");
+            }
+            return std::make_unique<ConcurrentMacTable>(capacity);
+        case TableEngine::Compact:
+            return std::make_unique<CompactMacTable>(capacity, eviction);
+        case TableEngine::Flat:
+            return std::make_unique<FlatMacTable>(capacity, eviction);
+        case TableEngine::Hash:
+        default:
+            return std::make_unique<HashMacTable>(capacity, eviction);
+    }
+}
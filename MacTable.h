@@ -0,0 +1,212 @@
+#ifndef MAC_TABLE_H
+#define MAC_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "FdbKey.h"
+#include "MacAddress.h"
+#include "PortMask.h"
+
+/**
+ * @brief Selects the data structure backing a switch's forwarding table
+ */
+enum class TableEngine {
+    Hash,       // Node-based std::unordered_map, grows without bound
+    Flat,       // Fixed-capacity open-addressing table (CAM-like)
+    Concurrent, // Flat layout safe for concurrent workers (ParallelSwitch)
+    Compact     // One 16-byte record per slot and no per-port lists, for large populations
+};
+
+/**
+ * @brief What a table at capacity does with a new source address
+ */
+enum class EvictionPolicy {
+    NoLearn,    // Refuse to learn it (frames to it keep flooding), as most CAMs do
+    LRU,        // Replace the entry seen least recently
+    Clock       // Replace an entry not seen since the CLOCK hand last passed (approximate LRU)
+};
+
+/**
+ * @brief Time base used for entry timestamps and the aging timeout
+ */
+enum class AgingClock {
+    WallClock,  // Whole seconds of steady_clock time since the switch started
+    Logical     // Simulation cycles, advanced explicitly via Switch::advanceCycle()
+};
+
+/**
+ * @brief One learned station in the MAC address table
+ */
+struct MACTableEntry {
+    MacAddress mac;         // Learned source address
+    int port;               // Port number where MAC was learned
+    uint32_t timestamp;     // Last seen time (for aging), in AgingClock units
+    uint16_t vlan;          // VLAN the address was learned in
+
+    FdbKey key() const { return FdbKey(mac, vlan); }
+};
+
+/**
+ * @brief What a learn operation did to the table
+ */
+enum class LearnResult {
+    Learned,    // New entry inserted
+    Moved,      // Existing entry re-pointed to a different port
+    Refreshed,  // Existing entry seen again on the same port
+    TableFull   // No room for a new entry; nothing was learned
+};
+
+struct LearnOutcome {
+    LearnResult result;
+    int previousPort;   // Port before a move, otherwise the learned port
+    FdbKey evictedKey;  // Entry a Learned one replaced, if evictedPort is not -1
+    int evictedPort = -1;
+
+    LearnOutcome() = default;
+    LearnOutcome(LearnResult result, int previousPort) : result(result), previousPort(previousPort) {}
+
+    bool evicted() const { return evictedPort != -1; }
+};
+
+/**
+ * @brief Heap memory held by a table engine
+ *
+ * Bytes are what the engine has allocated, counting spare capacity and its
+ * per-port and eviction indexes, so bytesPerEntry() is the real cost of a
+ * learned station rather than sizeof an entry.
+ */
+struct MemoryUsage {
+    std::size_t bytes = 0;      // Allocated bytes
+    std::size_t slots = 0;      // Entry slots allocated (buckets for a node-based table)
+    std::size_t entries = 0;    // Entries stored
+
+    double bytesPerEntry() const { return entries ? static_cast<double>(bytes) / entries : 0.0; }
+    double loadFactor() const { return slots ? static_cast<double>(entries) / slots : 0.0; }
+};
+
+/**
+ * @brief Interface for MAC forwarding table engines
+ *
+ * The switch only talks to its table through this interface, so engines with
+ * very different memory layouts can be swapped at construction time and
+ * benchmarked against each other under the same traffic. Entries are keyed by
+ * (VLAN, MAC); passing a bare MacAddress uses the default VLAN.
+ */
+class MacTable {
+public:
+    // Last-seen stamp; unsigned so age computations survive wrap-around
+    using Timestamp = uint32_t;
+
+    // Returned by lookup() when the address is not in the table
+    static constexpr int kNoPort = -1;
+
+    virtual ~MacTable() = default;
+
+    /**
+     * @brief Inserts, moves or refreshes the entry for a source address
+     *
+     * @param key Source MAC address of the frame and its VLAN
+     * @param port Port the frame arrived on
+     * @param now Timestamp recorded as the entry's last-seen time
+     */
+    virtual LearnOutcome learn(FdbKey key, int port, Timestamp now) = 0;
+
+    /**
+     * @brief Returns the port an address was learned on, or kNoPort
+     */
+    virtual int lookup(FdbKey key) const = 0;
+
+    /**
+     * @brief Copies the full entry for an address
+     *
+     * @return true if the address is in the table
+     */
+    virtual bool find(FdbKey key, MACTableEntry& out) const = 0;
+
+    /**
+     * @brief Removes one address
+     *
+     * @return true if an entry was removed
+     */
+    virtual bool erase(FdbKey key) = 0;
+
+    /**
+     * @brief Removes every entry matching a predicate
+     *
+     * @return Number of entries removed
+     */
+    virtual std::size_t eraseIf(const std::function<bool(const MACTableEntry&)>& predicate) = 0;
+
+    /**
+     * @brief Removes every entry learned on any of a set of ports
+     *
+     * @return Number of entries removed
+     */
+    virtual std::size_t erasePorts(const PortMask& ports) {
+        return eraseIf([&ports](const MACTableEntry& entry) { return ports.test(entry.port); });
+    }
+
+    /**
+     * @brief Number of entries currently learned on a port
+     */
+    virtual std::size_t portCount(int port) const = 0;
+
+    /**
+     * @brief Visits every entry in unspecified order
+     */
+    virtual void forEach(const std::function<void(const MACTableEntry&)>& visit) const = 0;
+
+    virtual void clear() = 0;
+
+    virtual std::size_t size() const = 0;
+
+    /**
+     * @brief Maximum number of entries, or 0 if the table is unbounded
+     */
+    virtual std::size_t capacity() const = 0;
+
+    /**
+     * @brief What learn() does once size() reaches capacity()
+     */
+    virtual EvictionPolicy eviction() const { return EvictionPolicy::NoLearn; }
+
+    /**
+     * @brief Hints that an address will be looked up soon
+     *
+     * Engines with a predictable bucket location pull it into cache so that a
+     * burst of lookups overlaps its memory latency.
+     */
+    virtual void prefetch(FdbKey /*key*/) const {}
+
+    /**
+     * @brief Hints that the table is about to hold this many entries
+     *
+     * Engines that grow make room up front so a bulk load does not rehash.
+     */
+    virtual void reserve(std::size_t /*entries*/) {}
+
+    /**
+     * @brief Heap memory the table currently holds
+     */
+    virtual MemoryUsage memoryUsage() const = 0;
+
+    /**
+     * @brief Short engine name for diagnostics ("hash", "flat", "concurrent", "compact")
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Creates a table engine
+     *
+     * @param engine Which implementation to use
+     * @param capacity Maximum entries (0 = engine default)
+     * @param eviction What a full table does with new addresses
+     * @throws std::invalid_argument if the engine does not support the eviction policy
+     */
+    static std::unique_ptr<MacTable> create(TableEngine engine, std::size_t capacity = 0,
+                                            EvictionPolicy eviction = EvictionPolicy::NoLearn);
+};
+
+#endif // MAC_TABLE_H
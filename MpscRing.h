@@ -0,0 +1,108 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free queue for any number of producers and one consumer
+ *
+ * Each slot carries a sequence number saying whose turn it is (Vyukov's
+ * bounded queue). A producer claims a position with one CAS on the shared
+ * tail, writes the item and then publishes it by advancing the slot's
+ * sequence; the consumer alone owns the head and takes a slot once its
+ * sequence shows it published. A full ring makes tryPush() fail at once, so
+ * producers never wait. A producer descheduled between its claim and its
+ * publish holds up the consumer (not the other producers) until it resumes.
+ *
+ * A slot is one cache line when sizeof(T) is 56 bytes, so producers filling
+ * neighbouring slots do not share lines.
+ *
+ * @tparam T Trivially copyable element type
+ */
+template <typename T>
+class MpscRing {
+public:
+    /**
+     * @param capacity Minimum number of slots (rounded up to a power of two)
+     */
+    explicit MpscRing(std::size_t capacity) {
+        std::size_t count = 2;
+        while (count < capacity) {
+            count <<= 1;
+        }
+        slots.reset(new Slot[count]);
+        for (std::size_t i = 0; i < count; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = count - 1;
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Producer side, any thread: appends one item
+     *
+     * @return false if the ring is full
+     */
+    bool tryPush(const T& item) {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[position & mask];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const int64_t lag = static_cast<int64_t>(sequence - position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;       // The consumer has not freed this slot yet
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Consumer side: removes the oldest published item
+     *
+     * @return false if the ring is empty (or its oldest item is not published yet)
+     */
+    bool tryPop(T& item) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        item = slot.item;
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    /**
+     * @brief Positions claimed by producers so far (items pushed, published or not)
+     */
+    uint64_t claimed() const { return tail.load(std::memory_order_acquire); }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;     // position + 1 once published, position + capacity once freed
+        T item;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    // Producers' shared index and the consumer's own, on separate cache lines
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) uint64_t head = 0;
+};
+
+#endif // MPSC_RING_H
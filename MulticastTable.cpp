@@ -0,0 +1,417 @@
+#include "MulticastTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// IP protocol numbers and message types
+constexpr uint8_t kProtocolIgmp = 2;
+constexpr uint8_t kNextHopByHop = 0;
+constexpr uint8_t kNextDestOptions = 60;
+constexpr uint8_t kNextIcmpV6 = 58;
+
+constexpr uint8_t kIgmpQuery = 0x11;
+constexpr uint8_t kIgmpV1Report = 0x12;
+constexpr uint8_t kIgmpV2Report = 0x16;
+constexpr uint8_t kIgmpLeave = 0x17;
+constexpr uint8_t kIgmpV3Report = 0x22;
+
+constexpr uint8_t kMldQuery = 130;
+constexpr uint8_t kMldReport = 131;
+constexpr uint8_t kMldDone = 132;
+constexpr uint8_t kMldV2Report = 143;
+
+// IGMPv3/MLDv2 group record types (RFC 3376 4.2.12)
+constexpr uint8_t kModeIsInclude = 1;
+constexpr uint8_t kModeIsExclude = 2;
+constexpr uint8_t kChangeToInclude = 3;
+constexpr uint8_t kChangeToExclude = 4;
+constexpr uint8_t kAllowNewSources = 5;
+
+constexpr uint32_t kAllHosts = 0xE0000001;      // 224.0.0.1
+constexpr uint32_t kAllRouters = 0xE0000002;    // 224.0.0.2
+
+uint16_t read16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t read32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+void write16(std::string& out, std::size_t offset, uint16_t value) {
+    out[offset] = static_cast<char>(value >> 8);
+    out[offset + 1] = static_cast<char>(value & 0xFF);
+}
+
+void write32(std::string& out, std::size_t offset, uint32_t value) {
+    write16(out, offset, static_cast<uint16_t>(value >> 16));
+    write16(out, offset + 2, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+// Ones' complement sum of 16-bit words, as in the IP checksums
+uint32_t sumWords(const std::string& data, std::size_t offset, std::size_t length, uint32_t sum = 0) {
+    for (std::size_t i = 0; i + 1 < length; i += 2) {
+        sum += read16(reinterpret_cast<const uint8_t*>(data.data()) + offset + i);
+    }
+    if (length % 2) {
+        sum += static_cast<uint8_t>(data[offset + length - 1]) << 8;
+    }
+    return sum;
+}
+
+uint16_t foldChecksum(uint32_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+// Groups every port must receive: 224.0.0.0/24 (IPv4 local network control)
+bool snoopable(uint32_t group) {
+    return (group >> 28) == 0xE && (group >> 8) != 0xE00000;
+}
+
+// Interface- and link-local all-nodes scopes must reach every port
+bool snoopable(const uint8_t* group) {
+    static const uint8_t kAllNodes[16] = {0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    return group[0] == 0xFF && (group[1] & 0x0F) > 1 && std::memcmp(group, kAllNodes, 16) != 0;
+}
+
+// Whether a v3 group record keeps the group wanted (RFC 3376 6.4)
+bool recordJoins(uint8_t type, uint16_t sources) {
+    return type == kModeIsExclude || type == kChangeToExclude ||
+           ((type == kModeIsInclude || type == kAllowNewSources) && sources > 0);
+}
+
+bool recordLeaves(uint8_t type, uint16_t sources) {
+    return type == kChangeToInclude && sources == 0;
+}
+
+using Apply = std::function<void(MacAddress group, bool join)>;
+
+MembershipMessage parseIgmp(const uint8_t* p, std::size_t length, const Apply& apply) {
+    if (length < 8) {
+        return MembershipMessage::None;
+    }
+    const uint32_t group = read32(p + 4);
+    switch (p[0]) {
+        case kIgmpQuery:
+            return MembershipMessage::Query;
+        case kIgmpV1Report:
+        case kIgmpV2Report:
+            if (snoopable(group)) {
+                apply(MulticastTable::groupMac(group), true);
+            }
+            return MembershipMessage::Report;
+        case kIgmpLeave:
+            if (snoopable(group)) {
+                apply(MulticastTable::groupMac(group), false);
+            }
+            return MembershipMessage::Leave;
+        case kIgmpV3Report: {
+            // Records: type, aux words, source count, group, sources, aux data
+            const uint16_t records = read16(p + 6);
+            std::size_t offset = 8;
+            bool joined = false;
+            for (uint16_t i = 0; i < records && offset + 8 <= length; i++) {
+                const uint8_t* record = p + offset;
+                const uint16_t sources = read16(record + 2);
+                const uint32_t recordGroup = read32(record + 4);
+                if (snoopable(recordGroup)) {
+                    if (recordJoins(record[0], sources)) {
+                        apply(MulticastTable::groupMac(recordGroup), true);
+                        joined = true;
+                    } else if (recordLeaves(record[0], sources)) {
+                        apply(MulticastTable::groupMac(recordGroup), false);
+                    }
+                }
+                offset += 8 + 4 * std::size_t(sources) + 4 * std::size_t(record[1]);
+            }
+            return joined || records == 0 ? MembershipMessage::Report : MembershipMessage::Leave;
+        }
+        default:
+            return MembershipMessage::None;
+    }
+}
+
+MembershipMessage parseMld(const uint8_t* p, std::size_t length, const Apply& apply) {
+    if (length < 8) {
+        return MembershipMessage::None;
+    }
+    switch (p[0]) {
+        case kMldQuery:
+            return MembershipMessage::Query;
+        case kMldReport:
+        case kMldDone:
+            if (length < 24) {
+                return MembershipMessage::None;
+            }
+            if (snoopable(p + 8)) {
+                apply(MulticastTable::groupMac(p + 8), p[0] == kMldReport);
+            }
+            return p[0] == kMldReport ? MembershipMessage::Report : MembershipMessage::Leave;
+        case kMldV2Report: {
+            const uint16_t records = read16(p + 6);
+            std::size_t offset = 8;
+            bool joined = false;
+            for (uint16_t i = 0; i < records && offset + 20 <= length; i++) {
+                const uint8_t* record = p + offset;
+                const uint16_t sources = read16(record + 2);
+                if (snoopable(record + 4)) {
+                    if (recordJoins(record[0], sources)) {
+                        apply(MulticastTable::groupMac(record + 4), true);
+                        joined = true;
+                    } else if (recordLeaves(record[0], sources)) {
+                        apply(MulticastTable::groupMac(record + 4), false);
+                    }
+                }
+                offset += 20 + 16 * std::size_t(sources) + 4 * std::size_t(record[1]);
+            }
+            return joined || records == 0 ? MembershipMessage::Report : MembershipMessage::Leave;
+        }
+        default:
+            return MembershipMessage::None;
+    }
+}
+
+// Ethernet payload of an IPv4 packet carrying IGMP, with the Router Alert
+// option of RFC 2236 and both checksums filled in
+std::string ipv4Igmp(uint32_t destination, uint8_t type, uint32_t group) {
+    constexpr std::size_t kIpLength = 24;
+    std::string packet(kIpLength + 8, '\0');
+    packet[0] = 0x46;                               // Version 4, 6 words
+    write16(packet, 2, static_cast<uint16_t>(packet.size()));
+    packet[8] = 1;                                  // TTL
+    packet[9] = static_cast<char>(kProtocolIgmp);
+    write32(packet, 12, 0xC0A80001);                // 192.168.0.1; snooping ignores it
+    write32(packet, 16, destination);
+    write32(packet, 20, 0x94040000);                // Router Alert
+    write16(packet, 10, foldChecksum(sumWords(packet, 0, kIpLength)));
+    packet[kIpLength] = static_cast<char>(type);
+    packet[kIpLength + 1] = type == kIgmpQuery ? 100 : 0;   // Max response time (10 s)
+    write32(packet, kIpLength + 4, group);
+    write16(packet, kIpLength + 2, foldChecksum(sumWords(packet, kIpLength, 8)));
+    return packet;
+}
+
+} // namespace
+
+MulticastTable::MulticastTable(uint32_t timeout) : timeout(timeout) {}
+
+MembershipMessage MulticastTable::parse(const FrameView& frame, const Apply& apply) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(frame.payload.data());
+    const std::size_t length = frame.payload.size();
+
+    if (frame.etherType == EtherType::kIPv4) {
+        if (length < 20 || (p[0] >> 4) != 4 || p[9] != kProtocolIgmp) {
+            return MembershipMessage::None;
+        }
+        const std::size_t header = std::size_t(p[0] & 0x0F) * 4;
+        if (header < 20 || header > length || (read16(p + 6) & 0x1FFF) != 0) {
+            return MembershipMessage::None;     // Malformed, or a later fragment
+        }
+        const std::size_t total = std::min<std::size_t>(read16(p + 2), length);
+        return total > header ? parseIgmp(p + header, total - header, apply) : MembershipMessage::None;
+    }
+
+    if (frame.etherType == EtherType::kIPv6) {
+        if (length < 40 || (p[0] >> 4) != 6) {
+            return MembershipMessage::None;
+        }
+        // MLD follows a Hop-by-Hop header carrying Router Alert
+        uint8_t next = p[6];
+        std::size_t offset = 40;
+        while ((next == kNextHopByHop || next == kNextDestOptions) && offset + 8 <= length) {
+            next = p[offset];
+            offset += (std::size_t(p[offset + 1]) + 1) * 8;
+        }
+        if (next != kNextIcmpV6 || offset >= length) {
+            return MembershipMessage::None;
+        }
+        return parseMld(p + offset, length - offset, apply);
+    }
+    return MembershipMessage::None;
+}
+
+MembershipMessage MulticastTable::snoop(const FrameView& frame, uint16_t vlan, int port, Timestamp now) {
+    const MembershipMessage message = parse(frame, [&](MacAddress group, bool join) {
+        if (join) {
+            this->join(FdbKey(group, vlan), port, now);
+        } else {
+            leave(FdbKey(group, vlan), port);
+        }
+    });
+    if (message == MembershipMessage::Query) {
+        addRouterPort(vlan, port, now);
+    }
+    return message;
+}
+
+bool MulticastTable::join(FdbKey group, int port, Timestamp now, bool permanent) {
+    auto found = groups.find(group);
+    if (found == groups.end()) {
+        found = groups.emplace(group, Group{}).first;
+        found->second.egress = routerPorts(group.vlan());
+    }
+    Group& entry = found->second;
+    for (Member& member : entry.ports) {
+        if (member.port == port) {
+            // A report refreshes the entry; it never demotes a static one
+            member.lastSeen = now;
+            member.permanent = member.permanent || permanent;
+            return false;
+        }
+    }
+    entry.ports.push_back(Member{port, permanent, now});
+    entry.members.set(port);
+    entry.egress.set(port);
+    return true;
+}
+
+bool MulticastTable::leave(FdbKey group, int port) {
+    auto found = groups.find(group);
+    if (found == groups.end()) {
+        return false;
+    }
+    Group& entry = found->second;
+    auto member = std::find_if(entry.ports.begin(), entry.ports.end(),
+                               [port](const Member& m) { return m.port == port; });
+    if (member == entry.ports.end()) {
+        return false;
+    }
+    entry.ports.erase(member);
+    if (entry.ports.empty()) {
+        groups.erase(found);
+        return true;
+    }
+    entry.members.reset(port);
+    entry.egress = entry.members | routerPorts(group.vlan());
+    return true;
+}
+
+void MulticastTable::addRouterPort(uint16_t vlan, int port, Timestamp now, bool permanent) {
+    Routers& entry = routers[vlan];
+    for (Member& record : entry.records) {
+        if (record.port == port) {
+            record.lastSeen = now;
+            record.permanent = record.permanent || permanent;
+            return;
+        }
+    }
+    entry.records.push_back(Member{port, permanent, now});
+    entry.ports.set(port);
+    refreshEgress(vlan);
+}
+
+PortMask MulticastTable::routerPorts(uint16_t vlan) const {
+    auto it = routers.find(vlan);
+    return it == routers.end() ? PortMask() : it->second.ports;
+}
+
+void MulticastTable::refreshEgress(uint16_t vlan) {
+    const PortMask routing = routerPorts(vlan);
+    for (auto& [key, group] : groups) {
+        if (key.vlan() == vlan) {
+            group.egress = group.members | routing;
+        }
+    }
+}
+
+std::size_t MulticastTable::expire(Timestamp now) {
+    if (timeout == 0) {
+        return 0;
+    }
+    std::size_t removed = 0;
+    for (auto& [vlan, entry] : routers) {
+        const std::size_t before = entry.records.size();
+        entry.records.erase(std::remove_if(entry.records.begin(), entry.records.end(),
+                                           [&](const Member& m) { return expired(m, now); }),
+                            entry.records.end());
+        if (entry.records.size() != before) {
+            removed += before - entry.records.size();
+            entry.ports = PortMask();
+            for (const Member& record : entry.records) {
+                entry.ports.set(record.port);
+            }
+            refreshEgress(vlan);
+        }
+    }
+    for (auto it = groups.begin(); it != groups.end(); ) {
+        Group& group = it->second;
+        const std::size_t before = group.ports.size();
+        group.ports.erase(std::remove_if(group.ports.begin(), group.ports.end(),
+                                         [&](const Member& m) { return expired(m, now); }),
+                          group.ports.end());
+        removed += before - group.ports.size();
+        if (group.ports.empty()) {
+            it = groups.erase(it);
+            continue;
+        }
+        if (group.ports.size() != before) {
+            group.members = PortMask();
+            for (const Member& member : group.ports) {
+                group.members.set(member.port);
+            }
+            group.egress = group.members | routerPorts(it->first.vlan());
+        }
+        ++it;
+    }
+    return removed;
+}
+
+void MulticastTable::clear() {
+    groups.clear();
+    routers.clear();
+}
+
+void MulticastTable::forEach(const std::function<void(FdbKey group, const PortMask& members)>& visit) const {
+    for (const auto& [key, group] : groups) {
+        visit(key, group.members);
+    }
+}
+
+Frame MulticastTable::igmpReport(MacAddress host, uint32_t group) {
+    return Frame(host, groupMac(group), EtherType::kIPv4, ipv4Igmp(group, kIgmpV2Report, group));
+}
+
+Frame MulticastTable::igmpLeave(MacAddress host, uint32_t group) {
+    return Frame(host, groupMac(kAllRouters), EtherType::kIPv4, ipv4Igmp(kAllRouters, kIgmpLeave, group));
+}
+
+Frame MulticastTable::igmpQuery(MacAddress router) {
+    return Frame(router, groupMac(kAllHosts), EtherType::kIPv4, ipv4Igmp(kAllHosts, kIgmpQuery, 0));
+}
+
+Frame MulticastTable::mldReport(MacAddress host, const uint8_t group[16], bool done) {
+    static const uint8_t kAllRoutersV6[16] = {0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2};
+    const uint8_t* destination = done ? kAllRoutersV6 : group;
+
+    // IPv6 header, Hop-by-Hop header with Router Alert, then the 24-byte MLD message
+    constexpr std::size_t kIcmp = 48;
+    std::string packet(kIcmp + 24, '\0');
+    packet[0] = 0x60;
+    write16(packet, 4, 8 + 24);                     // Payload length
+    packet[6] = static_cast<char>(kNextHopByHop);
+    packet[7] = 1;                                  // Hop limit
+    // Link-local source derived from the host MAC (modified EUI-64)
+    uint8_t address[6];
+    host.toBytes(address);
+    const uint8_t source[16] = {0xFE, 0x80, 0, 0, 0, 0, 0, 0,
+                                static_cast<uint8_t>(address[0] ^ 0x02), address[1], address[2], 0xFF,
+                                0xFE, address[3], address[4], address[5]};
+    std::memcpy(&packet[8], source, 16);
+    std::memcpy(&packet[24], destination, 16);
+    packet[40] = static_cast<char>(kNextIcmpV6);
+    packet[42] = 0x05;                              // Router Alert, 2 bytes, value 0 (MLD)
+    packet[43] = 0x02;
+    packet[46] = 0x01;                              // PadN, 0 bytes
+    packet[kIcmp] = static_cast<char>(done ? kMldDone : kMldReport);
+    std::memcpy(&packet[kIcmp + 8], group, 16);
+
+    // Checksum over the pseudo-header (addresses, length, next header) and the message
+    uint32_t sum = sumWords(packet, 8, 32);
+    sum += 24 + kNextIcmpV6;
+    write16(packet, kIcmp + 2, foldChecksum(sumWords(packet, kIcmp, 24, sum)));
+    return Frame(host, groupMac(destination), EtherType::kIPv6, packet);
+}
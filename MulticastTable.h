@@ -0,0 +1,200 @@
+#ifndef MULTICAST_TABLE_H
+#define MULTICAST_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "FdbKey.h"
+#include "Frame.h"
+#include "FrameView.h"
+#include "MacAddress.h"
+#include "MacTable.h"
+#include "PortMask.h"
+
+/**
+ * @brief What an IGMP or MLD message asks of a snooping switch
+ */
+enum class MembershipMessage {
+    None,       // Not a membership message (ordinary traffic)
+    Query,      // General or group query from a multicast router
+    Report,     // A host joined (or still wants) one or more groups
+    Leave       // A host left a group (IGMPv2 Leave, MLD Done, or a v3 record)
+};
+
+/**
+ * @brief Multicast group table filled by IGMP/MLD snooping
+ *
+ * Maps a (VLAN, group MAC) to the ports with listeners on it. Each group
+ * also holds its egress mask precomputed: the member ports plus the VLAN's
+ * multicast router ports, which receive every group. Forwarding a frame to
+ * a registered group is therefore one hash lookup and a mask with the
+ * VLAN's ports; the mask is rebuilt only when membership changes.
+ *
+ * Membership is learned from the frames themselves (snoop()) or configured
+ * statically (join()). Snooped members and router ports expire a timeout
+ * after their last report or query; static ones stay until removed.
+ * Leaves take effect at once ("fast leave"), without the group-specific
+ * query a router would send first.
+ *
+ * Like the MAC-based tables of L2 hardware, groups are tracked by MAC
+ * address: IPv4 groups that share their low 23 bits (and IPv6 groups that
+ * share their low 32) share one entry.
+ */
+class MulticastTable {
+public:
+    using Timestamp = MacTable::Timestamp;
+
+    /**
+     * @param timeout Lifetime of a snooped member or router port without a
+     *        report or query, in the switch's clock units (0 = never expire)
+     */
+    explicit MulticastTable(uint32_t timeout = 0);
+
+    /**
+     * @brief Applies any IGMP or MLD message in a frame
+     *
+     * Reports add the ingress port to their groups, leaves remove it, and
+     * queries make it a router port of the VLAN. Groups in the link-local
+     * control ranges (224.0.0.0/24, ff02::1) are never registered, since
+     * they must reach every port.
+     *
+     * @return What the frame was, so the switch can forward reports and
+     *         leaves to router ports only
+     */
+    MembershipMessage snoop(const FrameView& frame, uint16_t vlan, int port, Timestamp now);
+
+    /**
+     * @brief Egress ports of a registered group, or nullptr if it has none
+     */
+    const PortMask* lookup(FdbKey group) const {
+        auto it = groups.find(group);
+        return it == groups.end() ? nullptr : &it->second.egress;
+    }
+
+    /**
+     * @brief Adds a member port to a group
+     *
+     * @param permanent Static membership that never expires
+     * @return true if the port was not already a member
+     */
+    bool join(FdbKey group, int port, Timestamp now, bool permanent = false);
+
+    /**
+     * @brief Removes a member port from a group (the group goes once empty)
+     *
+     * @return true if the port was a member
+     */
+    bool leave(FdbKey group, int port);
+
+    /**
+     * @brief Marks a port as leading to a multicast router in a VLAN
+     */
+    void addRouterPort(uint16_t vlan, int port, Timestamp now, bool permanent = false);
+
+    /**
+     * @brief Router ports of a VLAN
+     */
+    PortMask routerPorts(uint16_t vlan) const;
+
+    /**
+     * @brief Drops snooped members and router ports not refreshed within the timeout
+     *
+     * @return Number of memberships (and router ports) removed
+     */
+    std::size_t expire(Timestamp now);
+
+    /**
+     * @brief Removes every group and router port
+     */
+    void clear();
+
+    /**
+     * @brief Number of registered groups
+     */
+    std::size_t size() const { return groups.size(); }
+
+    bool empty() const { return groups.empty(); }
+
+    /**
+     * @brief Visits every group with its member ports (not router ports)
+     */
+    void forEach(const std::function<void(FdbKey group, const PortMask& members)>& visit) const;
+
+    /**
+     * @brief Reads the membership message in a frame without applying it
+     *
+     * @param apply Called with each group MAC the message reports or leaves
+     *        (not called for queries)
+     */
+    static MembershipMessage parse(const FrameView& frame,
+                                   const std::function<void(MacAddress group, bool join)>& apply);
+
+    /**
+     * @brief Group MAC of an IPv4 group: 01:00:5E and the low 23 address bits
+     */
+    static MacAddress groupMac(uint32_t ipv4Group) {
+        return MacAddress(0x01005E000000ULL | (ipv4Group & 0x7FFFFF));
+    }
+
+    /**
+     * @brief Group MAC of an IPv6 group: 33:33 and the last 4 address bytes
+     */
+    static MacAddress groupMac(const uint8_t ipv6Group[16]) {
+        return MacAddress(0x333300000000ULL | (uint64_t(ipv6Group[12]) << 24) |
+                          (uint64_t(ipv6Group[13]) << 16) | (uint64_t(ipv6Group[14]) << 8) |
+                          ipv6Group[15]);
+    }
+
+    /**
+     * @brief An IGMPv2 Membership Report from a host for an IPv4 group
+     */
+    static Frame igmpReport(MacAddress host, uint32_t group);
+
+    /**
+     * @brief An IGMPv2 Leave Group message, sent to all routers (224.0.0.2)
+     */
+    static Frame igmpLeave(MacAddress host, uint32_t group);
+
+    /**
+     * @brief An IGMPv2 General Query from a router, sent to all hosts (224.0.0.1)
+     */
+    static Frame igmpQuery(MacAddress router);
+
+    /**
+     * @brief An MLDv1 Multicast Listener Report (or Done) for an IPv6 group
+     */
+    static Frame mldReport(MacAddress host, const uint8_t group[16], bool done = false);
+
+private:
+    struct Member {
+        int port;
+        bool permanent;
+        Timestamp lastSeen;
+    };
+
+    struct Group {
+        PortMask members;               // Ports with listeners
+        PortMask egress;                // members plus the VLAN's router ports
+        std::vector<Member> ports;      // One record per member port
+    };
+
+    struct Routers {
+        PortMask ports;
+        std::vector<Member> records;
+    };
+
+    uint32_t timeout;
+    std::unordered_map<FdbKey, Group> groups;
+    std::unordered_map<uint16_t, Routers> routers;   // By VLAN
+
+    // Rebuilds the egress masks of a VLAN's groups after its router ports change
+    void refreshEgress(uint16_t vlan);
+
+    bool expired(const Member& member, Timestamp now) const {
+        return !member.permanent && timeout > 0 && now - member.lastSeen >= timeout;
+    }
+};
+
+#endif // MULTICAST_TABLE_H
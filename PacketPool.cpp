@@ -0,0 +1,43 @@
+#include "PacketPool.h"
+#include <stdexcept>
+
+PacketPool::PacketPool(std::size_t bufferCount, std::size_t size)
+    : arena(new uint8_t[bufferCount * size]), bufferSize(size),
+      refCounts(bufferCount, 0), lengths(bufferCount, 0),
+      peakInUse(0), exhaustionDrops(0), oversizeDrops(0) {
+    if (bufferCount == 0 || bufferCount >= kInvalidHandle) {
+        throw std::invalid_argument("PacketPool: buffer count out of range");
+    }
+    if (size < FrameView::kHeaderLength || size > UINT16_MAX) {
+        throw std::invalid_argument("PacketPool: buffer size must be between 14 and 65535 bytes");
+    }
+
+    // Pushed in reverse so buffer 0 is handed out first
+    freeList.reserve(bufferCount);
+    for (std::size_t i = bufferCount; i-- > 0; ) {
+        freeList.push_back(static_cast<Handle>(i));
+    }
+}
+
+PacketPool::Handle PacketPool::allocate(const FrameView& frame, uint32_t references) {
+    const std::size_t length = frame.wireLength();
+    if (length > bufferSize) {
+        oversizeDrops++;
+        return kInvalidHandle;
+    }
+    if (freeList.empty()) {
+        exhaustionDrops++;
+        return kInvalidHandle;
+    }
+
+    const Handle handle = freeList.back();
+    freeList.pop_back();
+    frame.write(buffer(handle));
+    lengths[handle] = static_cast<uint16_t>(length);
+    refCounts[handle] = references;
+
+    if (getInUse() > peakInUse) {
+        peakInUse = getInUse();
+    }
+    return handle;
+}
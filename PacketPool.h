@@ -0,0 +1,102 @@
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "FrameView.h"
+
+/**
+ * @brief Fixed arena of reference-counted frame buffers
+ *
+ * All buffers are carved out of one allocation made at construction, so
+ * queuing a frame never calls malloc. A frame is copied into a buffer once;
+ * every egress queue it goes to holds a small descriptor naming that buffer
+ * and takes one reference. A flood to N ports therefore costs one copy and N
+ * descriptors, and the buffer returns to the free list when the last port
+ * has transmitted it.
+ *
+ * Free buffers are kept on a LIFO stack so the most recently released (and
+ * most likely cached) one is reused first.
+ */
+class PacketPool {
+public:
+    // Identifies a buffer in the pool
+    using Handle = uint32_t;
+
+    static constexpr Handle kInvalidHandle = ~0u;
+
+    // Holds a maximum-size untagged frame (1514 bytes without FCS) with room for a tag
+    static constexpr std::size_t kDefaultBufferSize = 1536;
+
+    /**
+     * @param bufferCount Number of buffers in the arena
+     * @param bufferSize Bytes per buffer (frames longer than this are refused)
+     */
+    explicit PacketPool(std::size_t bufferCount, std::size_t bufferSize = kDefaultBufferSize);
+
+    /**
+     * @brief Copies a frame into a free buffer
+     *
+     * @param frame Frame to store
+     * @param references Initial reference count (one per queue it goes to)
+     * @return The buffer, or kInvalidHandle if the pool is exhausted or the
+     *         frame does not fit in a buffer
+     */
+    Handle allocate(const FrameView& frame, uint32_t references);
+
+    /**
+     * @brief Adds references to a buffer that is still in use
+     */
+    void retain(Handle handle, uint32_t references = 1) {
+        refCounts[handle] += references;
+    }
+
+    /**
+     * @brief Drops one reference; the buffer is freed when none remain
+     */
+    void release(Handle handle) {
+        if (--refCounts[handle] == 0) {
+            freeList.push_back(handle);
+        }
+    }
+
+    /**
+     * @brief The stored frame; valid until its last reference is released
+     */
+    FrameView view(Handle handle) const {
+        FrameView frame;
+        FrameView::parse(buffer(handle), lengths[handle], frame);
+        return frame;
+    }
+
+    uint32_t getRefCount(Handle handle) const { return refCounts[handle]; }
+
+    std::size_t getCapacity() const { return refCounts.size(); }
+    std::size_t getBufferSize() const { return bufferSize; }
+    std::size_t getInUse() const { return refCounts.size() - freeList.size(); }
+    std::size_t getPeakInUse() const { return peakInUse; }
+
+    // Allocations refused because every buffer was in use
+    uint64_t getExhaustionDrops() const { return exhaustionDrops; }
+
+    // Allocations refused because the frame was larger than a buffer
+    uint64_t getOversizeDrops() const { return oversizeDrops; }
+
+private:
+    std::unique_ptr<uint8_t[]> arena;   // bufferCount * bufferSize bytes
+    std::size_t bufferSize;
+    std::vector<uint32_t> refCounts;    // Per buffer; 0 = free
+    std::vector<uint16_t> lengths;      // Stored frame length per buffer
+    std::vector<Handle> freeList;       // Stack of free buffers
+    std::size_t peakInUse;
+    uint64_t exhaustionDrops;
+    uint64_t oversizeDrops;
+
+    uint8_t* buffer(Handle handle) const {
+        return arena.get() + static_cast<std::size_t>(handle) * bufferSize;
+    }
+};
+
+#endif // PACKET_POOL_H
@@ -0,0 +1,212 @@
+#ifndef PARALLEL_SWITCH_H
+#define PARALLEL_SWITCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "AgingWheel.h"
+#include "ConcurrentMacTable.h"
+#include "ForwardDecision.h"
+#include "MacAddress.h"
+#include "SpscRing.h"
+#include "Switch.h"
+#include "SwitchCounters.h"
+
+/**
+ * @brief Frame header fields queued on a port's receive ring
+ */
+struct RxDescriptor {
+    MacAddress sourceMAC;
+    MacAddress destMAC;
+};
+
+/**
+ * @brief Totals gathered from all workers of a ParallelSwitch
+ */
+struct ParallelStatistics {
+    uint64_t framesProcessed = 0;
+    uint64_t learningEvents = 0;
+    uint64_t stationMoves = 0;
+    uint64_t forwardingEvents = 0;
+    uint64_t floodingEvents = 0;
+    uint64_t filteredFrames = 0;
+    uint64_t tableFull = 0;
+    uint64_t agedOut = 0;
+};
+
+/**
+ * @brief Multi-worker switch pipeline for simulating large chassis
+ *
+ * Each port has a single-producer/single-consumer receive ring, and each
+ * port is owned by exactly one worker thread (port p belongs to worker
+ * (p - 1) % workers, like RSS steering ports to cores). Workers poll their
+ * rings, learn and forward a burst at a time exactly as Switch::processBurst
+ * does, and share one ConcurrentMacTable, so a station that moves to a port
+ * owned by another worker is re-pointed correctly.
+ *
+ * Aging runs inside the workers: each keeps an AgingWheel for the stations
+ * it learned and advances it between bursts, using
+ * SwitchConfig::agingBudgetPerBurst as the per-step budget (0 = no limit).
+ * An entry refreshed by another worker between the expiry check and the
+ * erase is relearned by its next frame.
+ *
+ * Workers never report through a SwitchObserver (observers are not
+ * thread-safe); config.observer is ignored and statistics are kept in
+ * SwitchCounters instead, whose per-port shards are each written only by
+ * the port's owning worker. The table engine is always the concurrent one.
+ */
+class ParallelSwitch {
+public:
+    // Default slots per receive ring
+    static constexpr std::size_t kDefaultRingSize = 1024;
+
+    // Frames a worker takes from one ring at a time
+    static constexpr std::size_t kWorkerBurst = 32;
+
+    /**
+     * @param config Port count, aging and table capacity
+     * @param workers Number of worker threads
+     * @param ringSize Slots per port receive ring
+     * @throws std::invalid_argument if the port count is outside 1..PortMask::kMaxPorts
+     *         or workers is outside 1..port count
+     */
+    ParallelSwitch(const SwitchConfig& config, int workers, std::size_t ringSize = kDefaultRingSize);
+
+    /**
+     * @brief Stops the workers after draining their rings
+     */
+    ~ParallelSwitch();
+
+    ParallelSwitch(const ParallelSwitch&) = delete;
+    ParallelSwitch& operator=(const ParallelSwitch&) = delete;
+
+    /**
+     * @brief Starts the worker threads
+     */
+    void start();
+
+    /**
+     * @brief Processes every frame already queued, then joins the workers
+     *
+     * Producers must have stopped enqueuing before this is called.
+     */
+    void stop();
+
+    /**
+     * @brief Queues a frame on a port's receive ring
+     *
+     * Each port may be fed by only one thread at a time; different ports may
+     * be fed from different threads concurrently.
+     *
+     * @return false if the ring is full or port is not 1..numPorts (the frame is not queued)
+     */
+    bool enqueue(MacAddress sourceMAC, MacAddress destMAC, int port) {
+        if (!validPort(port)) {
+            return false;
+        }
+        return rxRings[port - 1]->tryPush(RxDescriptor{sourceMAC, destMAC});
+    }
+
+    /**
+     * @brief Queues as many frames from one port as fit in its ring
+     *
+     * @return Number of frames queued (0 if port is not 1..numPorts)
+     */
+    std::size_t enqueueBurst(const RxDescriptor* frames, std::size_t count, int port) {
+        if (!validPort(port)) {
+            return 0;
+        }
+        return rxRings[port - 1]->pushBulk(frames, count);
+    }
+
+    /**
+     * @brief Blocks until every frame queued so far has been processed
+     */
+    void waitIdle() const;
+
+    /**
+     * @brief Worker thread that owns a port
+     */
+    int workerForPort(int port) const { return (port - 1) % static_cast<int>(workers.size()); }
+
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+    int getNumPorts() const { return numPorts; }
+
+    /**
+     * @brief Sums the per-port and per-worker counters
+     */
+    ParallelStatistics getStatistics() const;
+
+    /**
+     * @brief Counters of frames received on one port
+     *
+     * Byte counts stay 0: receive descriptors carry addresses only.
+     *
+     * @throws std::invalid_argument if the port does not exist
+     */
+    PortStatistics getPortStatistics(int port) const;
+
+    /**
+     * @brief Displays aggregated statistics
+     */
+    void printStatistics() const;
+
+    /**
+     * @brief Advances the logical clock (AgingClock::Logical)
+     */
+    void advanceCycles(uint32_t cycles) { currentCycle.fetch_add(cycles, std::memory_order_relaxed); }
+
+    int getMACTableSize() const { return static_cast<int>(macTable.size()); }
+
+    /**
+     * @brief Addresses learned on a port
+     */
+    int getPortMACCount(int port) const { return static_cast<int>(macTable.portCount(port)); }
+
+    /**
+     * @brief Port an address is learned on, or MacTable::kNoPort
+     */
+    int lookup(MacAddress mac) const { return macTable.lookup(mac); }
+
+    bool isLearned(MacAddress mac) const { return lookup(mac) != MacTable::kNoPort; }
+
+private:
+    struct alignas(64) Worker {
+        std::vector<int> ports;                 // Ports whose rings this worker drains
+        std::unique_ptr<AgingWheel> agingWheel; // Stations this worker learned
+        std::thread thread;
+
+        // Written by the worker only; read by waitIdle() and getStatistics()
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> agedOut{0};
+    };
+
+    ConcurrentMacTable macTable;
+    int numPorts;
+    PortMask allPorts;
+    SwitchCounters counters;
+    int agingTimeout;
+    AgingClock agingClock;
+    std::size_t agingBudget;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<uint32_t> currentCycle;
+
+    std::vector<std::unique_ptr<SpscRing<RxDescriptor>>> rxRings;  // Indexed by port - 1
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running;
+
+    MacTable::Timestamp now() const;
+
+    bool validPort(int port) const { return port >= 1 && port <= numPorts; }
+
+    void workerLoop(Worker& worker);
+
+    // Learns and forwards frames popped from one port's ring
+    void processBurst(Worker& worker, const RxDescriptor* frames, std::size_t count,
+                      int port, MacTable::Timestamp stamp);
+};
+
+#endif // PARALLEL_SWITCH_H
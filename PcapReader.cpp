@@ -0,0 +1,335 @@
+#include "PcapReader.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t kPcapMagicMicro = 0xA1B2C3D4;
+constexpr uint32_t kPcapMagicNano = 0xA1B23C4D;
+constexpr uint32_t kPcapNgByteOrder = 0x1A2B3C4D;
+constexpr std::size_t kPcapHeaderLength = 24;
+constexpr std::size_t kPcapRecordHeader = 16;
+
+// pcapng block types
+constexpr uint32_t kSectionHeaderBlock = 0x0A0D0D0A;
+constexpr uint32_t kInterfaceBlock = 0x00000001;
+constexpr uint32_t kPacketBlock = 0x00000002;   // Obsolete, still written by old tools
+constexpr uint32_t kSimplePacketBlock = 0x00000003;
+constexpr uint32_t kEnhancedPacketBlock = 0x00000006;
+
+// Interface Description Block options
+constexpr uint16_t kOptionEnd = 0;
+constexpr uint16_t kOptionTsResol = 9;
+constexpr uint16_t kOptionTsOffset = 14;
+
+constexpr uint16_t kLinkTypeEthernet = 1;
+constexpr uint64_t kNanosPerSecond = 1000000000ULL;
+
+uint32_t swap32(uint32_t v) {
+    return __builtin_bswap32(v);
+}
+
+uint64_t toNanoseconds(uint64_t timestamp, uint64_t unitsPerSecond) {
+    if (unitsPerSecond == kNanosPerSecond) {
+        return timestamp;
+    }
+    if (unitsPerSecond < kNanosPerSecond && kNanosPerSecond % unitsPerSecond == 0) {
+        return timestamp * (kNanosPerSecond / unitsPerSecond);
+    }
+    const uint64_t seconds = timestamp / unitsPerSecond;
+    const uint64_t fraction = timestamp % unitsPerSecond;
+    return seconds * kNanosPerSecond +
+           static_cast<uint64_t>(static_cast<long double>(fraction) * kNanosPerSecond / unitsPerSecond);
+}
+
+std::runtime_error malformed(const char* what) {
+    return std::runtime_error(std::string("pcapng: malformed capture (") + what + ")");
+}
+
+} // namespace
+
+PcapReader::PcapReader(const std::string& path)
+    : fd(-1), base(nullptr), fileSize(0), offset(0), released(0),
+      format(Format::Pcap), swapped(false), nanosecond(false), pcapLinkType(0),
+      packetsRead(0), packetsSkipped(0), truncated(false) {
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("pcap: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < 12) {
+        ::close(fd);
+        throw std::runtime_error("pcap: " + path + " is not a capture file");
+    }
+    fileSize = static_cast<std::size_t>(info.st_size);
+
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("pcap: cannot map " + path + ": " + std::strerror(errno));
+    }
+    base = static_cast<const uint8_t*>(mapping);
+    ::madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    try {
+        uint32_t magic;
+        std::memcpy(&magic, base, sizeof(magic));
+        if (magic == kSectionHeaderBlock) {
+            format = Format::PcapNg;
+        } else {
+            readPcapHeader();
+        }
+    } catch (...) {
+        ::munmap(mapping, fileSize);
+        ::close(fd);
+        throw;
+    }
+}
+
+PcapReader::~PcapReader() {
+    ::munmap(const_cast<uint8_t*>(base), fileSize);
+    ::close(fd);
+}
+
+uint16_t PcapReader::read16(std::size_t at) const {
+    uint16_t v;
+    std::memcpy(&v, base + at, sizeof(v));
+    return swapped ? __builtin_bswap16(v) : v;
+}
+
+uint32_t PcapReader::read32(std::size_t at) const {
+    uint32_t v;
+    std::memcpy(&v, base + at, sizeof(v));
+    return swapped ? swap32(v) : v;
+}
+
+void PcapReader::readPcapHeader() {
+    if (fileSize < kPcapHeaderLength) {
+        throw std::runtime_error("pcap: file is shorter than the pcap header");
+    }
+    uint32_t magic;
+    std::memcpy(&magic, base, sizeof(magic));
+    if (magic == kPcapMagicMicro || magic == kPcapMagicNano) {
+        swapped = false;
+    } else if (swap32(magic) == kPcapMagicMicro || swap32(magic) == kPcapMagicNano) {
+        swapped = true;
+        magic = swap32(magic);
+    } else {
+        throw std::runtime_error("pcap: not a pcap or pcapng file");
+    }
+    nanosecond = magic == kPcapMagicNano;
+
+    // The upper bits of the link type field carry FCS information
+    pcapLinkType = read32(20) & 0xFFFF;
+    if (pcapLinkType != kLinkTypeEthernet) {
+        throw std::runtime_error("pcap: unsupported link type " + std::to_string(pcapLinkType) +
+                                 " (only Ethernet captures can be replayed)");
+    }
+    offset = kPcapHeaderLength;
+}
+
+bool PcapReader::next(PcapPacket& packet) {
+    const bool found = format == Format::Pcap ? nextPcap(packet) : nextPcapNg(packet);
+    if (found) {
+        packetsRead++;
+        releaseConsumed();
+    }
+    return found;
+}
+
+bool PcapReader::nextPcap(PcapPacket& packet) {
+    if (offset + kPcapRecordHeader > fileSize) {
+        truncated = offset != fileSize;
+        return false;
+    }
+    const uint32_t seconds = read32(offset);
+    const uint32_t fraction = read32(offset + 4);
+    const uint32_t captured = read32(offset + 8);
+    const uint32_t original = read32(offset + 12);
+    if (captured > fileSize - offset - kPcapRecordHeader) {
+        truncated = true;
+        return false;
+    }
+
+    packet.timestampNs = seconds * kNanosPerSecond + (nanosecond ? fraction : fraction * 1000ULL);
+    packet.interfaceId = 0;
+    packet.originalLength = original;
+    packet.capturedLength = captured;
+    packet.data = base + offset + kPcapRecordHeader;
+    offset += kPcapRecordHeader + captured;
+    return true;
+}
+
+uint32_t PcapReader::readSectionHeader() {
+    // The byte-order magic decides how everything in this section is read
+    uint32_t order;
+    std::memcpy(&order, base + offset + 8, sizeof(order));
+    if (order == kPcapNgByteOrder) {
+        swapped = false;
+    } else if (swap32(order) == kPcapNgByteOrder) {
+        swapped = true;
+    } else {
+        throw malformed("bad byte-order magic");
+    }
+    if (read16(offset + 12) != 1) {
+        throw std::runtime_error("pcapng: unsupported major version " +
+                                 std::to_string(read16(offset + 12)));
+    }
+    interfaces.clear();
+    return read32(offset + 4);
+}
+
+void PcapReader::readInterfaceBlock(std::size_t block, uint32_t length) {
+    if (length < 20) {
+        throw malformed("short interface block");
+    }
+    Interface iface{read16(block + 8), 1000000, 0};
+
+    std::size_t option = block + 16;
+    const std::size_t end = block + length - 4;
+    while (option + 4 <= end) {
+        const uint16_t code = read16(option);
+        const uint16_t size = read16(option + 2);
+        if (code == kOptionEnd || option + 4 + size > end) {
+            break;
+        }
+        if (code == kOptionTsResol && size >= 1) {
+            // High bit set: negative power of two, otherwise of ten
+            const uint8_t resolution = base[option + 4];
+            const unsigned exponent = resolution & 0x7F;
+            if (resolution & 0x80) {
+                iface.unitsPerSecond = exponent < 64 ? 1ULL << exponent : 0;
+            } else {
+                iface.unitsPerSecond = 1;
+                for (unsigned i = 0; i < exponent && i < 19; i++) {
+                    iface.unitsPerSecond *= 10;
+                }
+            }
+            if (iface.unitsPerSecond == 0) {
+                throw malformed("bad if_tsresol");
+            }
+        } else if (code == kOptionTsOffset && size >= 8) {
+            const uint64_t low = read32(option + 4);
+            const uint64_t high = read32(option + 8);
+            iface.offsetSeconds = static_cast<int64_t>(swapped ? (low << 32) | high : (high << 32) | low);
+        }
+        option += 4 + ((size + 3u) & ~3u);
+    }
+    interfaces.push_back(iface);
+}
+
+bool PcapReader::fillPcapNgPacket(const Interface& iface, uint32_t interfaceId, uint64_t timestamp,
+                                  uint32_t captured, uint32_t original, std::size_t data,
+                                  PcapPacket& packet) {
+    if (iface.linkType != kLinkTypeEthernet) {
+        return false;
+    }
+    packet.timestampNs = toNanoseconds(timestamp, iface.unitsPerSecond) +
+                         static_cast<uint64_t>(iface.offsetSeconds) * kNanosPerSecond;
+    packet.interfaceId = interfaceId;
+    packet.originalLength = original;
+    packet.capturedLength = captured;
+    packet.data = base + data;
+    return true;
+}
+
+bool PcapReader::nextPcapNg(PcapPacket& packet) {
+    for (;;) {
+        if (offset + 12 > fileSize) {
+            truncated = offset != fileSize;
+            return false;
+        }
+
+        const std::size_t block = offset;
+        uint32_t length;
+        if (read32(block) == kSectionHeaderBlock) {
+            if (block + 28 > fileSize) {
+                truncated = true;
+                return false;
+            }
+            length = readSectionHeader();
+        } else {
+            length = read32(block + 4);
+        }
+        if (length < 12 || length % 4 != 0) {
+            throw malformed("bad block length");
+        }
+        if (length > fileSize - block) {
+            truncated = true;
+            return false;
+        }
+        offset += length;
+
+        bool found = false;
+        switch (read32(block)) {
+            case kInterfaceBlock:
+                readInterfaceBlock(block, length);
+                continue;
+
+            case kEnhancedPacketBlock:
+            case kPacketBlock: {
+                if (length < 32) {
+                    throw malformed("short packet block");
+                }
+                const bool enhanced = read32(block) == kEnhancedPacketBlock;
+                const uint32_t interfaceId = enhanced ? read32(block + 8) : read16(block + 8);
+                const uint64_t timestamp = (static_cast<uint64_t>(read32(block + 12)) << 32) |
+                                           read32(block + 16);
+                const uint32_t captured = read32(block + 20);
+                const uint32_t original = read32(block + 24);
+                if (interfaceId >= interfaces.size()) {
+                    throw malformed("packet for an undeclared interface");
+                }
+                if (captured > length - 32) {
+                    throw malformed("packet data overruns its block");
+                }
+                found = fillPcapNgPacket(interfaces[interfaceId], interfaceId, timestamp,
+                                         captured, original, block + 28, packet);
+                break;
+            }
+
+            case kSimplePacketBlock: {
+                if (length < 16 || interfaces.empty()) {
+                    throw malformed("bad simple packet block");
+                }
+                const uint32_t original = read32(block + 8);
+                const uint32_t captured = original < length - 16 ? original : length - 16;
+                found = fillPcapNgPacket(interfaces[0], 0, 0, captured, original, block + 12, packet);
+                break;
+            }
+
+            default:
+                continue;   // Statistics, name resolution, custom blocks...
+        }
+
+        if (found) {
+            return true;
+        }
+        packetsSkipped++;
+    }
+}
+
+void PcapReader::releaseConsumed() {
+    if (offset < released + 2 * kReleaseLag) {
+        return;
+    }
+    // Keep the most recent kReleaseLag bytes; drop whole pages before that
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t limit = (offset - kReleaseLag) / page * page;
+    ::madvise(const_cast<uint8_t*>(base) + released, limit - released, MADV_DONTNEED);
+    released = limit;
+}
+
+void PcapReader::rewind() {
+    offset = format == Format::Pcap ? kPcapHeaderLength : 0;
+    released = 0;
+    interfaces.clear();
+    packetsRead = 0;
+    packetsSkipped = 0;
+    truncated = false;
+}
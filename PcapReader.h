@@ -0,0 +1,130 @@
+#ifndef PCAP_READER_H
+#define PCAP_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One captured packet, pointing into the reader's file mapping
+ */
+struct PcapPacket {
+    uint64_t timestampNs;       // Capture time in nanoseconds since the epoch (0 = not recorded)
+    uint32_t interfaceId;       // pcapng interface index (always 0 for pcap)
+    uint32_t originalLength;    // Length on the wire
+    uint32_t capturedLength;    // Bytes available at data (may be snapped)
+    const uint8_t* data;        // Frame bytes, starting with the Ethernet header
+};
+
+/**
+ * @brief Sequential reader for pcap and pcapng capture files
+ *
+ * The file is memory-mapped read-only and records are decoded in place;
+ * packet data is never copied. The kernel is told the access is sequential,
+ * and pages more than kReleaseLag bytes behind the read position are handed
+ * back with madvise(MADV_DONTNEED), so resident memory stays constant no
+ * matter how large the capture is. Dropped pages are clean file pages: a
+ * PcapPacket that still points at one stays valid and simply faults the data
+ * back in from the file.
+ *
+ * Supported inputs:
+ * - pcap, microsecond or nanosecond timestamps, either byte order
+ * - pcapng with any number of sections and interfaces; Enhanced, Simple and
+ *   (obsolete) Packet Blocks; if_tsresol and if_tsoffset are honoured
+ *
+ * Only Ethernet (LINKTYPE_ETHERNET) packets are returned; packets from other
+ * link types are counted as skipped.
+ */
+class PcapReader {
+public:
+    enum class Format {
+        Pcap,
+        PcapNg
+    };
+
+    // Consumed bytes kept resident behind the read position
+    static constexpr std::size_t kReleaseLag = 16 << 20;
+
+    /**
+     * @brief Opens and maps a capture file
+     *
+     * @param path File to read
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     *         pcap/pcapng capture (or a pcap capture of a non-Ethernet link)
+     */
+    explicit PcapReader(const std::string& path);
+    ~PcapReader();
+
+    PcapReader(const PcapReader&) = delete;
+    PcapReader& operator=(const PcapReader&) = delete;
+
+    /**
+     * @brief Returns the next Ethernet packet
+     *
+     * A record cut short by the end of the file ends the capture (see
+     * isTruncated()), as it does for a capture that was interrupted.
+     *
+     * @param packet Receives the packet on success
+     * @return false at the end of the capture
+     * @throws std::runtime_error on a malformed block
+     */
+    bool next(PcapPacket& packet);
+
+    /**
+     * @brief Restarts from the first packet
+     */
+    void rewind();
+
+    Format getFormat() const { return format; }
+    std::size_t getFileSize() const { return fileSize; }
+    uint64_t getPacketsRead() const { return packetsRead; }
+    uint64_t getPacketsSkipped() const { return packetsSkipped; }
+
+    /**
+     * @brief True if the capture ended in the middle of a record
+     */
+    bool isTruncated() const { return truncated; }
+
+private:
+    // Per-interface parameters from a pcapng Interface Description Block
+    struct Interface {
+        uint16_t linkType;
+        uint64_t unitsPerSecond;    // Timestamp resolution
+        int64_t offsetSeconds;      // if_tsoffset
+    };
+
+    int fd;
+    const uint8_t* base;
+    std::size_t fileSize;
+    std::size_t offset;             // Read position
+    std::size_t released;           // Bytes already returned to the kernel
+
+    Format format;
+    bool swapped;                   // File byte order differs from ours
+    bool nanosecond;                // pcap timestamp resolution
+    uint32_t pcapLinkType;
+    std::vector<Interface> interfaces;  // Interfaces of the current pcapng section
+
+    uint64_t packetsRead;
+    uint64_t packetsSkipped;
+    bool truncated;
+
+    uint16_t read16(std::size_t at) const;
+    uint32_t read32(std::size_t at) const;
+
+    void readPcapHeader();
+    bool nextPcap(PcapPacket& packet);
+    bool nextPcapNg(PcapPacket& packet);
+
+    // Parses a Section Header Block at offset; returns its total length
+    uint32_t readSectionHeader();
+    void readInterfaceBlock(std::size_t block, uint32_t length);
+    bool fillPcapNgPacket(const Interface& iface, uint32_t interfaceId, uint64_t timestamp,
+                          uint32_t captured, uint32_t original, std::size_t data,
+                          PcapPacket& packet);
+
+    void releaseConsumed();
+};
+
+#endif // PCAP_READER_H
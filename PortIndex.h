@@ -0,0 +1,118 @@
+#ifndef PORT_INDEX_H
+#define PORT_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PortMask.h"
+
+/**
+ * @brief Per-port doubly linked lists threaded through a table's slots
+ *
+ * Slot-array engines keep every occupied slot on the list of the port it was
+ * learned on, so flushing a port visits only that port's entries instead of
+ * scanning the table, and each port's entry count is known without counting.
+ * Links are slot indices kept in two arrays parallel to the table's own, and
+ * the caller reports every insertion, removal and slot-to-slot move.
+ *
+ * Ports outside 1..PortMask::kMaxPorts share list 0, so an entry on an
+ * unexpected port is still tracked rather than lost.
+ */
+class PortIndex {
+public:
+    // Ends a list
+    static constexpr uint32_t kNone = ~0u;
+
+    /**
+     * @param slots Number of slots in the table being indexed
+     */
+    explicit PortIndex(std::size_t slots = 0)
+        : next(slots, kNone), prev(slots, kNone), heads(kLists, kNone), counts(kLists, 0) {}
+
+    /**
+     * @brief Adds a newly filled slot to its port's list
+     */
+    void insert(std::size_t slot, int port) {
+        const std::size_t list = listOf(port);
+        const uint32_t head = heads[list];
+        next[slot] = head;
+        prev[slot] = kNone;
+        if (head != kNone) {
+            prev[head] = static_cast<uint32_t>(slot);
+        }
+        heads[list] = static_cast<uint32_t>(slot);
+        counts[list]++;
+    }
+
+    /**
+     * @brief Takes a slot off the list of the port it was inserted with
+     */
+    void remove(std::size_t slot, int port) {
+        const std::size_t list = listOf(port);
+        if (prev[slot] != kNone) {
+            next[prev[slot]] = next[slot];
+        } else {
+            heads[list] = next[slot];
+        }
+        if (next[slot] != kNone) {
+            prev[next[slot]] = prev[slot];
+        }
+        counts[list]--;
+    }
+
+    /**
+     * @brief Records that an entry moved from one slot to another, empty one
+     *
+     * The entry keeps its place in its port's list.
+     */
+    void relocate(std::size_t from, std::size_t to, int port) {
+        next[to] = next[from];
+        prev[to] = prev[from];
+        if (prev[to] != kNone) {
+            next[prev[to]] = static_cast<uint32_t>(to);
+        } else {
+            heads[listOf(port)] = static_cast<uint32_t>(to);
+        }
+        if (next[to] != kNone) {
+            prev[next[to]] = static_cast<uint32_t>(to);
+        }
+    }
+
+    /**
+     * @brief First slot on a port's list, or kNone
+     */
+    uint32_t first(int port) const { return heads[listOf(port)]; }
+
+    std::size_t count(int port) const { return counts[listOf(port)]; }
+
+    /**
+     * @brief Heap bytes held by the lists
+     */
+    std::size_t allocatedBytes() const {
+        return (next.capacity() + prev.capacity() + heads.capacity()) * sizeof(uint32_t) +
+               counts.capacity() * sizeof(std::size_t);
+    }
+
+    /**
+     * @brief Empties every list (slot links are rewritten on insert)
+     */
+    void clear() {
+        std::fill(heads.begin(), heads.end(), kNone);
+        std::fill(counts.begin(), counts.end(), 0);
+    }
+
+private:
+    static constexpr std::size_t kLists = PortMask::kMaxPorts + 1;
+
+    std::vector<uint32_t> next;         // Next slot on the same port's list, per slot
+    std::vector<uint32_t> prev;         // Previous slot on the same port's list, per slot
+    std::vector<uint32_t> heads;        // First slot per port
+    std::vector<std::size_t> counts;    // Entries per port
+
+    static std::size_t listOf(int port) {
+        return PortMask::valid(port) ? static_cast<std::size_t>(port) : 0;
+    }
+};
+
+#endif // PORT_INDEX_H
@@ -0,0 +1,309 @@
+#ifndef PORT_MASK_H
+#define PORT_MASK_H
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Fixed-width bitmap of switch ports
+ *
+ * Port N (ports are numbered from 1) is bit N-1. Egress sets are computed
+ * with whole-word operations, so building the flood set for a broadcast costs
+ * the same on a 128-port chassis as on an 8-port desktop switch. Iteration
+ * over set ports skips empty words and uses count-trailing-zeros, so it is
+ * proportional to the number of ports actually selected.
+ */
+class PortMask {
+public:
+    static constexpr int kMaxPorts = 256;
+    static constexpr int kWords = kMaxPorts / 64;
+
+    constexpr PortMask() : words{} {}
+
+    /**
+     * @brief Mask with ports 1..count set
+     */
+    static PortMask firstPorts(int count) {
+        PortMask mask;
+        for (int w = 0; w < kWords; w++) {
+            const int bits = count - w * 64;
+            if (bits >= 64) {
+                mask.words[w] = ~0ULL;
+            } else if (bits > 0) {
+                mask.words[w] = (1ULL << bits) - 1;
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Mask with only one port set
+     */
+    static PortMask single(int port) {
+        PortMask mask;
+        mask.set(port);
+        return mask;
+    }
+
+    static constexpr bool valid(int port) { return port >= 1 && port <= kMaxPorts; }
+
+    void set(int port) {
+        if (valid(port)) {
+            words[(port - 1) >> 6] |= 1ULL << ((port - 1) & 63);
+        }
+    }
+
+    void reset(int port) {
+        if (valid(port)) {
+            words[(port - 1) >> 6] &= ~(1ULL << ((port - 1) & 63));
+        }
+    }
+
+    bool test(int port) const {
+        return valid(port) && ((words[(port - 1) >> 6] >> ((port - 1) & 63)) & 1);
+    }
+
+    /**
+     * @brief Copy of this mask with one port cleared
+     */
+    PortMask without(int port) const {
+        PortMask mask = *this;
+        mask.reset(port);
+        return mask;
+    }
+
+    int count() const {
+        int total = 0;
+        for (int w = 0; w < kWords; w++) {
+            total += __builtin_popcountll(words[w]);
+        }
+        return total;
+    }
+
+    bool none() const {
+        uint64_t any = 0;
+        for (int w = 0; w < kWords; w++) {
+            any |= words[w];
+        }
+        return any == 0;
+    }
+
+    bool any() const { return !none(); }
+
+    /**
+     * @brief Calls fn(port) for every set port in ascending order
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int w = 0; w < kWords; w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                fn(w * 64 + __builtin_ctzll(bits) + 1);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Lowest set port, or 0 if the mask is empty
+     */
+    int first() const {
+        for (int w = 0; w < kWords; w++) {
+            if (words[w]) {
+                return w * 64 + __builtin_ctzll(words[w]) + 1;
+            }
+        }
+        return 0;
+    }
+
+    uint64_t word(int index) const { return words[index]; }
+    void setWord(int index, uint64_t value) { words[index] = value; }
+
+    PortMask& operator&=(const PortMask& other) {
+        for (int w = 0; w < kWords; w++) {
+            words[w] &= other.words[w];
+        }
+        return *this;
+    }
+
+    PortMask& operator|=(const PortMask& other) {
+        for (int w = 0; w < kWords; w++) {
+            words[w] |= other.words[w];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Clears every port that is set in other
+     */
+    PortMask& andNot(const PortMask& other) {
+        for (int w = 0; w < kWords; w++) {
+            words[w] &= ~other.words[w];
+        }
+        return *this;
+    }
+
+    friend PortMask operator&(PortMask a, const PortMask& b) { return a &= b; }
+    friend PortMask operator|(PortMask a, const PortMask& b) { return a |= b; }
+
+    bool operator==(const PortMask& other) const {
+        uint64_t diff = 0;
+        for (int w = 0; w < kWords; w++) {
+            diff |= words[w] ^ other.words[w];
+        }
+        return diff == 0;
+    }
+
+    bool operator!=(const PortMask& other) const { return !(*this == other); }
+
+private:
+    uint64_t words[kWords];
+};
+
+/**
+ * @brief Port bitmap sized at compile time for a switch of NumPorts ports
+ *
+ * Same port numbering and operations as PortMask, but only as wide as the
+ * switch: up to 32 ports fit one 32-bit word and up to 64 one 64-bit word,
+ * so a flood set is built and tested with a single register operation and
+ * the word loops unroll away. Used by BasicSwitch; toPortMask() widens it
+ * for code that takes a PortMask.
+ */
+template <int NumPorts>
+class FixedPortMask {
+    static_assert(NumPorts >= 1 && NumPorts <= PortMask::kMaxPorts,
+                  "FixedPortMask: port count must be between 1 and PortMask::kMaxPorts");
+
+public:
+    using Word = std::conditional_t<NumPorts <= 32, uint32_t, uint64_t>;
+    static constexpr int kPorts = NumPorts;
+    static constexpr int kWordBits = static_cast<int>(sizeof(Word) * 8);
+    static constexpr int kWords = (NumPorts + kWordBits - 1) / kWordBits;
+
+    constexpr FixedPortMask() : words{} {}
+
+    /**
+     * @brief Mask with every port 1..NumPorts set
+     */
+    static constexpr FixedPortMask all() {
+        FixedPortMask mask;
+        for (int w = 0; w < kWords; w++) {
+            const int bits = NumPorts - w * kWordBits;
+            mask.words[w] = bits >= kWordBits ? static_cast<Word>(~Word(0))
+                                              : static_cast<Word>((Word(1) << bits) - 1);
+        }
+        return mask;
+    }
+
+    static FixedPortMask single(int port) {
+        FixedPortMask mask;
+        mask.set(port);
+        return mask;
+    }
+
+    // One unsigned compare covers both ends of the range
+    static constexpr bool valid(int port) { return static_cast<unsigned>(port - 1) < NumPorts; }
+
+    void set(int port) {
+        if (valid(port)) {
+            words[(port - 1) / kWordBits] |= bit(port);
+        }
+    }
+
+    void reset(int port) {
+        if (valid(port)) {
+            words[(port - 1) / kWordBits] &= static_cast<Word>(~bit(port));
+        }
+    }
+
+    bool test(int port) const {
+        return valid(port) && (words[(port - 1) / kWordBits] & bit(port));
+    }
+
+    FixedPortMask without(int port) const {
+        FixedPortMask mask = *this;
+        mask.reset(port);
+        return mask;
+    }
+
+    int count() const {
+        int total = 0;
+        for (int w = 0; w < kWords; w++) {
+            total += __builtin_popcountll(words[w]);
+        }
+        return total;
+    }
+
+    bool none() const {
+        Word any = 0;
+        for (int w = 0; w < kWords; w++) {
+            any |= words[w];
+        }
+        return any == 0;
+    }
+
+    bool any() const { return !none(); }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int w = 0; w < kWords; w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                fn(w * kWordBits + __builtin_ctzll(bits) + 1);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    int first() const {
+        for (int w = 0; w < kWords; w++) {
+            if (words[w]) {
+                return w * kWordBits + __builtin_ctzll(words[w]) + 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief The same ports as a full-width PortMask
+     */
+    PortMask toPortMask() const {
+        PortMask mask;
+        forEach([&mask](int port) { mask.set(port); });
+        return mask;
+    }
+
+    FixedPortMask& operator&=(const FixedPortMask& other) {
+        for (int w = 0; w < kWords; w++) {
+            words[w] &= other.words[w];
+        }
+        return *this;
+    }
+
+    FixedPortMask& operator|=(const FixedPortMask& other) {
+        for (int w = 0; w < kWords; w++) {
+            words[w] |= other.words[w];
+        }
+        return *this;
+    }
+
+    friend FixedPortMask operator&(FixedPortMask a, const FixedPortMask& b) { return a &= b; }
+    friend FixedPortMask operator|(FixedPortMask a, const FixedPortMask& b) { return a |= b; }
+
+    bool operator==(const FixedPortMask& other) const {
+        Word diff = 0;
+        for (int w = 0; w < kWords; w++) {
+            diff |= words[w] ^ other.words[w];
+        }
+        return diff == 0;
+    }
+
+    bool operator!=(const FixedPortMask& other) const { return !(*this == other); }
+
+private:
+    Word words[kWords];
+
+    static constexpr Word bit(int port) { return static_cast<Word>(Word(1) << ((port - 1) % kWordBits)); }
+};
+
+#endif // PORT_MASK_H
@@ -0,0 +1,349 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'L', '2', 'S', 'C', 'N', '\r', '\n', '\x1a'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct ScenarioHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t recordCount;
+};
+
+static_assert(sizeof(ScenarioHeader) == 32, "scenario header must stay 32 bytes");
+
+constexpr uint16_t kDefaultEtherType = 0x0800;
+constexpr uint16_t kDefaultLength = 60;
+constexpr std::size_t kHeaderLength = 14;
+constexpr std::size_t kTagLength = 4;
+
+// Bytes after the header of every scenario frame (a record's length is 16 bits)
+const char kZeroPayload[65536] = {};
+
+// Output buffering for writers, and the longest text line accepted
+constexpr std::size_t kWriteBuffer = 1 << 20;
+constexpr std::size_t kMaxLine = 1024;
+
+} // namespace
+
+ScenarioRecord ScenarioRecord::make(uint32_t cycle, int port, MacAddress sourceMAC, MacAddress destMAC,
+                                    uint16_t etherType, uint16_t length, uint16_t vlan) {
+    ScenarioRecord record;
+    record.cycle = cycle;
+    record.port = static_cast<uint16_t>(port);
+    record.etherType = etherType;
+    sourceMAC.toBytes(record.source);
+    destMAC.toBytes(record.dest);
+    record.length = length;
+    record.vlan = vlan;
+    return record;
+}
+
+FrameView ScenarioRecord::view() const {
+    FrameView frame;
+    frame.destMAC = destMAC();
+    frame.sourceMAC = sourceMAC();
+    frame.etherType = etherType;
+    frame.tagged = vlan != 0;
+    frame.vlan = vlan;
+    const std::size_t header = kHeaderLength + (frame.tagged ? kTagLength : 0);
+    frame.payload = std::string_view(kZeroPayload, length > header ? length - header : 0);
+    return frame;
+}
+
+ScenarioWriter::ScenarioWriter(const std::string& path, ScenarioFormat format)
+    : path(path), format(format), file(std::fopen(path.c_str(), "wb")), records(0) {
+    if (!file) {
+        throw std::runtime_error("scenario: cannot create " + path + ": " + std::strerror(errno));
+    }
+    std::setvbuf(file, nullptr, _IOFBF, kWriteBuffer);
+    if (format == ScenarioFormat::Binary) {
+        // The count is filled in by close()
+        ScenarioHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kScenarioVersion;
+        header.byteOrder = kByteOrderMark;
+        header.recordSize = sizeof(ScenarioRecord);
+        std::fwrite(&header, sizeof(header), 1, file);
+    } else {
+        std::fputs("# cycle port source destination ethertype length [vlan]\n", file);
+    }
+}
+
+ScenarioWriter::~ScenarioWriter() {
+    if (file) {
+        try {
+            close();
+        } catch (const std::exception&) {
+        }
+    }
+}
+
+void ScenarioWriter::write(const ScenarioRecord& record) {
+    if (format == ScenarioFormat::Binary) {
+        std::fwrite(&record, sizeof(record), 1, file);
+    } else {
+        char source[MacAddress::kTextLength + 1] = {};
+        char dest[MacAddress::kTextLength + 1] = {};
+        record.sourceMAC().format(source);
+        record.destMAC().format(dest);
+        std::fprintf(file, "%u %u %s %s 0x%04X %u", record.cycle, record.port, source, dest,
+                     record.etherType, record.length);
+        if (record.vlan != 0) {
+            std::fprintf(file, " %u", record.vlan);
+        }
+        std::fputc('\n', file);
+    }
+    records++;
+}
+
+void ScenarioWriter::close() {
+    std::FILE* closing = file;
+    file = nullptr;
+    bool ok = !std::ferror(closing);
+    if (ok && format == ScenarioFormat::Binary) {
+        ok = std::fseek(closing, offsetof(ScenarioHeader, recordCount), SEEK_SET) == 0 &&
+             std::fwrite(&records, sizeof(records), 1, closing) == 1;
+    }
+    if (std::fclose(closing) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        throw std::runtime_error("scenario: cannot write " + path);
+    }
+}
+
+ScenarioReader::ScenarioReader(const std::string& path)
+    : path(path), format(ScenarioFormat::Text), file(std::fopen(path.c_str(), "rb")),
+      remaining(0), line(0), current(0), holding(false), finished(false), stopping(false),
+      recordsRead(0) {
+    if (!file) {
+        throw std::runtime_error("scenario: cannot open " + path + ": " + std::strerror(errno));
+    }
+
+    ScenarioHeader header;
+    const std::size_t got = std::fread(&header, 1, sizeof(header), file);
+    if (got >= sizeof(kMagic) && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0) {
+        format = ScenarioFormat::Binary;
+        struct stat info;
+        const char* problem = nullptr;
+        if (got < sizeof(header) || ::fstat(::fileno(file), &info) != 0) {
+            problem = "is truncated";
+        } else if (header.byteOrder != kByteOrderMark) {
+            problem = "was written with a different byte order";
+        } else if (header.version != kScenarioVersion || header.recordSize != sizeof(ScenarioRecord)) {
+            problem = "is of an unsupported scenario version";
+        } else if (header.recordCount >
+                   (static_cast<uint64_t>(info.st_size) - sizeof(header)) / sizeof(ScenarioRecord)) {
+            problem = "is truncated";
+        }
+        if (problem) {
+            std::fclose(file);
+            throw std::runtime_error("scenario: " + path + " " + problem);
+        }
+        remaining = header.recordCount;
+    } else {
+        std::rewind(file);
+    }
+
+    for (Buffer& buffer : buffers) {
+        buffer.records.resize(kBlockRecords);
+    }
+    loader = std::thread(&ScenarioReader::load, this);
+}
+
+ScenarioReader::~ScenarioReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    loader.join();
+    std::fclose(file);
+}
+
+bool ScenarioReader::next(const ScenarioRecord*& records, std::size_t& count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (holding) {
+        // Hand the block back to the loader
+        Buffer& done = buffers[current];
+        holding = false;
+        finished = done.last;
+        done.full = false;
+        current ^= 1;
+        changed.notify_all();
+    }
+    if (finished) {
+        return false;
+    }
+
+    Buffer& buffer = buffers[current];
+    changed.wait(lock, [&buffer] { return buffer.full; });
+    if (error) {
+        finished = true;
+        std::rethrow_exception(error);
+    }
+    if (buffer.count == 0) {
+        finished = true;
+        return false;
+    }
+    holding = true;
+    records = buffer.records.data();
+    count = buffer.count;
+    recordsRead += count;
+    return true;
+}
+
+void ScenarioReader::load() {
+    std::size_t index = 0;
+    try {
+        for (;;) {
+            Buffer& buffer = buffers[index];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this, &buffer] { return stopping || !buffer.full; });
+                if (stopping) {
+                    return;
+                }
+            }
+            // The caller only touches full buffers, so this one is ours until marked
+            const bool more = fill(buffer);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                buffer.full = true;
+                buffer.last = !more;
+            }
+            changed.notify_all();
+            if (!more) {
+                return;
+            }
+            index ^= 1;
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+            buffers[index].count = 0;
+            buffers[index].full = true;
+            buffers[index].last = true;
+        }
+        changed.notify_all();
+    }
+}
+
+bool ScenarioReader::fill(Buffer& buffer) {
+    return format == ScenarioFormat::Binary ? fillBinary(buffer) : fillText(buffer);
+}
+
+bool ScenarioReader::fillBinary(Buffer& buffer) {
+    const std::size_t want = static_cast<std::size_t>(
+        std::min<uint64_t>(remaining, kBlockRecords));
+    buffer.count = std::fread(buffer.records.data(), sizeof(ScenarioRecord), want, file);
+    if (buffer.count != want) {
+        throw std::runtime_error("scenario: cannot read " + path);
+    }
+    remaining -= want;
+    return remaining > 0;
+}
+
+bool ScenarioReader::fillText(Buffer& buffer) {
+    buffer.count = 0;
+    char text[kMaxLine];
+    while (buffer.count < kBlockRecords) {
+        if (!std::fgets(text, sizeof(text), file)) {
+            if (std::ferror(file)) {
+                throw std::runtime_error("scenario: cannot read " + path);
+            }
+            return false;
+        }
+        line++;
+        const std::size_t length = std::strlen(text);
+        if (length == sizeof(text) - 1 && text[length - 1] != '\n' && !std::feof(file)) {
+            throw std::runtime_error("scenario: " + path + ":" + std::to_string(line) + ": line too long");
+        }
+        parseLine(text, buffer);
+    }
+    return true;
+}
+
+void ScenarioReader::parseLine(char* text, Buffer& buffer) {
+    if (char* comment = std::strchr(text, '#')) {
+        *comment = '\0';
+    }
+    char* cursor = text;
+    auto fail = [this](const std::string& message) {
+        throw std::runtime_error("scenario: " + path + ":" + std::to_string(line) + ": " + message);
+    };
+    auto skipSpace = [&cursor] {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+            cursor++;
+        }
+    };
+    auto number = [&](const char* field, unsigned long max, bool hex) {
+        skipSpace();
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long value = std::strtoul(cursor, &end, hex ? 0 : 10);
+        if (end == cursor || errno != 0 || value > max || *cursor == '-') {
+            fail(std::string("bad ") + field);
+        }
+        cursor = end;
+        return value;
+    };
+    auto address = [&](const char* field) {
+        skipSpace();
+        const char* start = cursor;
+        while (*cursor && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') {
+            cursor++;
+        }
+        MacAddress mac;
+        if (!MacAddress::parse(std::string_view(start, cursor - start), mac)) {
+            fail(std::string("bad ") + field + " address");
+        }
+        return mac;
+    };
+
+    skipSpace();
+    if (*cursor == '\0') {
+        return;     // Blank or comment line
+    }
+    const uint32_t cycle = static_cast<uint32_t>(number("cycle", 0xFFFFFFFFUL, false));
+    const unsigned long port = number("port", 0xFFFF, false);
+    const MacAddress source = address("source");
+    const MacAddress dest = address("destination");
+    uint16_t etherType = kDefaultEtherType;
+    uint16_t length = kDefaultLength;
+    uint16_t vlan = 0;
+    skipSpace();
+    if (*cursor) {
+        etherType = static_cast<uint16_t>(number("ethertype", 0xFFFF, true));
+        skipSpace();
+    }
+    if (*cursor) {
+        length = static_cast<uint16_t>(number("length", 0xFFFF, false));
+        skipSpace();
+    }
+    if (*cursor) {
+        vlan = static_cast<uint16_t>(number("vlan", 4094, false));
+        skipSpace();
+    }
+    if (*cursor) {
+        fail("unexpected text after the record");
+    }
+    if (length < kHeaderLength + (vlan != 0 ? kTagLength : 0)) {
+        fail("length shorter than the frame header");
+    }
+    buffer.records[buffer.count++] = ScenarioRecord::make(cycle, static_cast<int>(port), source, dest,
+                                                          etherType, length, vlan);
+}
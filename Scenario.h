@@ -0,0 +1,192 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameView.h"
+#include "MacAddress.h"
+
+/**
+ * @brief One frame of a scenario: when and where it arrives, and its header
+ *
+ * Stored as-is in binary scenario files (in the writer's byte order), so a
+ * block read from the file is an array of these.
+ */
+struct ScenarioRecord {
+    uint32_t cycle;         // Logical clock cycle the frame arrives in
+    uint16_t port;          // Ingress port
+    uint16_t etherType;     // EtherType of the payload
+    uint8_t source[6];      // Source MAC, transmission order
+    uint8_t dest[6];        // Destination MAC, transmission order
+    uint16_t length;        // Frame length without FCS, including any 802.1Q tag
+    uint16_t vlan;          // 802.1Q VID (0 = untagged)
+
+    MacAddress sourceMAC() const { return MacAddress::fromBytes(source); }
+    MacAddress destMAC() const { return MacAddress::fromBytes(dest); }
+
+    /**
+     * @brief Builds a record; the addresses are stored in transmission order
+     */
+    static ScenarioRecord make(uint32_t cycle, int port, MacAddress sourceMAC, MacAddress destMAC,
+                               uint16_t etherType, uint16_t length, uint16_t vlan = 0);
+
+    /**
+     * @brief The frame as a switch sees it
+     *
+     * Scenarios carry no payload bytes, so the payload points at a shared
+     * zero-filled buffer of the right size.
+     */
+    FrameView view() const;
+};
+
+static_assert(sizeof(ScenarioRecord) == 24, "scenario records must stay 24 bytes");
+
+/**
+ * @brief Scenario file encodings
+ *
+ * Binary files are a 32-byte header followed by packed ScenarioRecord:
+ *
+ * | Offset | Size | Field |
+ * |--------|------|-------|
+ * | 0 | 8 | Magic "L2SCN\r\n\x1a" |
+ * | 8 | 4 | Format version (kScenarioVersion) |
+ * | 12 | 4 | Byte order mark 0x01020304 |
+ * | 16 | 4 | Record size (24) |
+ * | 20 | 4 | Reserved (0) |
+ * | 24 | 8 | Record count |
+ *
+ * Text files have one frame per line, `#` starting a comment:
+ *
+ *     # cycle port source            destination       [ethertype [length [vlan]]]
+ *     0     1    AA:AA:AA:AA:AA:AA FF:FF:FF:FF:FF:FF 0x0806     60
+ *
+ * EtherType defaults to 0x0800 and length to 60 (a minimum-size frame).
+ */
+enum class ScenarioFormat {
+    Binary,
+    Text
+};
+
+constexpr uint32_t kScenarioVersion = 1;
+
+/**
+ * @brief Writes a scenario file one record at a time
+ *
+ * Output is buffered and the record count is filled into the header by
+ * close(), so a writer needs no memory proportional to the scenario.
+ */
+class ScenarioWriter {
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be created
+     */
+    ScenarioWriter(const std::string& path, ScenarioFormat format);
+
+    // Closes the file if close() was not called; errors are lost
+    ~ScenarioWriter();
+
+    ScenarioWriter(const ScenarioWriter&) = delete;
+    ScenarioWriter& operator=(const ScenarioWriter&) = delete;
+
+    void write(const ScenarioRecord& record);
+
+    /**
+     * @brief Completes the header and closes the file
+     *
+     * @throws std::runtime_error if any write failed
+     */
+    void close();
+
+    uint64_t getRecordsWritten() const { return records; }
+
+private:
+    std::string path;
+    ScenarioFormat format;
+    std::FILE* file;
+    uint64_t records;
+};
+
+/**
+ * @brief Streaming reader for binary and text scenario files
+ *
+ * Records are handed out in blocks of up to kBlockRecords from one of two
+ * fixed buffers. A loader thread fills the other buffer (reading the file
+ * or parsing text) while the caller processes the current one, so I/O and
+ * parsing overlap with switching and memory use does not depend on the
+ * scenario's length. The format is detected from the file's first bytes.
+ */
+class ScenarioReader {
+public:
+    static constexpr std::size_t kBlockRecords = 4096;
+
+    /**
+     * @brief Opens a scenario file and starts reading ahead
+     *
+     * @throws std::runtime_error if the file cannot be opened, or is a
+     *         binary scenario of another version or byte order, or truncated
+     */
+    explicit ScenarioReader(const std::string& path);
+    ~ScenarioReader();
+
+    ScenarioReader(const ScenarioReader&) = delete;
+    ScenarioReader& operator=(const ScenarioReader&) = delete;
+
+    /**
+     * @brief Returns the next block of records
+     *
+     * The block stays valid until the following call.
+     *
+     * @param records Receives a pointer to the block
+     * @param count Receives the number of records in it (at least one)
+     * @return false at the end of the scenario
+     * @throws std::runtime_error on a malformed text line or a read error
+     */
+    bool next(const ScenarioRecord*& records, std::size_t& count);
+
+    ScenarioFormat getFormat() const { return format; }
+    uint64_t getRecordsRead() const { return recordsRead; }
+
+private:
+    struct Buffer {
+        std::vector<ScenarioRecord> records;
+        std::size_t count = 0;
+        bool full = false;      // Filled by the loader, not yet returned to it
+        bool last = false;      // No records follow this buffer
+    };
+
+    std::string path;
+    ScenarioFormat format;
+    std::FILE* file;
+    uint64_t remaining;             // Binary records not yet read
+    uint64_t line;                  // Text line number, for error messages
+
+    Buffer buffers[2];
+    std::size_t current;            // Buffer the caller holds (or will get next)
+    bool holding;                   // Caller holds buffers[current]
+    bool finished;                  // next() has reported the end
+    bool stopping;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread loader;
+    uint64_t recordsRead;
+
+    void load();
+
+    // Fills a buffer; returns false once the file is exhausted
+    bool fill(Buffer& buffer);
+    bool fillBinary(Buffer& buffer);
+    bool fillText(Buffer& buffer);
+
+    // Appends the record on one text line, if it has one
+    void parseLine(char* text, Buffer& buffer);
+};
+
+#endif // SCENARIO_H
@@ -0,0 +1,263 @@
+#include "SpanningTree.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace {
+
+// 802.1w path costs are 20,000,000,000 kb/s divided by the link speed
+constexpr double kCostNumeratorGbps = 20000.0;
+
+} // namespace
+
+bool SpanningTree::Vector::operator<(const Vector& other) const {
+    return std::tie(root, cost, bridge, port, receivePort) <
+           std::tie(other.root, other.cost, other.bridge, other.port, other.receivePort);
+}
+
+uint32_t SpanningTree::pathCost(double bandwidthGbps) {
+    if (!(bandwidthGbps > 0.0)) {
+        throw std::invalid_argument("pathCost: bandwidth must be positive");
+    }
+    const double cost = std::round(kCostNumeratorGbps / bandwidthGbps);
+    return static_cast<uint32_t>(std::min(std::max(cost, 1.0), 200000000.0));
+}
+
+int SpanningTree::addBridge(uint16_t priority) {
+    Bridge bridge;
+    bridge.id = static_cast<uint64_t>(priority) << 48 | bridges.size();
+    bridge.best = ownVector(bridge);
+    bridges.push_back(std::move(bridge));
+    return static_cast<int>(bridges.size() - 1);
+}
+
+void SpanningTree::setPriority(int bridge, uint16_t priority) {
+    if (bridge < 0 || bridge >= getBridgeCount()) {
+        throw std::invalid_argument("setPriority: no such bridge " + std::to_string(bridge));
+    }
+    bridges[bridge].id = static_cast<uint64_t>(priority) << 48 | static_cast<uint64_t>(bridge);
+}
+
+int SpanningTree::addLink(int bridgeA, int portA, int bridgeB, int portB, uint32_t cost) {
+    if (bridgeA < 0 || bridgeA >= getBridgeCount() || bridgeB < 0 || bridgeB >= getBridgeCount()) {
+        throw std::invalid_argument("addLink: no such bridge");
+    }
+    if (portA < 1 || portB < 1 || cost == 0) {
+        throw std::invalid_argument("addLink: ports must be 1 or above and the cost positive");
+    }
+    const int id = getLinkCount();
+    links.push_back(Link{bridgeA, portA, bridgeB, portB, cost, true,
+                         PortRole::Disabled, PortRole::Disabled});
+    bridges[bridgeA].links.push_back(id);
+    if (bridgeB != bridgeA) {
+        bridges[bridgeB].links.push_back(id);
+    }
+    return id;
+}
+
+SpanningTree::Offer SpanningTree::offerAcross(int link, bool fromB) const {
+    const Link& l = links[link];
+    const Bridge& from = bridges[fromB ? l.b : l.a];
+    const int fromPort = fromB ? l.portB : l.portA;
+    const int toPort = fromB ? l.portA : l.portB;
+    const Vector vector{from.best.root, from.best.cost + l.cost, from.id,
+                        static_cast<uint32_t>(fromPort), static_cast<uint32_t>(toPort)};
+    return Offer{vector, fromB ? l.a : l.b, link};
+}
+
+namespace {
+
+template <typename OfferT>
+bool worseOffer(const OfferT& a, const OfferT& b) {
+    return b.vector < a.vector;
+}
+
+} // namespace
+
+void SpanningTree::pushOffers(int bridge, std::vector<Offer>& heap) const {
+    for (int link : bridges[bridge].links) {
+        const Link& l = links[link];
+        if (!l.up || l.a == l.b) {
+            continue;   // A bridge never improves its own path through itself
+        }
+        heap.push_back(offerAcross(link, l.b == bridge));
+        std::push_heap(heap.begin(), heap.end(), worseOffer<Offer>);
+    }
+}
+
+void SpanningTree::settle(std::vector<Offer>& heap, std::vector<char>& touched,
+                          std::vector<int>& touchedList) {
+    // Offers never beat the vector they were made from, so taking the best
+    // one first settles most bridges on their first accepted offer
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), worseOffer<Offer>);
+        const Offer offer = heap.back();
+        heap.pop_back();
+        Bridge& bridge = bridges[offer.bridge];
+        if (!(offer.vector < bridge.best)) {
+            continue;
+        }
+        bridge.best = offer.vector;
+        bridge.rootLink = offer.link;
+        if (!touched[offer.bridge]) {
+            touched[offer.bridge] = 1;
+            touchedList.push_back(offer.bridge);
+        }
+        pushOffers(offer.bridge, heap);
+    }
+}
+
+void SpanningTree::setRole(Link& link, bool sideB, PortRole role, bool& forwardingAdded) {
+    PortRole& current = sideB ? link.roleB : link.roleA;
+    if (current == role) {
+        return;
+    }
+    changes.push_back(PortRoleChange{sideB ? link.b : link.a, sideB ? link.portB : link.portA,
+                                     current, role});
+    if (!isForwardingRole(current) && isForwardingRole(role)) {
+        forwardingAdded = true;
+    }
+    current = role;
+}
+
+void SpanningTree::assignRoles(const std::vector<int>& touchedList) {
+    std::vector<char> done(links.size(), 0);
+    bool forwardingAdded = false;
+    for (int bridge : touchedList) {
+        for (int id : bridges[bridge].links) {
+            if (done[id]) {
+                continue;
+            }
+            done[id] = 1;
+            Link& link = links[id];
+            if (!link.up) {
+                setRole(link, false, PortRole::Disabled, forwardingAdded);
+                setRole(link, true, PortRole::Disabled, forwardingAdded);
+                continue;
+            }
+            if (link.a == link.b) {
+                // Looped back onto the same bridge: the lower port serves the link
+                const bool aWins = link.portA < link.portB;
+                setRole(link, false, aWins ? PortRole::Designated : PortRole::Backup, forwardingAdded);
+                setRole(link, true, aWins ? PortRole::Backup : PortRole::Designated, forwardingAdded);
+                continue;
+            }
+
+            // The end advertising the better vector onto the link is designated
+            const Bridge& a = bridges[link.a];
+            const Bridge& b = bridges[link.b];
+            const bool aWins = std::tie(a.best.root, a.best.cost, a.id, link.portA) <
+                               std::tie(b.best.root, b.best.cost, b.id, link.portB);
+            const Bridge& loser = aWins ? b : a;
+            const PortRole loserRole = loser.rootLink == id ? PortRole::Root : PortRole::Alternate;
+            setRole(link, false, aWins ? PortRole::Designated : loserRole, forwardingAdded);
+            setRole(link, true, aWins ? loserRole : PortRole::Designated, forwardingAdded);
+        }
+    }
+    if (forwardingAdded) {
+        topologyChanges++;
+    }
+    lastUpdateSize = touchedList.size();
+}
+
+void SpanningTree::compute() {
+    std::vector<char> touched(bridges.size(), 1);
+    std::vector<int> touchedList(bridges.size());
+    std::vector<Offer> heap;
+    for (int id = 0; id < getBridgeCount(); id++) {
+        bridges[id].best = ownVector(bridges[id]);
+        bridges[id].rootLink = -1;
+        touchedList[id] = id;
+    }
+    for (int id = 0; id < getBridgeCount(); id++) {
+        pushOffers(id, heap);
+    }
+    settle(heap, touched, touchedList);
+    assignRoles(touchedList);
+}
+
+void SpanningTree::setLinkUp(int id, bool up) {
+    if (id < 0 || id >= getLinkCount()) {
+        throw std::invalid_argument("setLinkUp: no such link " + std::to_string(id));
+    }
+    Link& link = links[id];
+    if (link.up == up) {
+        return;
+    }
+    link.up = up;
+
+    std::vector<char> touched(bridges.size(), 0);
+    std::vector<int> touchedList;
+    auto touch = [&](int bridge) {
+        if (!touched[bridge]) {
+            touched[bridge] = 1;
+            touchedList.push_back(bridge);
+        }
+    };
+    touch(link.a);
+    touch(link.b);
+    std::vector<Offer> heap;
+
+    if (up) {
+        // Only bridges the new link gives a better path to change
+        if (link.a != link.b) {
+            heap.push_back(offerAcross(id, false));
+            std::push_heap(heap.begin(), heap.end(), worseOffer<Offer>);
+            heap.push_back(offerAcross(id, true));
+            std::push_heap(heap.begin(), heap.end(), worseOffer<Offer>);
+        }
+    } else {
+        int child = -1;
+        if (bridges[link.a].rootLink == id) {
+            child = link.a;
+        } else if (bridges[link.b].rootLink == id) {
+            child = link.b;
+        }
+        if (child >= 0) {
+            // The subtree that reached the root through this link starts
+            // over; nothing outside it depended on the link
+            std::vector<int> subtree{child};
+            touch(child);
+            for (std::size_t i = 0; i < subtree.size(); i++) {
+                const int parent = subtree[i];
+                for (int linkId : bridges[parent].links) {
+                    const Link& l = links[linkId];
+                    const int other = l.a == parent ? l.b : l.a;
+                    if (other != parent && !touched[other] && bridges[other].rootLink == linkId) {
+                        touch(other);
+                        subtree.push_back(other);
+                    }
+                }
+            }
+            for (int bridge : subtree) {
+                bridges[bridge].best = ownVector(bridges[bridge]);
+                bridges[bridge].rootLink = -1;
+            }
+
+            // Offers from every attached neighbour, and from the subtree's
+            // own bridges in case none of them is attached any more
+            for (int bridge : subtree) {
+                pushOffers(bridge, heap);
+                for (int linkId : bridges[bridge].links) {
+                    const Link& l = links[linkId];
+                    if (!l.up || l.a == l.b) {
+                        continue;
+                    }
+                    const bool fromB = l.a == bridge;
+                    heap.push_back(offerAcross(linkId, fromB));
+                    std::push_heap(heap.begin(), heap.end(), worseOffer<Offer>);
+                }
+            }
+        }
+    }
+    settle(heap, touched, touchedList);
+    assignRoles(touchedList);
+}
+
+std::vector<PortRoleChange> SpanningTree::takeChanges() {
+    std::vector<PortRoleChange> taken;
+    taken.swap(changes);
+    return taken;
+}
@@ -0,0 +1,208 @@
+#ifndef SPANNING_TREE_H
+#define SPANNING_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Role of a linked port in the spanning tree (802.1w)
+ */
+enum class PortRole {
+    Disabled,       // Link is down
+    Root,           // Best path towards the root bridge (forwarding)
+    Designated,     // Best bridge on its link to reach the root (forwarding)
+    Alternate,      // Another path to the root, kept blocked (discarding)
+    Backup          // Second port of one bridge on the same link (discarding)
+};
+
+/**
+ * @brief True for the roles whose port forwards frames
+ */
+inline bool isForwardingRole(PortRole role) {
+    return role == PortRole::Root || role == PortRole::Designated;
+}
+
+/**
+ * @brief A port whose role changed during an update
+ */
+struct PortRoleChange {
+    int bridge;
+    int port;
+    PortRole previous;
+    PortRole current;
+};
+
+/**
+ * @brief Rapid spanning tree computed over a known set of bridges and links
+ *
+ * Computes the port roles RSTP converges to: the bridge with the lowest
+ * bridge ID (priority, then index) becomes root, every other bridge picks
+ * the port with the best priority vector (root ID, root path cost,
+ * designated bridge ID, designated port, receiving port) as its root port,
+ * and on each link the end advertising the better vector is designated.
+ * All other linked ports are alternate or backup ports and discard.
+ *
+ * Instead of exchanging BPDUs the vectors are settled directly, with a
+ * Dijkstra-style pass over offers ordered by vector. Link changes are
+ * incremental:
+ * - A link that was not on anyone's root path going down only disables
+ *   its two ports.
+ * - A root-path link going down resets just the subtree below it, seeds it
+ *   with offers from still-attached neighbours and resettles it (the subtree
+ *   elects its own root if nothing reaches it).
+ * - A link coming up pushes the offers it creates and resettles only the
+ *   bridges they improve.
+ * Roles are then recomputed for the links of the bridges that were
+ * touched. Either way the result equals a full compute().
+ */
+class SpanningTree {
+public:
+    // 802.1D default bridge priority
+    static constexpr uint16_t kDefaultPriority = 32768;
+
+    /**
+     * @brief 802.1w recommended port path cost for a link speed
+     *
+     * 20 Tb/s divided by the link speed, so 10 Gb/s costs 2000.
+     */
+    static uint32_t pathCost(double bandwidthGbps);
+
+    /**
+     * @return The bridge's index (0, 1, 2, ...)
+     */
+    int addBridge(uint16_t priority = kDefaultPriority);
+
+    /**
+     * @brief Changes a bridge's priority (takes effect at the next compute())
+     *
+     * @throws std::invalid_argument if the bridge does not exist
+     */
+    void setPriority(int bridge, uint16_t priority);
+
+    /**
+     * @brief Adds a link that is up
+     *
+     * @return The link's index (0, 1, 2, ...)
+     * @throws std::invalid_argument if a bridge does not exist, a port is
+     *         below 1 or the cost is 0
+     */
+    int addLink(int bridgeA, int portA, int bridgeB, int portB, uint32_t cost);
+
+    /**
+     * @brief Settles every bridge from scratch
+     */
+    void compute();
+
+    /**
+     * @brief Takes a link down or brings it back, reconverging incrementally
+     *
+     * @throws std::invalid_argument if the link does not exist
+     */
+    void setLinkUp(int link, bool up);
+
+    bool isLinkUp(int link) const { return links.at(link).up; }
+
+    /**
+     * @brief Role of one end of a link
+     *
+     * @param sideB false for the A end as passed to addLink(), true for B
+     */
+    PortRole getRole(int link, bool sideB) const {
+        return sideB ? links.at(link).roleB : links.at(link).roleA;
+    }
+
+    /**
+     * @brief Root of the tree a bridge belongs to
+     */
+    int getRootBridge(int bridge) const {
+        return static_cast<int>(bridges.at(bridge).best.root & kIndexMask);
+    }
+
+    uint64_t getRootPathCost(int bridge) const { return bridges.at(bridge).best.cost; }
+
+    /**
+     * @brief The bridge's root port, or 0 on a root bridge
+     */
+    int getRootPort(int bridge) const {
+        return bridges.at(bridge).rootLink < 0 ? 0 : static_cast<int>(bridges[bridge].best.receivePort);
+    }
+
+    /**
+     * @brief Role changes since the last call, in the order they happened
+     */
+    std::vector<PortRoleChange> takeChanges();
+
+    /**
+     * @brief Bridges whose vector or ports the last update looked at
+     */
+    std::size_t getLastUpdateSize() const { return lastUpdateSize; }
+
+    /**
+     * @brief Updates that moved a port into a forwarding role
+     */
+    uint64_t getTopologyChanges() const { return topologyChanges; }
+
+    int getBridgeCount() const { return static_cast<int>(bridges.size()); }
+    int getLinkCount() const { return static_cast<int>(links.size()); }
+
+private:
+    // Bridge IDs are priority << 48 | index
+    static constexpr uint64_t kIndexMask = (1ULL << 48) - 1;
+
+    struct Vector {
+        uint64_t root;
+        uint64_t cost;
+        uint64_t bridge;            // Designated bridge: the neighbour offering the path
+        uint32_t port;              // Designated port on that neighbour
+        uint32_t receivePort;       // Own port the offer came in on
+
+        bool operator<(const Vector& other) const;
+    };
+
+    struct Bridge {
+        uint64_t id;
+        Vector best;
+        int32_t rootLink = -1;      // Link the root port is on (-1 on a root bridge)
+        std::vector<int> links;
+    };
+
+    struct Link {
+        int a;
+        int portA;
+        int b;
+        int portB;
+        uint32_t cost;
+        bool up;
+        PortRole roleA;
+        PortRole roleB;
+    };
+
+    struct Offer {
+        Vector vector;
+        int bridge;
+        int link;
+    };
+
+    std::vector<Bridge> bridges;
+    std::vector<Link> links;
+    std::vector<PortRoleChange> changes;
+    std::size_t lastUpdateSize = 0;
+    uint64_t topologyChanges = 0;
+
+    Vector ownVector(const Bridge& bridge) const {
+        return Vector{bridge.id, 0, bridge.id, 0, 0};
+    }
+
+    /**
+     * @brief Vector a link carries from one of its ends to the other
+     */
+    Offer offerAcross(int link, bool fromB) const;
+
+    void pushOffers(int bridge, std::vector<Offer>& heap) const;
+    void settle(std::vector<Offer>& heap, std::vector<char>& touched, std::vector<int>& touchedList);
+    void assignRoles(const std::vector<int>& touchedList);
+    void setRole(Link& link, bool sideB, PortRole role, bool& forwardingAdded);
+};
+
+#endif // SPANNING_TREE_H
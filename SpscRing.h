@@ -0,0 +1,128 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer
+ *
+ * Models a NIC receive ring: the producer owns the tail index, the consumer
+ * owns the head index, and neither ever writes the other's. Each side keeps a
+ * private copy of the opposite index and only re-reads the shared one when
+ * the copy says the ring is full (or empty), so in steady state an item
+ * costs no cache-line transfers beyond the slot itself. The two indices live
+ * on separate cache lines to avoid false sharing.
+ *
+ * Indices are 64-bit and never wrap in practice; a slot is index & mask.
+ *
+ * @tparam T Trivially copyable element type
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @param capacity Minimum number of slots (rounded up to a power of two)
+     */
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t slots = 2;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        buffer.resize(slots);
+        mask = slots - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Producer side: appends one item
+     *
+     * @return false if the ring is full
+     */
+    bool tryPush(const T& item) {
+        return pushBulk(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Producer side: appends as many items as fit
+     *
+     * @return Number of items appended (0..count)
+     */
+    std::size_t pushBulk(const T* items, std::size_t count) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        std::size_t room = buffer.size() - static_cast<std::size_t>(t - cachedHead);
+        if (room < count) {
+            cachedHead = head.load(std::memory_order_acquire);
+            room = buffer.size() - static_cast<std::size_t>(t - cachedHead);
+        }
+        const std::size_t n = count < room ? count : room;
+        for (std::size_t i = 0; i < n; i++) {
+            buffer[(t + i) & mask] = items[i];
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Consumer side: removes one item
+     *
+     * @return false if the ring is empty
+     */
+    bool tryPop(T& item) {
+        return popBulk(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Consumer side: removes up to max items
+     *
+     * @return Number of items removed (0..max)
+     */
+    std::size_t popBulk(T* out, std::size_t max) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        std::size_t ready = static_cast<std::size_t>(cachedTail - h);
+        if (ready < max) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            ready = static_cast<std::size_t>(cachedTail - h);
+        }
+        const std::size_t n = max < ready ? max : ready;
+        for (std::size_t i = 0; i < n; i++) {
+            out[i] = buffer[(h + i) & mask];
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief True if nothing is queued (exact only when both sides are idle)
+     */
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Total items ever pushed
+     */
+    uint64_t produced() const { return tail.load(std::memory_order_acquire); }
+
+    std::size_t capacity() const { return buffer.size(); }
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    std::vector<T> buffer;
+    std::size_t mask;
+
+    // Consumer-owned
+    alignas(kCacheLine) std::atomic<uint64_t> head{0};
+    uint64_t cachedTail = 0;
+
+    // Producer-owned
+    alignas(kCacheLine) std::atomic<uint64_t> tail{0};
+    uint64_t cachedHead = 0;
+};
+
+#endif // SPSC_RING_H
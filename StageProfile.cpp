@@ -0,0 +1,131 @@
+#include "StageProfile.h"
+#include <iomanip>
+#include <thread>
+
+namespace {
+
+const char* const kStageNames[kStages] = {"classify", "learn", "decide", "report", "egress", "aging"};
+
+// Time the tick counter is compared against steady_clock for
+constexpr std::chrono::milliseconds kCalibration(20);
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    return kStageNames[static_cast<int>(stage)];
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    if (samples == 0) {
+        return 0;
+    }
+    const double rank = fraction * samples;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < kBuckets; bucket++) {
+        seen += counts[bucket];
+        if (counts[bucket] && seen >= rank) {
+            // Midpoint of the bucket, never past the largest value recorded
+            const uint64_t low = lowestOf(bucket);
+            const uint64_t width = bucket + 1 < kBuckets ? lowestOf(bucket + 1) - low : 1;
+            return std::min(low + width / 2, maximum);
+        }
+    }
+    return maximum;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int bucket = 0; bucket < kBuckets; bucket++) {
+        counts[bucket] += other.counts[bucket];
+    }
+    samples += other.samples;
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+void LatencyHistogram::clear() {
+    *this = LatencyHistogram();
+}
+
+double StageProfile::nsPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double measured = [] {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t first = ticks();
+        std::this_thread::sleep_for(kCalibration);
+        const uint64_t last = ticks();
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+        return last > first ? ns / (last - first) : 1.0;
+    }();
+    return measured;
+#else
+    return 1.0;
+#endif
+}
+
+void StageProfile::print(std::ostream& out) const {
+    const double scale = nsPerTick();
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::left << std::setw(10) << "Stage" << std::right
+        << std::setw(12) << "Samples" << std::setw(10) << "Mean ns"
+        << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(12) << "Max" << "\n";
+    out << std::string(74, '-') << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (int stage = 0; stage < kStages; stage++) {
+        const LatencyHistogram& histogram = stages[stage];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        out << std::left << std::setw(10) << kStageNames[stage] << std::right
+            << std::setw(12) << histogram.count()
+            << std::setw(10) << histogram.mean() * scale
+            << std::setw(10) << histogram.percentile(0.50) * scale
+            << std::setw(10) << histogram.percentile(0.99) * scale
+            << std::setw(10) << histogram.percentile(0.999) * scale
+            << std::setw(12) << histogram.max() * scale << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void StageProfile::writeJson(std::ostream& out) const {
+    const double scale = nsPerTick();
+#if defined(__x86_64__) || defined(__i386__)
+    const char* source = "rdtsc";
+#else
+    const char* source = "steady_clock";
+#endif
+    const std::streamsize precision = out.precision();
+    out << std::setprecision(6);
+    out << "{\n  \"tickSource\": \"" << source << "\",\n  \"nsPerTick\": " << scale
+        << ",\n  \"stages\": [";
+    for (int stage = 0; stage < kStages; stage++) {
+        const LatencyHistogram& histogram = stages[stage];
+        out << (stage ? ",\n" : "\n") << "    {\"stage\": \"" << kStageNames[stage] << "\""
+            << ", \"samples\": " << histogram.count()
+            << ", \"meanNs\": " << histogram.mean() * scale
+            << ", \"p50Ns\": " << histogram.percentile(0.50) * scale
+            << ", \"p90Ns\": " << histogram.percentile(0.90) * scale
+            << ", \"p99Ns\": " << histogram.percentile(0.99) * scale
+            << ", \"p999Ns\": " << histogram.percentile(0.999) * scale
+            << ", \"maxNs\": " << histogram.max() * scale
+            << ",\n     \"buckets\": [";
+        // Each bucket as [lowest ticks, count]
+        bool first = true;
+        histogram.forEachBucket([&](uint64_t low, uint64_t count) {
+            out << (first ? "" : ", ") << "[" << low << ", " << count << "]";
+            first = false;
+        });
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+    out.precision(precision);
+}
+
+void StageProfile::clear() {
+    for (LatencyHistogram& histogram : stages) {
+        histogram.clear();
+    }
+}
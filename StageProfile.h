@@ -0,0 +1,228 @@
+#ifndef STAGE_PROFILE_H
+#define STAGE_PROFILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Hot-path instrumentation, compiled in with -DL2SIM_INSTRUMENT
+ *
+ * Without the macro the stage clock and tracepoint macros below expand to
+ * nothing and Switch carries no profile, so an uninstrumented build is the
+ * same code as before. With it, each stage of the forwarding path is timed
+ * with the CPU's time-stamp counter and recorded in a StageProfile, and, if
+ * <sys/sdt.h> is available, USDT probes are placed at learn and decision
+ * points for `perf probe sdt_l2sim:*` or bpftrace.
+ */
+
+/**
+ * @brief Pieces of the forwarding path timed separately
+ */
+enum class Stage {
+    Classify,   // VLAN classification and ingress checks
+    Learn,      // MAC table learn (hash, probe and insert/refresh)
+    Decide,     // Destination lookup and egress set
+    Report,     // Statistics counters and observer events
+    Egress,     // Copying into the buffer pool and queueing on ports
+    Aging       // One aging pass (per call, not per frame)
+};
+
+constexpr int kStages = 6;
+
+const char* stageName(Stage stage);
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram
+ *
+ * Values below 32 have a bucket each; above that every power of two is split
+ * into 32 buckets, so a recorded value is known to within 1/32 (about 3%) of
+ * itself whatever its magnitude. Recording is a count-leading-zeros, a shift
+ * and an increment. Values of 2^40 ticks and more share the last bucket.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxBits = 40;
+    static constexpr int kBuckets = kSubBuckets * (kMaxBits - kSubBucketBits + 1);
+
+    /**
+     * @brief Adds a value, times times (an amortized sample stands for several frames)
+     */
+    void record(uint64_t value, uint64_t times = 1) {
+        counts[bucketOf(value)] += times;
+        samples += times;
+        sum += value * times;
+        if (value > maximum) {
+            maximum = value;
+        }
+    }
+
+    uint64_t count() const { return samples; }
+    uint64_t max() const { return maximum; }
+    double mean() const { return samples ? static_cast<double>(sum) / samples : 0.0; }
+
+    /**
+     * @brief Value at or below which fraction of the samples lie (0 when empty)
+     *
+     * Reported as the midpoint of the bucket the rank falls in.
+     */
+    uint64_t percentile(double fraction) const;
+
+    /**
+     * @brief Calls fn(lowest value, count) for every non-empty bucket
+     */
+    template <typename Fn>
+    void forEachBucket(Fn fn) const {
+        for (int bucket = 0; bucket < kBuckets; bucket++) {
+            if (counts[bucket]) {
+                fn(lowestOf(bucket), counts[bucket]);
+            }
+        }
+    }
+
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    static constexpr int bucketOf(uint64_t value) {
+        if (value < static_cast<uint64_t>(kSubBuckets)) {
+            return static_cast<int>(value);
+        }
+        const int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+        // Values in [2^(kMaxBits-1), 2^kMaxBits) have shift kMaxBits - kSubBucketBits - 1
+        if (shift >= kMaxBits - kSubBucketBits) {
+            return kBuckets - 1;
+        }
+        return kSubBuckets * (shift + 1) + static_cast<int>((value >> shift) - kSubBuckets);
+    }
+
+    static constexpr uint64_t lowestOf(int bucket) {
+        if (bucket < kSubBuckets) {
+            return static_cast<uint64_t>(bucket);
+        }
+        const int shift = bucket / kSubBuckets - 1;
+        return static_cast<uint64_t>(bucket % kSubBuckets + kSubBuckets) << shift;
+    }
+
+private:
+    uint64_t counts[kBuckets] = {};
+    uint64_t samples = 0;
+    uint64_t sum = 0;
+    uint64_t maximum = 0;
+};
+
+static_assert(LatencyHistogram::bucketOf((1ULL << LatencyHistogram::kMaxBits) - 1) ==
+                  LatencyHistogram::kBuckets - 1 &&
+              LatencyHistogram::bucketOf(1ULL << LatencyHistogram::kMaxBits) ==
+                  LatencyHistogram::kBuckets - 1 &&
+              LatencyHistogram::bucketOf(~0ULL) == LatencyHistogram::kBuckets - 1,
+              "LatencyHistogram: values of 2^kMaxBits and more must share the last bucket");
+
+/**
+ * @brief Per-stage latency histograms of one switch
+ *
+ * Times are kept in ticks of the time-stamp counter (steady_clock
+ * nanoseconds on other CPUs) and converted to nanoseconds for reporting.
+ * A profile belongs to the thread that processes the switch's frames.
+ */
+class StageProfile {
+public:
+    /**
+     * @brief Current tick count
+     */
+    static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Length of a tick, measured against steady_clock on first use
+     */
+    static double nsPerTick();
+
+    /**
+     * @brief Records the time a stage took for some frames
+     *
+     * A stage run once for a whole burst records its per-frame share, once
+     * per frame, so bursts and single frames land in the same histogram.
+     */
+    void record(Stage stage, uint64_t elapsed, uint64_t frames = 1) {
+        if (frames > 0) {
+            stages[static_cast<int>(stage)].record(elapsed / frames, frames);
+        }
+    }
+
+    const LatencyHistogram& get(Stage stage) const { return stages[static_cast<int>(stage)]; }
+
+    /**
+     * @brief Prints count, mean, p50/p99/p99.9 and max per stage, in ns
+     */
+    void print(std::ostream& out) const;
+
+    /**
+     * @brief Writes every stage's summary and non-empty buckets as JSON
+     */
+    void writeJson(std::ostream& out) const;
+
+    void clear();
+
+private:
+    LatencyHistogram stages[kStages];
+};
+
+/**
+ * @brief Lap timer: each lap() charges the time since the previous one to a stage
+ */
+class StageClock {
+public:
+    StageClock() : last(StageProfile::ticks()) {}
+
+    void lap(StageProfile& profile, Stage stage, uint64_t frames = 1) {
+        const uint64_t now = StageProfile::ticks();
+        profile.record(stage, now - last, frames);
+        last = now;
+    }
+
+    /**
+     * @brief Restarts the lap without charging anything
+     */
+    void skip() { last = StageProfile::ticks(); }
+
+private:
+    uint64_t last;
+};
+
+#ifdef L2SIM_INSTRUMENT
+#define L2SIM_STAGE_CLOCK(clock) StageClock clock
+#define L2SIM_STAGE_LAP(clock, profile, stage, frames) (clock).lap((profile), (stage), (frames))
+#define L2SIM_STAGE_SKIP(clock) (clock).skip()
+#else
+#define L2SIM_STAGE_CLOCK(clock) ((void)0)
+#define L2SIM_STAGE_LAP(clock, profile, stage, frames) ((void)0)
+#define L2SIM_STAGE_SKIP(clock) ((void)0)
+#endif
+
+// USDT tracepoints, provider "l2sim"
+#if defined(L2SIM_INSTRUMENT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define L2SIM_TRACE2(name, a, b) DTRACE_PROBE2(l2sim, name, a, b)
+#define L2SIM_TRACE3(name, a, b, c) DTRACE_PROBE3(l2sim, name, a, b, c)
+#endif
+#endif
+#ifndef L2SIM_TRACE2
+#define L2SIM_TRACE2(name, a, b) ((void)0)
+#define L2SIM_TRACE3(name, a, b, c) ((void)0)
+#endif
+
+#endif // STAGE_PROFILE_H
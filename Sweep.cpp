@@ -0,0 +1,355 @@
+#include "Sweep.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "FrameView.h"
+#include "PortMask.h"
+#include "Switch.h"
+#include "TrafficGenerator.h"
+
+namespace {
+
+// Frames per processBurst() call within a run
+constexpr std::size_t kBurst = 32;
+
+// Mixes a 64-bit value (SplitMix64 finalizer), so neighbouring run indices
+// get unrelated seeds
+uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Per-worker slices of run indices that idle workers steal from
+ *
+ * A slice is [begin, end) packed in one atomic word. The owner advances
+ * begin; a thief lowers end. Both are a CAS on the whole word, so an owner
+ * and a thief racing for the last run cannot both get it.
+ */
+class StealingSlices {
+public:
+    StealingSlices(std::size_t count, int workers)
+        : slices(new Slice[workers]), workers(workers) {
+        for (int w = 0; w < workers; w++) {
+            slices[w].bounds.store(pack(count * w / workers, count * (w + 1) / workers),
+                                   std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Next run for a worker: its own, or a stolen one
+     *
+     * @return false once no slice has work left
+     */
+    bool next(int worker, std::size_t& index, uint64_t& stolen) {
+        for (;;) {
+            if (take(slices[worker].bounds, index)) {
+                return true;
+            }
+            if (!steal(worker)) {
+                return false;
+            }
+            stolen++;
+        }
+    }
+
+private:
+    struct alignas(64) Slice {
+        std::atomic<uint64_t> bounds;
+    };
+
+    std::unique_ptr<Slice[]> slices;
+    int workers;
+
+    static uint64_t pack(std::size_t begin, std::size_t end) {
+        return (static_cast<uint64_t>(begin) << 32) | static_cast<uint32_t>(end);
+    }
+    static std::size_t beginOf(uint64_t bounds) { return bounds >> 32; }
+    static std::size_t endOf(uint64_t bounds) { return bounds & 0xFFFFFFFFu; }
+
+    static bool take(std::atomic<uint64_t>& slice, std::size_t& index) {
+        uint64_t bounds = slice.load(std::memory_order_acquire);
+        while (beginOf(bounds) < endOf(bounds)) {
+            if (slice.compare_exchange_weak(bounds, pack(beginOf(bounds) + 1, endOf(bounds)),
+                                            std::memory_order_acq_rel)) {
+                index = beginOf(bounds);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Moves the back half of the fullest other slice into the worker's own
+    bool steal(int worker) {
+        for (;;) {
+            int victim = -1;
+            uint64_t bounds = 0;
+            std::size_t most = 0;
+            for (int w = 0; w < workers; w++) {
+                const uint64_t candidate = slices[w].bounds.load(std::memory_order_acquire);
+                const std::size_t left = endOf(candidate) - std::min(beginOf(candidate), endOf(candidate));
+                if (w != worker && left > most) {
+                    victim = w;
+                    bounds = candidate;
+                    most = left;
+                }
+            }
+            if (victim < 0) {
+                return false;
+            }
+            const std::size_t split = endOf(bounds) - (most + 1) / 2;
+            if (slices[victim].bounds.compare_exchange_strong(bounds, pack(beginOf(bounds), split),
+                                                              std::memory_order_acq_rel)) {
+                // The own slice is empty, so no thief is working on it
+                slices[worker].bounds.store(pack(split, endOf(bounds)), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * @brief What one worker produces besides results: its own summaries
+ */
+struct alignas(64) WorkerTotals {
+    std::vector<SweepSummary> summaries;
+    uint64_t steals = 0;
+};
+
+template <typename T>
+void requireValues(const std::vector<T>& values, const char* name) {
+    if (values.empty()) {
+        throw std::invalid_argument(std::string("SweepRunner: no ") + name + " values");
+    }
+}
+
+} // namespace
+
+void SweepSummary::add(const SweepResult& result) {
+    const double flood = result.floodPercent();
+    floodMin = runs ? std::min(floodMin, flood) : flood;
+    floodMax = runs ? std::max(floodMax, flood) : flood;
+    runs++;
+    frames += result.frames;
+    learned += result.learned;
+    moves += result.moves;
+    flooded += result.flooded;
+    tableFull += result.tableFull;
+    evictions += result.evictions;
+    tableSizeTotal += result.tableSize;
+    tableSizeMax = std::max<uint64_t>(tableSizeMax, result.tableSize);
+    seconds += result.seconds;
+}
+
+void SweepSummary::merge(const SweepSummary& other) {
+    if (other.runs == 0) {
+        return;
+    }
+    floodMin = runs ? std::min(floodMin, other.floodMin) : other.floodMin;
+    floodMax = runs ? std::max(floodMax, other.floodMax) : other.floodMax;
+    runs += other.runs;
+    frames += other.frames;
+    learned += other.learned;
+    moves += other.moves;
+    flooded += other.flooded;
+    tableFull += other.tableFull;
+    evictions += other.evictions;
+    tableSizeTotal += other.tableSizeTotal;
+    tableSizeMax = std::max(tableSizeMax, other.tableSizeMax);
+    seconds += other.seconds;
+}
+
+SweepRunner::SweepRunner(const SweepConfig& sweepConfig) : config(sweepConfig) {
+    requireValues(config.ports, "port count");
+    requireValues(config.agingTimeouts, "aging timeout");
+    requireValues(config.stations, "station count");
+    requireValues(config.moveRates, "move rate");
+    for (int ports : config.ports) {
+        if (ports < 1 || ports > PortMask::kMaxPorts) {
+            throw std::invalid_argument("SweepRunner: port count must be between 1 and " +
+                                        std::to_string(PortMask::kMaxPorts));
+        }
+    }
+    for (std::size_t stations : config.stations) {
+        if (stations == 0) {
+            throw std::invalid_argument("SweepRunner: station count must be positive");
+        }
+    }
+    if (config.replicas < 1 || config.framesPerCycle == 0) {
+        throw std::invalid_argument("SweepRunner: replicas and frames per cycle must be positive");
+    }
+    pointCount = config.ports.size() * config.agingTimeouts.size() *
+                 config.stations.size() * config.moveRates.size();
+    if (runs() >= 0xFFFFFFFFu) {
+        throw std::invalid_argument("SweepRunner: too many runs in one sweep");
+    }
+}
+
+SweepRun SweepRunner::describe(std::size_t index) const {
+    SweepRun run;
+    run.index = index;
+    run.point = index / config.replicas;
+    run.replica = static_cast<int>(index % config.replicas);
+
+    // Mixed-radix digits of the point, move rate varying fastest
+    std::size_t digits = run.point;
+    run.moveRate = config.moveRates[digits % config.moveRates.size()];
+    digits /= config.moveRates.size();
+    run.stations = config.stations[digits % config.stations.size()];
+    digits /= config.stations.size();
+    run.agingTimeout = config.agingTimeouts[digits % config.agingTimeouts.size()];
+    digits /= config.agingTimeouts.size();
+    run.ports = config.ports[digits];
+
+    run.seed = mix(config.seed ^ mix(index));
+    return run;
+}
+
+SweepResult SweepRunner::simulate(const SweepConfig& config, const SweepRun& run) {
+    TrafficConfig traffic;
+    traffic.stations = run.stations;
+    traffic.numPorts = run.ports;
+    traffic.zipfSkew = config.zipfSkew;
+    traffic.broadcastRatio = config.broadcastRatio;
+    traffic.moveRate = run.moveRate;
+    traffic.seed = run.seed;
+    TrafficGenerator generator(traffic);
+
+    SwitchConfig switchConfig;
+    switchConfig.numPorts = run.ports;
+    switchConfig.agingTimeout = run.agingTimeout;
+    switchConfig.agingClock = AgingClock::Logical;
+    switchConfig.tableEngine = config.engine;
+    switchConfig.tableCapacity = config.capacity > 0 ? config.capacity : run.stations;
+    switchConfig.tableEviction = config.eviction;
+    switchConfig.agingBudgetPerBurst = 256;
+    switchConfig.observer = nullptr;
+    Switch sw(switchConfig);
+
+    // Bursts end at cycle boundaries, so every burst has one timestamp
+    FrameView frames[kBurst];
+    int ports[kBurst];
+    ForwardDecision decisions[kBurst];
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < config.frames; ) {
+        const std::size_t cycleEnd = (sent / config.framesPerCycle + 1) * config.framesPerCycle;
+        const std::size_t n = std::min({kBurst, config.frames - sent, cycleEnd - sent});
+        for (std::size_t i = 0; i < n; i++) {
+            const TrafficRecord record = generator.next();
+            frames[i].sourceMAC = record.sourceMAC;
+            frames[i].destMAC = record.destMAC;
+            ports[i] = record.port;
+        }
+        sw.processBurst(frames, ports, n, decisions);
+        sent += n;
+        if (sent == cycleEnd) {
+            sw.advanceCycle();
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const PortStatistics stats = sw.getStatistics();
+    SweepResult result;
+    result.run = run;
+    result.frames = stats.frames();
+    result.learned = stats.learned;
+    result.moves = stats.moves;
+    result.forwarded = stats.of(ForwardKind::Forward);
+    result.flooded = stats.flooded();
+    result.filtered = stats.of(ForwardKind::Filter);
+    result.tableFull = stats.tableFull;
+    result.evictions = stats.evictions;
+    result.tableSize = static_cast<std::size_t>(sw.getMACTableSize());
+    result.seconds = seconds;
+    return result;
+}
+
+void SweepRunner::run(int requested) {
+    const std::size_t count = runs();
+    threads = requested > 0 ? requested : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = static_cast<int>(std::min<std::size_t>(threads, std::max<std::size_t>(count, 1)));
+
+    results.assign(count, SweepResult{});
+    std::vector<WorkerTotals> totals(threads);
+    StealingSlices slices(count, threads);
+
+    // Each result slot is written by the one worker that ran it
+    auto work = [&](int worker) {
+        WorkerTotals& own = totals[worker];
+        own.summaries.assign(pointCount, SweepSummary{});
+        std::size_t index;
+        while (slices.next(worker, index, own.steals)) {
+            results[index] = simulate(config, describe(index));
+            own.summaries[results[index].run.point].add(results[index]);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; w++) {
+        pool.emplace_back(work, w);
+    }
+    work(0);
+    for (std::thread& worker : pool) {
+        worker.join();
+    }
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    summaries.assign(pointCount, SweepSummary{});
+    steals = 0;
+    for (const WorkerTotals& own : totals) {
+        for (std::size_t point = 0; point < pointCount; point++) {
+            summaries[point].merge(own.summaries[point]);
+        }
+        steals += own.steals;
+    }
+}
+
+void SweepRunner::writeResultsCsv(std::ostream& out, bool timing) const {
+    out << "run,point,replica,ports,aging,stations,move_rate,seed,frames,learned,moves,"
+           "forwarded,flooded,filtered,table_full,evictions,table_size,flood_pct";
+    out << (timing ? ",seconds\n" : "\n");
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    for (const SweepResult& r : results) {
+        out << r.run.index << "," << r.run.point << "," << r.run.replica << ","
+            << r.run.ports << "," << r.run.agingTimeout << "," << r.run.stations << ","
+            << std::defaultfloat << std::setprecision(6) << r.run.moveRate << ","
+            << r.run.seed << "," << r.frames << "," << r.learned << "," << r.moves << ","
+            << r.forwarded << "," << r.flooded << "," << r.filtered << "," << r.tableFull << ","
+            << r.evictions << "," << r.tableSize << ","
+            << std::fixed << std::setprecision(4) << r.floodPercent();
+        if (timing) {
+            out << "," << std::setprecision(6) << r.seconds;
+        }
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void SweepRunner::writeSummaryCsv(std::ostream& out) const {
+    out << "point,ports,aging,stations,move_rate,runs,frames,learned,moves,flooded,table_full,"
+           "evictions,mean_table_size,max_table_size,flood_pct,flood_pct_min,flood_pct_max\n";
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    for (std::size_t point = 0; point < summaries.size(); point++) {
+        const SweepRun run = describe(point * config.replicas);
+        const SweepSummary& s = summaries[point];
+        out << point << "," << run.ports << "," << run.agingTimeout << "," << run.stations << ","
+            << std::defaultfloat << std::setprecision(6) << run.moveRate << ","
+            << s.runs << "," << s.frames << "," << s.learned << "," << s.moves << ","
+            << s.flooded << "," << s.tableFull << "," << s.evictions << ","
+            << std::fixed << std::setprecision(1) << s.meanTableSize() << "," << s.tableSizeMax << ","
+            << std::setprecision(4) << s.floodPercent() << "," << s.floodMin << "," << s.floodMax << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,183 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "MacTable.h"
+
+/**
+ * @brief A parameter grid and the traffic every run in it replays
+ *
+ * The grid is the cross product of the four lists; each grid point is run
+ * replicas times with different traffic seeds.
+ */
+struct SweepConfig {
+    std::vector<int> ports = {48};              // Switch port counts
+    std::vector<int> agingTimeouts = {300};     // Aging timeouts in cycles (0 = no aging)
+    std::vector<std::size_t> stations = {10000}; // MAC population sizes
+    std::vector<double> moveRates = {0.0};      // Station move probabilities per frame
+    int replicas = 4;                           // Runs per grid point
+    std::size_t frames = 200000;                // Frames per run
+    uint64_t framesPerCycle = 1000;             // Traffic rate, which sets how fast entries age
+    double zipfSkew = 1.0;                      // Destination popularity skew
+    double broadcastRatio = 0.01;               // Fraction of broadcast frames
+    TableEngine engine = TableEngine::Flat;     // MAC table engine of every switch
+    std::size_t capacity = 0;                   // Table capacity (0 = the run's population)
+    EvictionPolicy eviction = EvictionPolicy::NoLearn;
+    uint64_t seed = 1;                          // Base seed every run's seed is derived from
+};
+
+/**
+ * @brief Parameters of one run of a sweep
+ */
+struct SweepRun {
+    std::size_t index;          // Position in the sweep (point * replicas + replica)
+    std::size_t point;          // Grid point
+    int replica;
+    int ports;
+    int agingTimeout;
+    std::size_t stations;
+    double moveRate;
+    uint64_t seed;              // Seed of the run's traffic generator
+};
+
+/**
+ * @brief Outcome of one run
+ *
+ * Everything but seconds depends only on the run's parameters and seed.
+ */
+struct SweepResult {
+    SweepRun run;
+    uint64_t frames = 0;
+    uint64_t learned = 0;
+    uint64_t moves = 0;
+    uint64_t forwarded = 0;
+    uint64_t flooded = 0;
+    uint64_t filtered = 0;
+    uint64_t tableFull = 0;
+    uint64_t evictions = 0;
+    std::size_t tableSize = 0;  // MAC entries at the end of the run
+    double seconds = 0.0;       // Wall-clock time of the replay
+
+    double floodPercent() const { return frames ? 100.0 * flooded / frames : 0.0; }
+};
+
+/**
+ * @brief Results of one grid point, accumulated over its replicas
+ *
+ * Only sums, minima and maxima are kept, so accumulating results and
+ * merging summaries give the same values in any order.
+ */
+struct SweepSummary {
+    uint64_t runs = 0;
+    uint64_t frames = 0;
+    uint64_t learned = 0;
+    uint64_t moves = 0;
+    uint64_t flooded = 0;
+    uint64_t tableFull = 0;
+    uint64_t evictions = 0;
+    uint64_t tableSizeTotal = 0;
+    uint64_t tableSizeMax = 0;
+    double floodMin = 0.0;      // Lowest per-run flood percentage
+    double floodMax = 0.0;      // Highest per-run flood percentage
+    double seconds = 0.0;       // Replay time, summed
+
+    void add(const SweepResult& result);
+    void merge(const SweepSummary& other);
+
+    /**
+     * @brief Flood percentage over all frames of the point
+     */
+    double floodPercent() const { return frames ? 100.0 * flooded / frames : 0.0; }
+
+    double meanTableSize() const { return runs ? static_cast<double>(tableSizeTotal) / runs : 0.0; }
+};
+
+/**
+ * @brief Runs every point of a parameter grid on a work-stealing thread pool
+ *
+ * Each run builds its own Switch and TrafficGenerator, seeded from the base
+ * seed and its index alone, so runs share nothing and a sweep gives the same
+ * results with any thread count.
+ *
+ * Workers start with equal contiguous slices of the run indices. A worker
+ * takes runs from the front of its own slice and, when that is empty,
+ * steals the back half of the largest remaining slice. Each slice is one
+ * 64-bit atomic (begin and end), so taking and stealing are single CAS
+ * operations and no lock is shared. Results are stored by run index and
+ * every worker accumulates grid point summaries of its own; the summaries
+ * are merged once the workers have finished.
+ */
+class SweepRunner {
+public:
+    /**
+     * @throws std::invalid_argument if a parameter list is empty, a value is
+     *         out of range, or the sweep has more than 2^32 - 1 runs
+     */
+    explicit SweepRunner(const SweepConfig& config);
+
+    /**
+     * @brief Runs the whole sweep
+     *
+     * @param threads Worker threads (0 = one per hardware thread)
+     */
+    void run(int threads = 0);
+
+    /**
+     * @brief Replays one run's traffic through a fresh switch
+     */
+    static SweepResult simulate(const SweepConfig& config, const SweepRun& run);
+
+    /**
+     * @brief Parameters of the run at an index
+     */
+    SweepRun describe(std::size_t index) const;
+
+    std::size_t points() const { return pointCount; }
+    std::size_t runs() const { return pointCount * static_cast<std::size_t>(config.replicas); }
+    const SweepConfig& getConfig() const { return config; }
+
+    /**
+     * @brief One result per run, in index order
+     */
+    const std::vector<SweepResult>& getResults() const { return results; }
+
+    /**
+     * @brief One summary per grid point
+     */
+    const std::vector<SweepSummary>& getSummaries() const { return summaries; }
+
+    int getThreads() const { return threads; }
+    double getSeconds() const { return elapsed; }
+
+    /**
+     * @brief Number of times a worker took runs from another worker's slice
+     */
+    uint64_t getSteals() const { return steals; }
+
+    /**
+     * @brief Writes one CSV row per run
+     *
+     * @param timing Add the replay time column (the only one that varies
+     *        between identical sweeps)
+     */
+    void writeResultsCsv(std::ostream& out, bool timing = false) const;
+
+    /**
+     * @brief Writes one CSV row per grid point
+     */
+    void writeSummaryCsv(std::ostream& out) const;
+
+private:
+    SweepConfig config;
+    std::size_t pointCount;
+    std::vector<SweepResult> results;
+    std::vector<SweepSummary> summaries;
+    int threads = 0;
+    double elapsed = 0.0;
+    uint64_t steals = 0;
+};
+
+#endif // SWEEP_H
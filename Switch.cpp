@@ -1,199 +1,924 @@
 #include "Switch.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "TableSnapshot.h"
 
 // ANSI color codes for better output readability
 #define RESET   "\033[0m"
-#define RED     "\033[31m"
-#define GREEN   "\033[32m"
-#define YELLOW  "\033[33m"
-#define BLUE    "\033[34m"
-#define MAGENTA "\033[35m"
 #define CYAN    "\033[36m"
 
-Switch::Switch(int ports, int timeout) 
-    : numPorts(ports), agingTimeout(timeout), currentCycle(0),
-      framesProcessed(0), learningEvents(0), forwardingEvents(0), floodingEvents(0) {
-    std::cout << CYAN << "╔════════════════════════════════════════════════╗\n";
-    std::cout << "║  Layer 2 Ethernet Learning Switch Simulator    ║\n";
-    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
-    std::cout << "Switch initialized with " << numPorts << " ports\n";
+namespace {
+
+// Byte count in the largest binary unit that keeps it at least 1, e.g. "1.50 MiB"
+std::string formatBytes(std::size_t bytes) {
+    static const char* const kUnits[] = {"bytes", "KiB", "MiB", "GiB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream text;
+    if (unit == 0) {
+        text << bytes << " " << kUnits[0];
+    } else {
+        text << std::fixed << std::setprecision(2) << value << " " << kUnits[unit];
+    }
+    return text.str();
+}
+
+} // namespace
+
+Switch::Switch(int ports, int timeout)
+    : Switch(SwitchConfig{ports, timeout}) {}
+
+Switch::Switch(const SwitchConfig& config)
+    : macTable(MacTable::create(config.tableEngine, config.tableCapacity, config.tableEviction)),
+      numPorts(config.numPorts), allPorts(PortMask::firstPorts(config.numPorts)),
+      portVlan(std::max(config.numPorts, 0), FdbKey::kDefaultVlan),
+      learningPorts(allPorts), forwardingPorts(allPorts),
+      agingTimeout(config.agingTimeout), agingClock(config.agingClock),
+      agingBudgetPerBurst(config.agingBudgetPerBurst),
+      startTime(std::chrono::steady_clock::now()), currentCycle(0),
+      observer(config.observer), egressBacklog(0),
+      framesProcessed(0), counters(std::clamp(config.numPorts, 0, PortMask::kMaxPorts)),
+      groupTable(static_cast<uint32_t>(std::max(config.groupTimeout, 0))),
+      multicastSnooping(config.multicastSnooping), groupsExpiredAt(0),
+      aggregation(std::clamp(config.numPorts, 0, PortMask::kMaxPorts)), lagHash(config.lagHash) {
+    if (numPorts < 1 || numPorts > PortMask::kMaxPorts) {
+        throw std::invalid_argument("Switch: port count must be between 1 and " +
+                                    std::to_string(PortMask::kMaxPorts));
+    }
+    // Every port starts untagged in the default VLAN
+    vlanPorts.resize(FdbKey::kDefaultVlan + 1);
+    vlanPorts[FdbKey::kDefaultVlan] = allPorts;
     if (agingTimeout > 0) {
-        std::cout << "MAC aging enabled: " << agingTimeout << " seconds\n";
+        agingWheel = std::make_unique<AgingWheel>(static_cast<uint32_t>(agingTimeout));
+    }
+    if (config.packetBuffers > 0) {
+        packetPool = std::make_unique<PacketPool>(config.packetBuffers, config.packetBufferSize);
+        outputPorts.assign(numPorts, EgressPort(config.egress));
+    }
+    if (observer) {
+        observer->onSwitchCreated(numPorts, agingTimeout, agingClock);
     }
-    std::cout << std::string(50, '-') << "\n\n";
 }
 
-void Switch::processFrame(const Frame& frame, int incomingPort) {
-    processFrame(frame.sourceMAC, frame.destMAC, incomingPort);
+ForwardDecision Switch::processFrame(const Frame& frame, int incomingPort) {
+    return processFrame(frame.view(), incomingPort);
+}
+
+ForwardDecision Switch::processFrame(MacAddress sourceMAC, MacAddress destMAC, int incomingPort) {
+    // A header-only frame; no payload to copy if it is queued for egress
+    FrameView frame;
+    frame.destMAC = destMAC;
+    frame.sourceMAC = sourceMAC;
+    frame.etherType = EtherType::kIPv4;
+    return processFrame(frame, incomingPort);
+}
+
+ForwardDecision Switch::processFrame(const std::string& sourceMAC, const std::string& destMAC, int incomingPort) {
+    return processFrame(MacAddress::fromString(sourceMAC), MacAddress::fromString(destMAC), incomingPort);
 }
 
-void Switch::processFrame(const std::string& sourceMAC, const std::string& destMAC, int incomingPort) {
+ForwardDecision Switch::processFrame(const FrameView& frame, int incomingPort) {
+    const MacAddress sourceMAC = frame.sourceMAC;
+    const MacAddress destMAC = frame.destMAC;
     framesProcessed++;
+    counters.countBytes(incomingPort, frame.wireLength());
     
-    std::cout << BLUE << "Frame #" << framesProcessed << " received on Port " << incomingPort << RESET << "\n";
-    std::cout << "  Source MAC: " << GREEN << sourceMAC << RESET << "\n";
-    std::cout << "  Dest MAC:   " << YELLOW << destMAC << RESET << "\n";
-    
-    // Step 1: LEARNING PHASE
-    // Associate the source MAC with the incoming port
-    auto it = macTable.find(sourceMAC);
-    if (it == macTable.end()) {
-        // New MAC address - add to table
-        macTable.emplace(sourceMAC, MACTableEntry(incomingPort));
-        learningEvents++;
-        std::cout << "  " << GREEN << "✓ LEARNING:" << RESET 
-                  << " Added " << sourceMAC << " -> Port " << incomingPort << "\n";
-    } else if (it->second.port != incomingPort) {
-        // MAC moved to a different port - update
-        std::cout << "  " << YELLOW << "⚠ UPDATE:" << RESET 
-                  << " " << sourceMAC << " moved from Port " 
-                  << it->second.port << " to Port " << incomingPort << "\n";
-        it->second.port = incomingPort;
-        it->second.timestamp = std::chrono::steady_clock::now();
-    } else {
-        // MAC seen again on same port - refresh timestamp
-        it->second.timestamp = std::chrono::steady_clock::now();
-        std::cout << "  " << "↻ REFRESH:" << " " << sourceMAC 
-                  << " timestamp updated on Port " << incomingPort << "\n";
+    if (observer) {
+        observer->onFrameReceived(framesProcessed, sourceMAC, destMAC, incomingPort);
+    }
+    L2SIM_STAGE_CLOCK(stageClock);
+    
+    // Step 1: VLAN CLASSIFICATION and ingress filtering
+    const uint16_t vlan = classify(frame, incomingPort);
+    L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Classify, 1);
+    if (vlan == 0) {
+        const ForwardDecision decision{ForwardKind::Drop, -1, PortMask()};
+        recordDecision(decision, destMAC, incomingPort);
+        return decision;
+    }
+    
+    if (!learningPorts.test(incomingPort)) {
+        const ForwardDecision decision{ForwardKind::Blocked, -1, PortMask()};
+        recordDecision(decision, destMAC, incomingPort);
+        return decision;
+    }
+    
+    // Step 2: LEARNING PHASE
+    // Associate the source MAC with the incoming (logical) port, within the VLAN
+    const int ingress = aggregation.aggregatorOf(incomingPort);
+    const FdbKey sourceKey(sourceMAC, vlan);
+    const MacTable::Timestamp stamp = now();
+    LearnOutcome learned = macTable->learn(sourceKey, ingress, stamp);
+    counters.countLearn(incomingPort, learned);
+    scheduleAging(sourceKey, learned, stamp);
+    L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Learn, 1);
+    L2SIM_TRACE3(learn, incomingPort, sourceMAC.toUint64(), static_cast<int>(learned.result));
+    if (observer) {
+        observer->onLearn(sourceMAC, ingress, learned);
     }
+    L2SIM_STAGE_SKIP(stageClock);
     
-    // Step 2: FORWARDING DECISION
-    std::cout << "  ";
+    // Step 3: FORWARDING DECISION (a Learning port only learns), after
+    // snooping any IGMP/MLD message it carries
+    ForwardDecision decision{ForwardKind::Blocked, -1, PortMask()};
+    if (forwardingPorts.test(incomingPort)) {
+        expireGroups(stamp);
+        decision = decide(destMAC, vlan, ingress, snoop(frame, vlan, ingress, stamp));
+        if (!aggregation.empty()) {
+            aggregate(decision, frame);
+        }
+    }
+    L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Decide, 1);
+    recordDecision(decision, destMAC, incomingPort);
+    L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Report, 1);
+    
+    // Step 4: QUEUE for transmission on the chosen ports
+    if (packetPool) {
+        enqueueEgress(frame, decision);
+        L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Egress, 1);
+    }
+    return decision;
+}
+
+std::vector<ForwardDecision> Switch::processBurst(const std::vector<Frame>& frames,
+                                                  const std::vector<int>& ports) {
+    if (frames.size() != ports.size()) {
+        throw std::invalid_argument("processBurst: frames and ports differ in length");
+    }
+    std::vector<ForwardDecision> decisions(frames.size());
+    processBurst(frames.data(), ports.data(), frames.size(), decisions.data());
+    return decisions;
+}
+
+void Switch::processBurst(const Frame* frames, const int* ports, std::size_t count,
+                          ForwardDecision* decisions) {
+    processBurstOf(frames, ports, count, decisions);
+}
+
+void Switch::processBurst(const FrameView* frames, const int* ports, std::size_t count,
+                          ForwardDecision* decisions) {
+    processBurstOf(frames, ports, count, decisions);
+}
+
+template <typename FrameT>
+void Switch::processBurstOf(const FrameT* frames, const int* ports, std::size_t count,
+                            ForwardDecision* decisions) {
+    // One clock read stamps every entry learned in this burst
+    const MacTable::Timestamp stamp = now();
+    LearnOutcome learned[kMaxBurst];
+    uint16_t vlans[kMaxBurst];      // 0 = dropped by ingress filtering
+    MembershipMessage snooped[kMaxBurst];
+    expireGroups(stamp);
     
-    // Check for broadcast address
-    if (destMAC == "FF:FF:FF:FF:FF:FF") {
-        std::cout << MAGENTA << "⚡ BROADCAST:" << RESET 
-                  << " Flooding to all ports except Port " << incomingPort << "\n";
-        floodingEvents++;
+    for (std::size_t base = 0; base < count; base += kMaxBurst) {
+        const std::size_t n = std::min(kMaxBurst, count - base);
+        const FrameT* burst = frames + base;
+        const int* burstPorts = ports + base;
+        ForwardDecision* burstDecisions = decisions + base;
+        L2SIM_STAGE_CLOCK(stageClock);
         
-        // Show which ports would receive the frame
-        std::cout << "    Flooding ports: ";
-        for (int i = 1; i <= numPorts; i++) {
-            if (i != incomingPort) {
-                std::cout << i << " ";
+        // Phase 1: LEARNING for the whole burst, buckets fetched ahead of use
+        for (std::size_t i = 0; i < n; i++) {
+            vlans[i] = classify(viewOf(burst[i]), burstPorts[i]);
+            macTable->prefetch(FdbKey(burst[i].sourceMAC, vlans[i]));
+        }
+        L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Classify, n);
+        for (std::size_t i = 0; i < n; i++) {
+            if (vlans[i] == 0 || !learningPorts.test(burstPorts[i])) {
+                continue;
             }
+            const FdbKey sourceKey(burst[i].sourceMAC, vlans[i]);
+            learned[i] = macTable->learn(sourceKey, aggregation.aggregatorOf(burstPorts[i]), stamp);
+            counters.countLearn(burstPorts[i], learned[i]);
+            scheduleAging(sourceKey, learned[i], stamp);
+            L2SIM_TRACE3(learn, burstPorts[i], burst[i].sourceMAC.toUint64(),
+                         static_cast<int>(learned[i].result));
         }
-        std::cout << "\n";
-    } else {
-        // Unicast destination - check MAC table
-        auto destIt = macTable.find(destMAC);
-        if (destIt != macTable.end()) {
-            // KNOWN UNICAST - forward to specific port
-            int outPort = destIt->second.port;
-            if (outPort == incomingPort) {
-                // Destination is on the same segment - filter/drop
-                std::cout << CYAN << "⊗ FILTERING:" << RESET 
-                          << " Destination on same port (Port " << incomingPort << ") - frame dropped\n";
+        // Group membership, like addresses, is updated before any decision
+        for (std::size_t i = 0; i < n; i++) {
+            snooped[i] = vlans[i] != 0 && forwardingPorts.test(burstPorts[i])
+                ? snoop(viewOf(burst[i]), vlans[i], aggregation.aggregatorOf(burstPorts[i]), stamp)
+                : MembershipMessage::None;
+        }
+        L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Learn, n);
+        
+        // Phase 2: FORWARDING DECISIONS against the updated table
+        for (std::size_t i = 0; i < n; i++) {
+            if (vlans[i] != 0 && !burst[i].destMAC.isBroadcast()) {
+                macTable->prefetch(FdbKey(burst[i].destMAC, vlans[i]));
+            }
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            if (vlans[i] == 0) {
+                burstDecisions[i] = ForwardDecision{ForwardKind::Drop, -1, PortMask()};
+            } else if (!forwardingPorts.test(burstPorts[i])) {
+                burstDecisions[i] = ForwardDecision{ForwardKind::Blocked, -1, PortMask()};
             } else {
-                std::cout << GREEN << "→ FORWARDING:" << RESET 
-                          << " Sending to Port " << outPort << " (Known Unicast)\n";
-                forwardingEvents++;
+                burstDecisions[i] = decide(burst[i].destMAC, vlans[i],
+                                           aggregation.aggregatorOf(burstPorts[i]), snooped[i]);
+                if (!aggregation.empty()) {
+                    aggregate(burstDecisions[i], viewOf(burst[i]));
+                }
             }
-        } else {
-            // UNKNOWN UNICAST - flood all ports except incoming
-            std::cout << RED << "⚠ UNKNOWN UNICAST:" << RESET 
-                      << " Destination " << destMAC << " not in MAC table\n";
-            std::cout << "    Flooding to all ports except Port " << incomingPort << "\n";
-            floodingEvents++;
-            
-            // Show which ports would receive the frame
-            std::cout << "    Flooding ports: ";
-            for (int i = 1; i <= numPorts; i++) {
-                if (i != incomingPort) {
-                    std::cout << i << " ";
+        }
+        L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Decide, n);
+        
+        // Phase 3: statistics, reporting and egress queuing, in arrival order
+        // (timed per frame, to tell reporting and queuing apart)
+        for (std::size_t i = 0; i < n; i++) {
+            framesProcessed++;
+            counters.countBytes(burstPorts[i], viewOf(burst[i]).wireLength());
+            if (observer) {
+                observer->onFrameReceived(framesProcessed, burst[i].sourceMAC,
+                                          burst[i].destMAC, burstPorts[i]);
+                if (vlans[i] != 0 && learningPorts.test(burstPorts[i])) {
+                    observer->onLearn(burst[i].sourceMAC, aggregation.aggregatorOf(burstPorts[i]),
+                                      learned[i]);
                 }
             }
-            std::cout << "\n";
+            recordDecision(burstDecisions[i], burst[i].destMAC, burstPorts[i]);
+            L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Report, 1);
+            if (packetPool) {
+                enqueueEgress(viewOf(burst[i]), burstDecisions[i]);
+                L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Egress, 1);
+            }
         }
     }
     
-    std::cout << "\n";
+    // Interleave a bounded amount of aging with forwarding
+    if (agingBudgetPerBurst > 0 && agingWheel && agingWheel->hasDueWork(stamp)) {
+        agingStep(agingBudgetPerBurst);
+    }
 }
 
-void Switch::cleanupTable() {
-    if (agingTimeout <= 0) {
-        return; // Aging disabled
+MacTable::Timestamp Switch::now() const {
+    if (agingClock == AgingClock::Logical) {
+        return currentCycle;
+    }
+    return static_cast<MacTable::Timestamp>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+}
+
+ForwardDecision Switch::decide(const MacTable& table, const PortMask& floodPorts,
+                               FdbKey dest, int incomingPort) {
+    // Check for broadcast address; the flood stays inside the VLAN
+    if (dest.mac().isBroadcast()) {
+        return {ForwardKind::Broadcast, -1, floodPorts.without(incomingPort)};
     }
     
-    auto now = std::chrono::steady_clock::now();
-    int removed = 0;
+    // Unicast destination - check MAC table
+    int outPort = table.lookup(dest);
+    if (outPort == MacTable::kNoPort || !floodPorts.test(outPort)) {
+        // UNKNOWN UNICAST - flood the VLAN except incoming (also when the
+        // port it was learned on has since left the VLAN)
+        return {ForwardKind::UnknownUnicast, -1, floodPorts.without(incomingPort)};
+    }
+    if (outPort == incomingPort) {
+        // Destination is on the same segment - filter/drop
+        return {ForwardKind::Filter, outPort, PortMask()};
+    }
+    // KNOWN UNICAST - forward to specific port
+    return {ForwardKind::Forward, outPort, PortMask::single(outPort)};
+}
+
+void Switch::recordDecision(const ForwardDecision& decision, MacAddress destMAC, int incomingPort) {
+    counters.countDecision(incomingPort, decision.kind);
+    L2SIM_TRACE3(decision, incomingPort, static_cast<int>(decision.kind), decision.outPort);
+    if (observer) {
+        observer->onDecision(decision, destMAC, incomingPort);
+    }
+}
+
+void Switch::enqueueEgress(const FrameView& frame, const ForwardDecision& decision) {
+    const int trafficClass = frame.priority & 7;
     
-    for (auto it = macTable.begin(); it != macTable.end(); ) {
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-            now - it->second.timestamp).count();
-        
-        if (elapsed > agingTimeout) {
-            std::cout << YELLOW << "⌛ AGING OUT: " << RESET 
-                      << it->first << " (last seen " << elapsed << "s ago)\n";
-            it = macTable.erase(it);
-            removed++;
+    // Tail drop happens per port, before any buffer is spent on the frame
+    PortMask accepted;
+    decision.egressPorts.forEach([&](int port) {
+        if (outputPorts[port - 1].hasRoom(trafficClass)) {
+            accepted.set(port);
         } else {
-            ++it;
+            outputPorts[port - 1].countDrop(trafficClass);
         }
+    });
+    const int copies = accepted.count();
+    if (copies == 0) {
+        return; // Filtered, or every queue full
+    }
+    
+    // One buffer for the whole flood; each port queue takes a reference
+    const PacketPool::Handle buffer = packetPool->allocate(frame, static_cast<uint32_t>(copies));
+    if (buffer == PacketPool::kInvalidHandle) {
+        return; // Pool exhausted (counted by the pool)
+    }
+    const PacketDescriptor descriptor{buffer, static_cast<uint16_t>(frame.wireLength()),
+                                      static_cast<uint8_t>(trafficClass), currentCycle};
+    accepted.forEach([&](int port) {
+        outputPorts[port - 1].enqueue(descriptor);
+    });
+    egressBacklog += copies;
+}
+
+FrameView Switch::egressView(const PacketDescriptor& descriptor) const {
+    // An untagged frame's priority is not in its bytes; the queue remembers it
+    FrameView frame = packetPool->view(descriptor.buffer);
+    frame.priority = descriptor.trafficClass;
+    return frame;
+}
+
+void Switch::serviceEgress() {
+    for (int port = 1; port <= numPorts && egressBacklog > 0; ++port) {
+        egressBacklog -= outputPorts[port - 1].serviceCycle(currentCycle,
+            [&](const PacketDescriptor& descriptor) {
+                if (transmitHandler) {
+                    transmitHandler(port, egressView(descriptor));
+                }
+                packetPool->release(descriptor.buffer);
+            });
+    }
+}
+
+std::size_t Switch::transmit(int port, std::size_t maxFrames,
+                             const std::function<void(const FrameView&)>& sink) {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("transmit: no such port " + std::to_string(port));
+    }
+    if (!packetPool) {
+        return 0;
     }
     
-    if (removed > 0) {
-        std::cout << "Removed " << removed << " aged entries from MAC table\n\n";
+    EgressPort& egress = outputPorts[port - 1];
+    std::size_t sent = 0;
+    PacketDescriptor descriptor;
+    while ((maxFrames == 0 || sent < maxFrames) && egress.dequeue(currentCycle, descriptor)) {
+        if (sink) {
+            sink(egressView(descriptor));
+        }
+        packetPool->release(descriptor.buffer);
+        sent++;
+    }
+    egressBacklog -= sent;
+    return sent;
+}
+
+std::size_t Switch::getEgressQueueDepth(int port) const {
+    if (!packetPool || port < 1 || port > numPorts) {
+        return 0;
+    }
+    return outputPorts[port - 1].size();
+}
+
+const QueueCounters& Switch::getEgressCounters(int port, int trafficClass) const {
+    if (!packetPool) {
+        throw std::invalid_argument("getEgressCounters: egress is not modelled");
+    }
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getEgressCounters: no such port " + std::to_string(port));
+    }
+    if (trafficClass < 0 || trafficClass >= EgressConfig::kTrafficClasses) {
+        throw std::invalid_argument("getEgressCounters: no such traffic class " +
+                                    std::to_string(trafficClass));
+    }
+    return outputPorts[port - 1].getCounters(trafficClass);
+}
+
+void Switch::setVlanMembers(uint16_t vlan, const PortMask& members) {
+    if (vlan < 1 || vlan > FdbKey::kMaxVlan) {
+        throw std::invalid_argument("setVlanMembers: VLAN ID must be between 1 and 4094");
+    }
+    if (members != (members & allPorts)) {
+        throw std::invalid_argument("setVlanMembers: port out of range for VLAN " +
+                                    std::to_string(vlan));
+    }
+    if (vlan >= vlanPorts.size()) {
+        vlanPorts.resize(vlan + 1);
+    }
+    vlanPorts[vlan] = members;
+}
+
+void Switch::setPortVlan(int port, uint16_t vlan) {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("setPortVlan: no such port " + std::to_string(port));
+    }
+    if (vlan < 1 || vlan > FdbKey::kMaxVlan) {
+        throw std::invalid_argument("setPortVlan: VLAN ID must be between 1 and 4094");
+    }
+    portVlan[port - 1] = vlan;
+}
+
+uint16_t Switch::getPortVlan(int port) const {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getPortVlan: no such port " + std::to_string(port));
+    }
+    return portVlan[port - 1];
+}
+
+void Switch::setPortState(int port, PortState state) {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("setPortState: no such port " + std::to_string(port));
+    }
+    const PortMask ports = aggregation.isLag(port) ? aggregation.membersOf(port) : PortMask::single(port);
+    learningPorts.andNot(ports);
+    forwardingPorts.andNot(ports);
+    if (state != PortState::Discarding) {
+        learningPorts |= ports;
+    }
+    if (state == PortState::Forwarding) {
+        forwardingPorts |= ports;
+    }
+}
+
+PortState Switch::getPortState(int port) const {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getPortState: no such port " + std::to_string(port));
+    }
+    if (forwardingPorts.test(port)) {
+        return PortState::Forwarding;
+    }
+    return learningPorts.test(port) ? PortState::Learning : PortState::Discarding;
+}
+
+std::size_t Switch::flushPort(int port) {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("flushPort: no such port " + std::to_string(port));
+    }
+    return flushPorts(PortMask::single(port));
+}
+
+int Switch::getPortMACCount(int port) const {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getPortMACCount: no such port " + std::to_string(port));
+    }
+    return static_cast<int>(macTable->portCount(port));
+}
+
+std::size_t Switch::flushPorts(const PortMask& ports) {
+    // Aging records of flushed entries are skipped when they come due
+    PortMask valid = ports;
+    valid &= allPorts;
+    return valid.none() ? 0 : macTable->erasePorts(valid);
+}
+
+void Switch::cleanupTable() {
+    if (agingTimeout <= 0) {
+        return; // Aging disabled
     }
+    agingStep(0);
+}
+
+std::size_t Switch::agingStep(std::size_t budget) {
+    if (!agingWheel) {
+        return 0; // Aging disabled
+    }
+    L2SIM_STAGE_CLOCK(stageClock);
+    
+    std::size_t removed = agingWheel->advance(now(), *macTable, budget,
+        [this](const MACTableEntry& entry, uint32_t elapsed) {
+            L2SIM_TRACE2(age_out, entry.mac.toUint64(), elapsed);
+            if (observer) {
+                observer->onAgeOut(entry.mac, elapsed, agingClock);
+            }
+        });
+    
+    L2SIM_STAGE_LAP(stageClock, stageProfile, Stage::Aging, 1);
+    
+    if (observer) {
+        observer->onAgingComplete(removed);
+    }
+    return removed;
 }
 
 void Switch::printMACTable() const {
+    flushObserver();
     std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
     std::cout << "║           Current MAC Address Table            ║\n";
     std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
     
-    if (macTable.empty()) {
+    if (macTable->size() == 0) {
         std::cout << "  (Empty - no MAC addresses learned yet)\n";
         return;
     }
     
+    const bool logical = agingClock == AgingClock::Logical;
     std::cout << std::left << std::setw(20) << "MAC Address" 
+              << std::setw(8) << "VLAN"
               << std::setw(10) << "Port" 
-              << "Age (seconds)\n";
-    std::cout << std::string(50, '-') << "\n";
+              << (logical ? "Age (cycles)\n" : "Age (seconds)\n");
+    std::cout << std::string(58, '-') << "\n";
     
-    auto now = std::chrono::steady_clock::now();
-    for (const auto& entry : macTable) {
-        auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            now - entry.second.timestamp).count();
+    const MacTable::Timestamp current = now();
+    macTable->forEach([&](const MACTableEntry& entry) {
+        const uint32_t age = current - entry.timestamp;
         
-        std::cout << std::left << std::setw(20) << entry.first
-                  << std::setw(10) << entry.second.port
-                  << age << "s\n";
+        std::cout << std::left << std::setw(20) << entry.mac
+                  << std::setw(8) << entry.vlan
+                  << std::setw(10) << entry.port
+                  << age << (logical ? "\n" : "s\n");
+    });
+    std::cout << "\n";
+}
+
+int Switch::addLag(const PortMask& members) {
+    const int lag = aggregation.add(members);
+    flushPorts(members);
+    return lag;
+}
+
+void Switch::removeLag(int lag) {
+    aggregation.remove(lag);
+    flushPort(lag);
+}
+
+void Switch::setLagMemberActive(int port, bool active) {
+    if (aggregation.setActive(port, active) == 0) {
+        flushPort(aggregation.aggregatorOf(port));
+    }
+}
+
+int Switch::getLagOf(int port) const {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getLagOf: no such port " + std::to_string(port));
+    }
+    return aggregation.aggregatorOf(port);
+}
+
+void Switch::printLagStatistics() const {
+    flushObserver();
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║           Link Aggregation Groups              ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    
+    if (aggregation.empty()) {
+        std::cout << "  (No LAGs configured)\n\n";
+        return;
+    }
+    
+    aggregation.getLags().forEach([&](int lag) {
+        const PortMask members = aggregation.membersOf(lag);
+        uint64_t total = 0;
+        members.forEach([&](int port) { total += aggregation.getLoad(port); });
+        std::cout << "LAG " << lag << " (" << members.count() << " members, "
+                  << total << " frames, imbalance " << std::fixed << std::setprecision(2)
+                  << aggregation.imbalance(lag) << "x)\n";
+        members.forEach([&](int port) {
+            const uint64_t frames = aggregation.getLoad(port);
+            std::cout << "  Port " << std::left << std::setw(5) << port << std::right
+                      << std::setw(12) << frames << " frames  " << std::setw(5) << std::setprecision(1)
+                      << (total > 0 ? 100.0 * frames / total : 0.0) << "%\n";
+        });
+    });
+    std::cout << "  Imbalance: busiest active member over the mean\n\n";
+}
+
+bool Switch::joinGroup(MacAddress group, int port, uint16_t vlan) {
+    if (!group.isMulticast() || group.isBroadcast()) {
+        throw std::invalid_argument("joinGroup: not a multicast group address");
+    }
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("joinGroup: no such port " + std::to_string(port));
     }
+    if (vlan < 1 || vlan > FdbKey::kMaxVlan) {
+        throw std::invalid_argument("joinGroup: VLAN ID must be between 1 and 4094");
+    }
+    return groupTable.join(FdbKey(group, vlan), port, now(), true);
+}
+
+bool Switch::leaveGroup(MacAddress group, int port, uint16_t vlan) {
+    return groupTable.leave(FdbKey(group, vlan), port);
+}
+
+void Switch::addMulticastRouterPort(int port, uint16_t vlan) {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("addMulticastRouterPort: no such port " + std::to_string(port));
+    }
+    if (vlan < 1 || vlan > FdbKey::kMaxVlan) {
+        throw std::invalid_argument("addMulticastRouterPort: VLAN ID must be between 1 and 4094");
+    }
+    groupTable.addRouterPort(vlan, port, now(), true);
+}
+
+void Switch::printGroupTable() const {
+    flushObserver();
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║          Current Multicast Group Table         ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    
+    if (groupTable.empty()) {
+        std::cout << "  (Empty - no multicast groups registered)\n";
+        return;
+    }
+    
+    std::cout << std::left << std::setw(20) << "Group MAC"
+              << std::setw(8) << "VLAN"
+              << "Member Ports (+ router ports)\n";
+    std::cout << std::string(58, '-') << "\n";
+    
+    groupTable.forEach([&](FdbKey group, const PortMask& members) {
+        std::cout << std::left << std::setw(20) << group.mac() << std::setw(8) << group.vlan();
+        members.forEach([](int port) { std::cout << port << " "; });
+        const PortMask routers = groupTable.routerPorts(group.vlan());
+        if (routers.any()) {
+            std::cout << "+ ";
+            routers.forEach([](int port) { std::cout << port << " "; });
+        }
+        std::cout << "\n";
+    });
     std::cout << "\n";
 }
 
+MemoryUsage Switch::getMemoryUsage() const {
+    MemoryUsage usage = macTable->memoryUsage();
+    if (agingWheel) {
+        usage.bytes += agingWheel->allocatedBytes();
+    }
+    return usage;
+}
+
 void Switch::printStatistics() const {
+    flushObserver();
     std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
     std::cout << "║              Switch Statistics                 ║\n";
     std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
-    std::cout << "Total Frames Processed:  " << framesProcessed << "\n";
-    std::cout << "Learning Events:         " << learningEvents << "\n";
-    std::cout << "Forwarding Events:       " << forwardingEvents << "\n";
-    std::cout << "Flooding Events:         " << floodingEvents << "\n";
-    std::cout << "MAC Table Size:          " << macTable.size() << " entries\n";
-    
-    if (framesProcessed > 0) {
-        double forwardingRate = (100.0 * forwardingEvents) / framesProcessed;
-        double floodingRate = (100.0 * floodingEvents) / framesProcessed;
+    const PortStatistics stats = counters.getTotal();
+    const uint64_t frames = stats.frames();
+    std::cout << "Total Frames Processed:  " << frames << "\n";
+    std::cout << "Bytes Received:          " << stats.bytes << "\n";
+    std::cout << "Learning Events:         " << stats.learned << "\n";
+    std::cout << "Station Moves:           " << stats.moves << "\n";
+    std::cout << "Forwarding Events:       " << stats.of(ForwardKind::Forward) << "\n";
+    std::cout << "Flooding Events:         " << stats.flooded() << "\n";
+    std::cout << "Filtered Frames:         " << stats.of(ForwardKind::Filter) << "\n";
+    std::cout << "MAC Table Size:          " << macTable->size() << " entries\n";
+    const MemoryUsage memory = getMemoryUsage();
+    std::cout << "MAC Table Memory:        " << formatBytes(memory.bytes) << " (" << macTable->name()
+              << ", " << memory.slots << " slots, " << std::fixed << std::setprecision(1)
+              << 100.0 * memory.loadFactor() << "% load)\n";
+    if (memory.entries > 0) {
+        std::cout << "Bytes per Entry:         " << memory.bytesPerEntry() << "\n";
+    }
+    if (stats.tableFull > 0) {
+        std::cout << "Table Full Events:       " << stats.tableFull << "\n";
+    }
+    if (stats.evictions > 0) {
+        std::cout << "Table Evictions:         " << stats.evictions << "\n";
+    }
+    if (stats.of(ForwardKind::Drop) > 0) {
+        std::cout << "VLAN Ingress Drops:      " << stats.of(ForwardKind::Drop) << "\n";
+    }
+    if (stats.of(ForwardKind::Blocked) > 0) {
+        std::cout << "Blocked Port Drops:      " << stats.of(ForwardKind::Blocked) << "\n";
+    }
+    if (stats.of(ForwardKind::Multicast) > 0) {
+        std::cout << "Multicast Forwards:      " << stats.of(ForwardKind::Multicast) << "\n";
+    }
+    if (!groupTable.empty()) {
+        std::cout << "Multicast Groups:        " << groupTable.size() << "\n";
+    }
+    
+    if (frames > 0) {
+        double forwardingRate = (100.0 * stats.of(ForwardKind::Forward)) / frames;
+        double floodingRate = (100.0 * stats.flooded()) / frames;
         std::cout << "Forwarding Efficiency:   " << std::fixed << std::setprecision(1) 
                   << forwardingRate << "% (higher is better)\n";
         std::cout << "Flooding Rate:           " << floodingRate << "%\n";
     }
+    
+    if (packetPool) {
+        uint64_t tailDrops = 0;
+        for (const EgressPort& egress : outputPorts) {
+            for (int tc = 0; tc < EgressConfig::kTrafficClasses; ++tc) {
+                tailDrops += egress.getCounters(tc).dropped;
+            }
+        }
+        const double occupancy = (100.0 * packetPool->getInUse()) / packetPool->getCapacity();
+        std::cout << "Buffer Pool Occupancy:   " << packetPool->getInUse() << "/"
+                  << packetPool->getCapacity() << " buffers (" << std::fixed << std::setprecision(1)
+                  << occupancy << "%, peak " << packetPool->getPeakInUse() << ")\n";
+        std::cout << "Frames Queued (egress):  " << egressBacklog << "\n";
+        std::cout << "Queue Tail Drops:        " << tailDrops << "\n";
+        std::cout << "Pool Exhaustion Drops:   " << packetPool->getExhaustionDrops() << "\n";
+        if (packetPool->getOversizeDrops() > 0) {
+            std::cout << "Oversize Drops:          " << packetPool->getOversizeDrops() << "\n";
+        }
+    }
+#ifdef L2SIM_INSTRUMENT
+    if (frames > 0) {
+        std::cout << "\nStage Timing (ns per frame, aging per pass):\n";
+        stageProfile.print(std::cout);
+    }
+#endif
     std::cout << "\n";
 }
 
+const StageProfile* Switch::getStageProfile() const {
+#ifdef L2SIM_INSTRUMENT
+    return &stageProfile;
+#else
+    return nullptr;
+#endif
+}
+
+PortStatistics Switch::getPortStatistics(int port) const {
+    if (port < 1 || port > numPorts) {
+        throw std::invalid_argument("getPortStatistics: no such port " + std::to_string(port));
+    }
+    return counters.getPort(port);
+}
+
+void Switch::printPortStatistics() const {
+    flushObserver();
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              Port Statistics                   ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    std::cout << std::left << std::setw(6) << "Port"
+              << std::right << std::setw(10) << "Frames"
+              << std::setw(12) << "Bytes"
+              << std::setw(9) << "Learned"
+              << std::setw(7) << "Moves"
+              << std::setw(10) << "Forward"
+              << std::setw(9) << "Flood"
+              << std::setw(8) << "Filter"
+              << std::setw(8) << "Drop" << "\n";
+    std::cout << std::string(79, '-') << "\n";
+    
+    bool any = false;
+    for (int port = 1; port <= numPorts; port++) {
+        const PortStatistics stats = counters.getPort(port);
+        if (stats.frames() == 0) {
+            continue;
+        }
+        any = true;
+        std::cout << std::left << std::setw(6) << port
+                  << std::right << std::setw(10) << stats.frames()
+                  << std::setw(12) << stats.bytes
+                  << std::setw(9) << stats.learned
+                  << std::setw(7) << stats.moves
+                  << std::setw(10) << stats.of(ForwardKind::Forward)
+                  << std::setw(9) << stats.flooded()
+                  << std::setw(8) << stats.of(ForwardKind::Filter)
+                  << std::setw(8) << stats.of(ForwardKind::Drop) + stats.of(ForwardKind::Blocked)
+                  << "\n";
+    }
+    if (!any) {
+        std::cout << "  (No frames received yet)\n";
+    }
+    std::cout << std::left << "  Drop: VLAN ingress and blocked port drops\n\n";
+}
+
+void Switch::printEgressStatistics() const {
+    flushObserver();
+    std::cout << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║             Egress Queue Statistics            ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    
+    if (!packetPool) {
+        std::cout << "  (Egress queues not modelled)\n\n";
+        return;
+    }
+    
+    std::cout << std::left << std::setw(6) << "Port" << std::setw(5) << "TC"
+              << std::right << std::setw(10) << "Enqueued" << std::setw(10) << "Dropped"
+              << std::setw(10) << "Sent" << std::setw(8) << "Depth" << std::setw(10) << "Max"
+              << std::setw(12) << "Sojourn" << std::setw(8) << "Max" << "\n";
+    std::cout << std::string(79, '-') << "\n";
+    
+    bool any = false;
+    for (int port = 1; port <= numPorts; ++port) {
+        const EgressPort& egress = outputPorts[port - 1];
+        for (int tc = EgressConfig::kTrafficClasses - 1; tc >= 0; --tc) {
+            const QueueCounters& stats = egress.getCounters(tc);
+            if (stats.enqueued == 0 && stats.dropped == 0) {
+                continue;
+            }
+            any = true;
+            std::cout << std::left << std::setw(6) << port << std::setw(5) << tc
+                      << std::right << std::setw(10) << stats.enqueued
+                      << std::setw(10) << stats.dropped << std::setw(10) << stats.transmitted
+                      << std::setw(8) << egress.size(tc) << std::setw(10) << stats.maxDepth
+                      << std::setw(12) << std::fixed << std::setprecision(2) << stats.meanSojourn()
+                      << std::setw(8) << stats.sojournMax << "\n";
+        }
+    }
+    if (!any) {
+        std::cout << "  (No frames queued yet)\n";
+    }
+    std::cout << std::left << "  Sojourn: mean / max cycles between queuing and transmission\n\n";
+}
+
 void Switch::clearMACTable() {
-    macTable.clear();
-    std::cout << "MAC table cleared\n\n";
+    macTable->clear();
+    if (agingWheel) {
+        agingWheel->clear();
+    }
+    if (observer) {
+        observer->onTableCleared();
+    }
+}
+
+std::size_t Switch::saveTable(const std::string& path) const {
+    const MacTable::Timestamp current = now();
+    std::vector<SnapshotRecord> records;
+    records.reserve(macTable->size());
+    macTable->forEach([&](const MACTableEntry& entry) {
+        records.push_back(SnapshotRecord{entry.key().toUint64(), static_cast<uint32_t>(entry.port),
+                                         current - entry.timestamp});
+    });
+    TableSnapshot::write(path, agingClock, records);
+    return records.size();
+}
+
+std::size_t Switch::loadTable(const std::string& path) {
+    const TableSnapshot snapshot(path);
+    if (snapshot.getAgingClock() != agingClock) {
+        throw std::runtime_error("loadTable: " + path + " has ages in " +
+                                 (agingClock == AgingClock::Logical ? "seconds" : "cycles") +
+                                 " but the switch counts " +
+                                 (agingClock == AgingClock::Logical ? "cycles" : "seconds"));
+    }
+    
+    macTable->clear();
+    if (agingWheel) {
+        agingWheel->clear();
+    }
+    macTable->reserve(snapshot.size());
+    
+    // Records are read in place; fetching buckets a few records ahead
+    // overlaps the table's cache misses as in processBurst()
+    constexpr std::size_t kPrefetchDistance = 8;
+    const SnapshotRecord* records = snapshot.records();
+    const std::size_t count = snapshot.size();
+
+    // Stamps are now - age, so a switch younger than the oldest restored
+    // entry would wrap them below zero and file them far from their real
+    // deadlines. The table is empty, so move the clock forward instead.
+    if (agingWheel) {
+        uint32_t oldest = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            const SnapshotRecord& record = records[i];
+            if (record.port >= 1 && record.port <= static_cast<uint32_t>(numPorts) &&
+                record.age <= static_cast<uint32_t>(agingTimeout) && record.age > oldest) {
+                oldest = record.age;
+            }
+        }
+        const MacTable::Timestamp start = now();
+        if (oldest > start) {
+            if (agingClock == AgingClock::Logical) {
+                advanceCycles(oldest - start);
+            } else {
+                startTime -= std::chrono::seconds(oldest - start);
+            }
+        }
+    }
+
+    const MacTable::Timestamp current = now();
+    std::size_t restored = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (i + kPrefetchDistance < count) {
+            macTable->prefetch(FdbKey::fromUint64(records[i + kPrefetchDistance].key));
+        }
+        const SnapshotRecord& record = records[i];
+        if (record.port < 1 || record.port > static_cast<uint32_t>(numPorts) ||
+            (agingWheel && record.age > static_cast<uint32_t>(agingTimeout))) {
+            continue;
+        }
+        const FdbKey key = FdbKey::fromUint64(record.key);
+        const MacTable::Timestamp stamp = current - record.age;
+        const LearnOutcome outcome = macTable->learn(key, static_cast<int>(record.port), stamp);
+        if (outcome.result == LearnResult::Learned) {
+            scheduleAging(key, outcome, stamp);
+            restored++;
+        }
+    }
+    return restored;
 }
 
 void Switch::advanceCycle() {
     currentCycle++;
+    if (egressBacklog > 0) {
+        serviceEgress();
+    }
+}
+
+void Switch::advanceCycles(uint32_t cycles) {
+    while (cycles > 0 && egressBacklog > 0) {
+        advanceCycle();
+        cycles--;
+    }
+    currentCycle += cycles;
+}
+
+bool Switch::isLearned(MacAddress mac, uint16_t vlan) const {
+    return macTable->lookup(FdbKey(mac, vlan)) != MacTable::kNoPort;
 }
 
 bool Switch::isLearned(const std::string& mac) const {
-    return macTable.find(mac) != macTable.end();
+    MacAddress parsed;
+    return MacAddress::parse(mac, parsed) && isLearned(parsed);
 }
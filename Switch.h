@@ -2,10 +2,53 @@
 #define SWITCH_H
 
 #include <string>
-#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <chrono>
+#include <functional>
+#include "AgingWheel.h"
+#include "EgressPort.h"
+#include "FdbKey.h"
+#include "ForwardDecision.h"
 #include "Frame.h"
+#include "FrameView.h"
+#include "LinkAggregation.h"
+#include "MacAddress.h"
+#include "MacTable.h"
+#include "MulticastTable.h"
+#include "PacketPool.h"
+#include "StageProfile.h"
+#include "SwitchCounters.h"
+#include "SwitchObserver.h"
+
+/**
+ * @brief Spanning tree state of a port (802.1w)
+ */
+enum class PortState {
+    Discarding,     // Neither learns nor forwards (blocked, alternate or disabled)
+    Learning,       // Learns source addresses but does not forward
+    Forwarding      // Learns and forwards
+};
+
+/**
+ * @brief Construction-time settings for a Switch
+ */
+struct SwitchConfig {
+    int numPorts = 8;                           // Number of physical ports
+    int agingTimeout = 300;                     // MAC aging timeout in clock units (0 = no aging)
+    AgingClock agingClock = AgingClock::WallClock; // Seconds of real time, or simulation cycles
+    TableEngine tableEngine = TableEngine::Hash; // MAC table implementation
+    std::size_t tableCapacity = 0;              // Max MAC entries (0 = engine default)
+    EvictionPolicy tableEviction = EvictionPolicy::NoLearn; // What a full table does with new sources
+    std::size_t agingBudgetPerBurst = 0;        // Aging records examined after each burst (0 = only in cleanupTable)
+    std::size_t packetBuffers = 0;              // Egress frame buffers (0 = egress queues not modelled)
+    std::size_t packetBufferSize = PacketPool::kDefaultBufferSize; // Bytes per egress buffer
+    EgressConfig egress{};                      // Queue depth, line rate and scheduler per port
+    bool multicastSnooping = false;             // Learn multicast groups from IGMP/MLD messages
+    int groupTimeout = 260;                     // Snooped membership lifetime in clock units (0 = never)
+    LagHash lagHash = LagHash::L2;              // Frame fields that pick a LAG member
+    SwitchObserver* observer = consoleObserver(); // Event sink (nullptr = silent fast path)
+};
 
 /**
  * @brief Simulates a Layer 2 Ethernet Learning Switch
@@ -18,37 +61,256 @@
  * - Unknown Unicast Flooding
  * - Broadcast Handling
  * - MAC Table Aging (optional)
+ * - 802.1Q VLANs: per-VLAN learning and flood domains
+ * - IGMP/MLD snooping: multicast sent to group members only (optional)
+ * - Link aggregation: member ports bundled into one logical port
+ * - Spanning tree port states, set by whoever runs the protocol
  */
 class Switch {
-private:
-    /**
-     * @brief Entry in the MAC address table
-     */
-    struct MACTableEntry {
-        int port;                                           // Port number where MAC was learned
-        std::chrono::steady_clock::time_point timestamp;    // Last seen time (for aging)
-        
-        MACTableEntry(int p) 
-            : port(p), timestamp(std::chrono::steady_clock::now()) {}
-    };
+public:
+    // Frames handled together inside processBurst(); longer bursts are split
+    static constexpr std::size_t kMaxBurst = 256;
     
-    // MAC Address Table: Maps MAC addresses to port numbers and timestamps
-    std::unordered_map<std::string, MACTableEntry> macTable;
+private:
+    // MAC Address Table: Maps packed MAC addresses to port numbers and timestamps
+    std::unique_ptr<MacTable> macTable;
     
     // Total number of ports on the switch
     int numPorts;
     
-    // Aging timeout in seconds (for MAC table cleanup)
+    // Ports 1..numPorts, precomputed so a flood set is one masked operation
+    PortMask allPorts;
+    
+    // Member ports of each VLAN, indexed by VID (VIDs past the end have none)
+    std::vector<PortMask> vlanPorts;
+    
+    // VLAN assigned to untagged frames on each port (PVID), indexed by port - 1
+    std::vector<uint16_t> portVlan;
+    
+    // Ports whose spanning tree state lets them learn (Learning or Forwarding)
+    PortMask learningPorts;
+    
+    // Ports in the Forwarding state: the only ones frames are accepted from or sent to
+    PortMask forwardingPorts;
+    
+    // Aging timeout in seconds or cycles, per agingClock (for MAC table cleanup)
     int agingTimeout;
     
-    // Simulation cycle counter (alternative to real time)
-    int currentCycle;
+    // Time base for entry timestamps
+    AgingClock agingClock;
+    
+    // Expiry schedule for learned entries (null when aging is disabled)
+    std::unique_ptr<AgingWheel> agingWheel;
+    
+    // Aging work done at the end of each processBurst() call
+    std::size_t agingBudgetPerBurst;
+    
+    // Reference point for wall-clock timestamps
+    std::chrono::steady_clock::time_point startTime;
+    
+    // Simulation cycle counter (the logical clock epoch)
+    uint32_t currentCycle;
+    
+    // Receives learning/forwarding events (nullptr = no reporting)
+    SwitchObserver* observer;
+    
+    // Buffers for frames waiting to be transmitted (null when egress is not modelled)
+    std::unique_ptr<PacketPool> packetPool;
+    
+    // Class queues and scheduler of each port, indexed by port - 1
+    std::vector<EgressPort> outputPorts;
+    
+    // Frames queued on all ports (lets idle cycles skip the scheduler)
+    std::size_t egressBacklog;
+    
+    // Receives frames sent by the per-cycle scheduler (may be empty)
+    std::function<void(int, const FrameView&)> transmitHandler;
+    
+    // Sequence number of the last frame received (observer numbering)
+    uint64_t framesProcessed;
+    
+    // Per-port statistics, readable from other threads while forwarding
+    SwitchCounters counters;
+    
+    // Multicast groups and router ports, per VLAN
+    MulticastTable groupTable;
+    
+    // Whether IGMP/MLD messages update groupTable
+    bool multicastSnooping;
+    
+    // Time of the last group expiry pass (expiry runs once per clock tick)
+    MacTable::Timestamp groupsExpiredAt;
+    
+    // Link aggregation groups; stations behind a LAG are learned on its ID
+    LinkAggregation aggregation;
+    
+    // Fields hashed to spread flows over LAG members
+    LagHash lagHash;
+    
+#ifdef L2SIM_INSTRUMENT
+    // Time spent in each forwarding stage
+    StageProfile stageProfile;
+#endif
+    
+    /**
+     * @brief Current time in agingClock units
+     * 
+     * With the logical clock this is a plain member read; only the
+     * wall-clock mode touches steady_clock.
+     */
+    MacTable::Timestamp now() const;
+    
+    /**
+     * @brief Files a newly learned entry with the aging wheel
+     */
+    void scheduleAging(FdbKey key, const LearnOutcome& outcome, MacTable::Timestamp stamp) {
+        if (agingWheel && outcome.result == LearnResult::Learned) {
+            agingWheel->schedule(key, stamp);
+        }
+    }
+    
+    /**
+     * @brief Ports of a VLAN (empty for an unconfigured VID)
+     */
+    const PortMask& membersOf(uint16_t vlan) const {
+        static const PortMask none;
+        return vlan < vlanPorts.size() ? vlanPorts[vlan] : none;
+    }
+    
+    /**
+     * @brief VLAN a frame belongs to, or 0 if its ingress port may not carry it
+     * 
+     * Untagged and priority-tagged frames take the port's PVID; ingress
+     * filtering drops frames for VLANs the port is not a member of, and
+     * frames claiming a port the switch does not have.
+     */
+    uint16_t classify(const FrameView& frame, int incomingPort) const {
+        if (incomingPort < 1 || incomingPort > numPorts) {
+            return 0;
+        }
+        const uint16_t vlan = (frame.tagged && frame.vlan != 0) ? frame.vlan
+                                                                : portVlan[incomingPort - 1];
+        return membersOf(vlan).test(incomingPort) ? vlan : 0;
+    }
+    
+    /**
+     * @brief Chooses the forwarding action for a destination within a VLAN
+     * 
+     * Only forwarding ports are candidates, so a station learned behind a
+     * port the spanning tree has since blocked is flooded for.
+     */
+    ForwardDecision decide(MacAddress destMAC, uint16_t vlan, int incomingPort) const {
+        PortMask floodPorts = membersOf(vlan);
+        floodPorts &= forwardingPorts;
+        if (destMAC.isMulticast() && !groupTable.empty()) {
+            // A registered group is a single lookup plus a mask
+            if (const PortMask* egress = groupTable.lookup(FdbKey(destMAC, vlan))) {
+                return {ForwardKind::Multicast, -1, (*egress & floodPorts).without(incomingPort)};
+            }
+        }
+        return decide(*macTable, floodPorts, FdbKey(destMAC, vlan), incomingPort);
+    }
+    
+    /**
+     * @brief decide() for a frame after it was snooped
+     * 
+     * Reports and leaves go to the VLAN's multicast routers only, so hosts
+     * do not hear each other's reports; other frames are forwarded as usual.
+     */
+    ForwardDecision decide(MacAddress destMAC, uint16_t vlan, int incomingPort,
+                           MembershipMessage message) const {
+        if (message == MembershipMessage::Report || message == MembershipMessage::Leave) {
+            PortMask egress = groupTable.routerPorts(vlan);
+            egress &= membersOf(vlan);
+            egress &= forwardingPorts;
+            return {ForwardKind::Multicast, -1, egress.without(incomingPort)};
+        }
+        return decide(destMAC, vlan, incomingPort);
+    }
+    
+    /**
+     * @brief Applies a frame's IGMP/MLD message to the group table, if snooping
+     */
+    MembershipMessage snoop(const FrameView& frame, uint16_t vlan, int incomingPort,
+                            MacTable::Timestamp stamp) {
+        return multicastSnooping ? groupTable.snoop(frame, vlan, incomingPort, stamp)
+                                 : MembershipMessage::None;
+    }
+    
+    /**
+     * @brief Picks the LAG member each LAG in a decision sends the frame on
+     * 
+     * The flow hash is only computed when the decision involves a LAG.
+     */
+    void aggregate(ForwardDecision& decision, const FrameView& frame) {
+        if (decision.kind == ForwardKind::Forward) {
+            if (aggregation.isLag(decision.outPort)) {
+                const int member = aggregation.select(decision.outPort,
+                                                      LinkAggregation::flowHash(frame, lagHash));
+                decision.outPort = member != 0 ? member : -1;
+                decision.egressPorts = member != 0 ? PortMask::single(member) : PortMask();
+                if (member != 0) {
+                    aggregation.countEgress(member);
+                }
+            }
+        } else if (aggregation.involves(decision.egressPorts)) {
+            decision.egressPorts = aggregation.distribute(decision.egressPorts,
+                                                          LinkAggregation::flowHash(frame, lagHash));
+        }
+    }
     
-    // Statistics
-    int framesProcessed;
-    int learningEvents;
-    int forwardingEvents;
-    int floodingEvents;
+    /**
+     * @brief Drops snooped memberships that timed out, at most once per clock tick
+     */
+    void expireGroups(MacTable::Timestamp stamp) {
+        if (multicastSnooping && stamp != groupsExpiredAt) {
+            groupsExpiredAt = stamp;
+            groupTable.expire(stamp);
+        }
+    }
+    
+    /**
+     * @brief Copies a frame into the pool once and queues it on every egress port
+     * 
+     * The frame's priority selects the traffic class. Ports whose queue for
+     * that class is full tail-drop it before a buffer is taken; frames that
+     * find no free buffer are dropped and counted by the pool.
+     */
+    void enqueueEgress(const FrameView& frame, const ForwardDecision& decision);
+    
+    /**
+     * @brief A queued frame as it leaves the switch
+     */
+    FrameView egressView(const PacketDescriptor& descriptor) const;
+    
+    /**
+     * @brief Lets every port send one cycle's worth of line rate
+     */
+    void serviceEgress();
+    
+    static const FrameView& viewOf(const FrameView& frame) { return frame; }
+    static FrameView viewOf(const Frame& frame) { return frame.view(); }
+    
+    /**
+     * @brief Shared body of the processBurst() overloads
+     */
+    template <typename FrameT>
+    void processBurstOf(const FrameT* frames, const int* ports, std::size_t count,
+                        ForwardDecision* decisions);
+    
+    /**
+     * @brief Updates statistics and notifies the observer of a decision
+     */
+    void recordDecision(const ForwardDecision& decision, MacAddress destMAC, int incomingPort);
+    
+    /**
+     * @brief Lets a buffering observer write out its trace before a report prints
+     */
+    void flushObserver() const {
+        if (observer) {
+            observer->flush();
+        }
+    }
     
 public:
     /**
@@ -59,19 +321,57 @@ public:
      */
     Switch(int ports = 8, int timeout = 300);
     
+    /**
+     * @brief Constructs a Switch with an explicit configuration
+     * 
+     * Use this form to select the MAC table engine and its capacity.
+     * 
+     * @param config Port count, aging and table settings
+     * @throws std::invalid_argument if the port count is outside 1..PortMask::kMaxPorts
+     */
+    explicit Switch(const SwitchConfig& config);
+    
+    /**
+     * @brief Forwarding rules applied to one destination
+     * 
+     * Shared with ParallelSwitch so both pipelines forward identically.
+     * Floods are confined to floodPorts, and a destination learned on a
+     * port outside it is treated as unknown.
+     * 
+     * @param table Table to look the destination up in
+     * @param floodPorts Ports of the frame's VLAN (every port without VLANs)
+     * @param dest Destination address of the frame and its VLAN
+     * @param incomingPort Port the frame arrived on
+     */
+    static ForwardDecision decide(const MacTable& table, const PortMask& floodPorts,
+                                  FdbKey dest, int incomingPort);
+    
     /**
      * @brief Processes an incoming Ethernet frame
      * 
      * This is the core switching logic:
-     * 1. Learning: Associates source MAC with incoming port
-     * 2. Forwarding decision:
+     * 1. VLAN classification: tag VID or the port's PVID; frames for a VLAN
+     *    the port is not a member of are dropped
+     * 2. Learning: Associates source MAC with incoming port, per VLAN
+     * 3. Forwarding decision:
      *    - Known Unicast: Forward to specific port
-     *    - Unknown Unicast/Broadcast: Flood all ports except incoming
+     *    - Unknown Unicast/Broadcast: Flood the VLAN's ports except incoming
      * 
      * @param frame The Ethernet frame to process
      * @param incomingPort The port number where the frame arrived
+     * @return The forwarding decision taken for the frame
+     */
+    ForwardDecision processFrame(const Frame& frame, int incomingPort);
+    
+    /**
+     * @brief Processes a frame held in a caller-owned buffer
+     * 
+     * Nothing is copied; only the decoded header fields are read.
+     * 
+     * @param frame View of the frame to process
+     * @param incomingPort The port number where the frame arrived
      */
-    void processFrame(const Frame& frame, int incomingPort);
+    ForwardDecision processFrame(const FrameView& frame, int incomingPort);
     
     /**
      * @brief Overloaded version with individual MAC parameters
@@ -80,7 +380,53 @@ public:
      * @param destMAC Destination MAC address
      * @param incomingPort Port where frame arrived
      */
-    void processFrame(const std::string& sourceMAC, const std::string& destMAC, int incomingPort);
+    ForwardDecision processFrame(MacAddress sourceMAC, MacAddress destMAC, int incomingPort);
+    
+    /**
+     * @brief Convenience adapter taking MAC addresses as text
+     * 
+     * The addresses are parsed once and handed to the binary overload.
+     * 
+     * @throws std::invalid_argument if either address is malformed
+     */
+    ForwardDecision processFrame(const std::string& sourceMAC, const std::string& destMAC, int incomingPort);
+    
+    /**
+     * @brief Processes a burst of frames in one call
+     * 
+     * Amortizes per-frame overhead the way poll-mode drivers do: the clock is
+     * read once for the whole burst, every source address is learned before
+     * any destination is looked up, and table buckets are prefetched a phase
+     * ahead of use. Because all learns happen first, a destination learned by
+     * a later frame in the same burst is already known to earlier frames.
+     * Observer events are still reported per frame, in burst order.
+     * 
+     * @param frames Frames to process
+     * @param ports Ingress port of each frame (same length as frames)
+     * @return One decision per frame, in order
+     * @throws std::invalid_argument if frames and ports differ in length
+     */
+    std::vector<ForwardDecision> processBurst(const std::vector<Frame>& frames,
+                                              const std::vector<int>& ports);
+    
+    /**
+     * @brief Allocation-free burst form writing into caller storage
+     * 
+     * @param frames Array of count frames
+     * @param ports Array of count ingress ports
+     * @param count Number of frames
+     * @param decisions Array receiving count decisions
+     */
+    void processBurst(const Frame* frames, const int* ports, std::size_t count,
+                      ForwardDecision* decisions);
+    
+    /**
+     * @brief Burst form for frames decoded in place (e.g. from a capture)
+     * 
+     * Only the header fields are read; payloads are never touched.
+     */
+    void processBurst(const FrameView* frames, const int* ports, std::size_t count,
+                      ForwardDecision* decisions);
     
     /**
      * @brief Removes aged-out entries from the MAC table
@@ -89,36 +435,382 @@ public:
      * - Moved devices (same MAC appears on different port)
      * - Disconnected devices (free up table space)
      * - Topology changes
+     * 
+     * Entries are kept on a timing wheel, so this only visits entries that
+     * have come due, not the whole table.
      */
     void cleanupTable();
     
+    /**
+     * @brief Performs a bounded slice of aging work
+     * 
+     * Lets aging be interleaved with frame processing so a large expiry
+     * wave never stalls forwarding for long.
+     * 
+     * @param budget Maximum scheduled entries to examine (0 = no limit)
+     * @return Number of entries removed
+     */
+    std::size_t agingStep(std::size_t budget);
+    
+    /**
+     * @brief Transmits frames queued on a port immediately
+     * 
+     * Frames leave in scheduler order (strict priority, then DRR) but the
+     * line rate is not applied. Each transmitted frame drops its reference
+     * to the pooled buffer, which is freed once every port of a flood has
+     * sent it.
+     * 
+     * @param port Port to transmit from
+     * @param maxFrames Upper bound on frames sent (0 = all queued)
+     * @param sink Called with each frame before its buffer is released (may be empty)
+     * @return Number of frames transmitted
+     * @throws std::invalid_argument if the port does not exist
+     */
+    std::size_t transmit(int port, std::size_t maxFrames,
+                         const std::function<void(const FrameView&)>& sink = nullptr);
+    
+    /**
+     * @brief Frames waiting on a port (0 when egress is not modelled)
+     */
+    std::size_t getEgressQueueDepth(int port) const;
+    
+    /**
+     * @brief Counters of one traffic class queue of a port
+     * 
+     * @throws std::invalid_argument if egress is not modelled or the port
+     *         or class does not exist
+     */
+    const QueueCounters& getEgressCounters(int port, int trafficClass) const;
+    
+    /**
+     * @brief Sets the receiver of frames sent by the per-cycle scheduler
+     * 
+     * Called with the port and frame before its buffer reference is dropped.
+     */
+    void setTransmitHandler(std::function<void(int, const FrameView&)> handler) {
+        transmitHandler = std::move(handler);
+    }
+    
+    /**
+     * @brief The egress buffer pool, or nullptr when egress is not modelled
+     */
+    const PacketPool* getPacketPool() const { return packetPool.get(); }
+    
+    /**
+     * @brief Sets the member ports of a VLAN
+     * 
+     * Every port starts as a member of VLAN 1 only, with PVID 1, which
+     * behaves like a switch without VLANs. An empty set removes the VLAN.
+     * 
+     * @param vlan VLAN ID (1..4094)
+     * @param members Ports that carry the VLAN
+     * @throws std::invalid_argument if the VID or a port is out of range
+     */
+    void setVlanMembers(uint16_t vlan, const PortMask& members);
+    
+    /**
+     * @brief Sets the VLAN assigned to untagged frames arriving on a port
+     * 
+     * The port must also be a member of that VLAN for them to be admitted.
+     * 
+     * @throws std::invalid_argument if the port or VID is out of range
+     */
+    void setPortVlan(int port, uint16_t vlan);
+    
+    /**
+     * @brief Member ports of a VLAN (empty if it is not configured)
+     */
+    PortMask getVlanMembers(uint16_t vlan) const { return membersOf(vlan); }
+    
+    /**
+     * @brief PVID of a port
+     * 
+     * @throws std::invalid_argument if the port does not exist
+     */
+    uint16_t getPortVlan(int port) const;
+    
+    /**
+     * @brief Sets the spanning tree state of a port
+     * 
+     * Every port starts Forwarding, which behaves like a switch without a
+     * spanning tree. Frames arriving on a Discarding port are dropped
+     * unlearned, those on a Learning port are learned and then dropped, and
+     * neither kind of port is used for egress. Setting the state of a LAG
+     * ID sets it on every member.
+     * 
+     * @throws std::invalid_argument if the port does not exist
+     */
+    void setPortState(int port, PortState state);
+    
+    /**
+     * @throws std::invalid_argument if the port does not exist
+     */
+    PortState getPortState(int port) const;
+    
+    /**
+     * @brief Ports currently in the Forwarding state
+     */
+    const PortMask& getForwardingPorts() const { return forwardingPorts; }
+    
+    /**
+     * @brief Removes the addresses learned on one port (in every VLAN)
+     * 
+     * What a switch does when a port goes down or the spanning tree
+     * reports a topology change, without forgetting stations elsewhere.
+     * Costs one erase per address on the port, not a table scan.
+     * 
+     * @return Number of entries removed
+     * @throws std::invalid_argument if the port does not exist
+     */
+    std::size_t flushPort(int port);
+    
+    /**
+     * @brief Removes the addresses learned on any of a set of ports
+     * 
+     * Only the entries on the flushed ports are visited. Ports the switch
+     * does not have are ignored.
+     * 
+     * @return Number of entries removed
+     */
+    std::size_t flushPorts(const PortMask& ports);
+    
+    /**
+     * @brief Bundles ports into a link aggregation group
+     * 
+     * The LAG is one logical port with the lowest member's number as its
+     * ID: stations behind any member are learned on the ID, floods send one
+     * copy per LAG, and each frame leaves on the member its flow hash
+     * picks (SwitchConfig::lagHash). The LAG's VLAN membership and
+     * spanning tree state are those of its ID port. Entries learned on the
+     * members before are flushed.
+     * 
+     * @return The LAG ID
+     * @throws std::invalid_argument if the set is empty, or a port does not
+     *         exist or is already aggregated
+     */
+    int addLag(const PortMask& members);
+    
+    /**
+     * @brief Splits a LAG back into individual ports, flushing its entries
+     * 
+     * @throws std::invalid_argument if lag is not a LAG ID
+     */
+    void removeLag(int lag);
+    
+    /**
+     * @brief Brings a LAG member link up or down
+     * 
+     * Flows on a down member move to the remaining ones. When the last
+     * member goes down the LAG's entries are flushed, as for a port down.
+     * 
+     * @throws std::invalid_argument if the port is not in a LAG
+     */
+    void setLagMemberActive(int port, bool active);
+    
+    /**
+     * @brief Logical port of a physical port (its LAG ID, or the port itself)
+     * 
+     * @throws std::invalid_argument if the port does not exist
+     */
+    int getLagOf(int port) const;
+    
+    /**
+     * @brief The switch's LAGs, with per-member load counters
+     */
+    const LinkAggregation& getLinkAggregation() const { return aggregation; }
+    
+    /**
+     * @brief Displays every LAG with the frames sent on each member
+     */
+    void printLagStatistics() const;
+    
+    /**
+     * @brief Adds a static member port to a multicast group
+     * 
+     * Static members never expire; frames to the group go to its members
+     * and the VLAN's router ports instead of being flooded. Works with or
+     * without snooping.
+     * 
+     * @param group Group MAC address (e.g. MulticastTable::groupMac(0xEF010203))
+     * @return true if the port was not already a member
+     * @throws std::invalid_argument if the address is not a multicast group,
+     *         or the port or VID is out of range
+     */
+    bool joinGroup(MacAddress group, int port, uint16_t vlan = FdbKey::kDefaultVlan);
+    
+    /**
+     * @brief Removes a member port from a multicast group
+     * 
+     * When the last member leaves, frames to the group are flooded again.
+     * 
+     * @return true if the port was a member
+     */
+    bool leaveGroup(MacAddress group, int port, uint16_t vlan = FdbKey::kDefaultVlan);
+    
+    /**
+     * @brief Makes a port a static multicast router port of a VLAN
+     * 
+     * Router ports receive every group's traffic and every report.
+     * 
+     * @throws std::invalid_argument if the port or VID is out of range
+     */
+    void addMulticastRouterPort(int port, uint16_t vlan = FdbKey::kDefaultVlan);
+    
+    /**
+     * @brief The multicast group table
+     */
+    const MulticastTable& getGroupTable() const { return groupTable; }
+    
     /**
      * @brief Displays the current MAC address table
      */
     void printMACTable() const;
     
+    /**
+     * @brief Displays the multicast groups and their member ports
+     */
+    void printGroupTable() const;
+    
     /**
      * @brief Displays switch statistics
+     * 
+     * Instrumented builds append the per-stage timings.
      */
     void printStatistics() const;
     
+    /**
+     * @brief Displays the counters of every port that has received frames
+     */
+    void printPortStatistics() const;
+    
+    /**
+     * @brief Counters summed over all ports
+     * 
+     * Safe to call from another thread while frames are being processed.
+     */
+    PortStatistics getStatistics() const { return counters.getTotal(); }
+    
+    /**
+     * @brief Counters of frames received on one port
+     * 
+     * @throws std::invalid_argument if the port does not exist
+     */
+    PortStatistics getPortStatistics(int port) const;
+    
+    /**
+     * @brief Time spent in each forwarding stage
+     * 
+     * @return nullptr unless built with L2SIM_INSTRUMENT (make INSTRUMENT=1)
+     */
+    const StageProfile* getStageProfile() const;
+    
+    /**
+     * @brief Displays the counters of every egress queue that has seen traffic
+     */
+    void printEgressStatistics() const;
+    
     /**
      * @brief Clears all learned MAC addresses
      */
     void clearMACTable();
     
     /**
-     * @brief Advances the simulation cycle (for aging)
+     * @brief Writes every learned address to a binary snapshot file
+     * 
+     * Each entry is stored with its port and its age, so a switch that loads
+     * the file later sees the same ages whatever its own clock reads. See
+     * TableSnapshot for the format.
+     * 
+     * @return Number of entries written
+     * @throws std::runtime_error if the file cannot be written
+     */
+    std::size_t saveTable(const std::string& path) const;
+    
+    /**
+     * @brief Replaces the MAC table with the contents of a snapshot file
+     * 
+     * Entries keep their saved ages and are filed for aging as if they had
+     * been learned that long ago. Entries older than the aging timeout, on
+     * ports this switch does not have, or beyond the table's capacity are
+     * skipped. This is a warm start, not traffic: no learning events are
+     * counted or reported. If the switch's clock is younger than the oldest
+     * entry restored, the clock is first moved forward to that age.
+     * 
+     * @return Number of entries restored
+     * @throws std::runtime_error if the file cannot be read, is not a
+     *         snapshot, or its ages are in a different AgingClock than the
+     *         switch's
+     */
+    std::size_t loadTable(const std::string& path);
+    
+    /**
+     * @brief Advances the simulation cycle (for aging and egress)
+     * 
+     * With AgingClock::Logical this is the switch's only time source, so
+     * simulated time can run arbitrarily faster than wall-clock time. When
+     * egress is modelled each cycle also runs the port schedulers, which
+     * send up to SwitchConfig::egress.lineRate bytes per port.
      */
     void advanceCycle();
     
+    /**
+     * @brief Advances the simulation by several cycles at once
+     * 
+     * Schedulers run once per cycle while frames are queued; the idle rest
+     * of the interval is skipped in one step.
+     */
+    void advanceCycles(uint32_t cycles);
+    
+    /**
+     * @brief Gets the current simulation cycle
+     */
+    uint32_t getCurrentCycle() const { return currentCycle; }
+    
     /**
      * @brief Gets the number of entries in the MAC table
      */
-    int getMACTableSize() const { return macTable.size(); }
+    int getMACTableSize() const { return static_cast<int>(macTable->size()); }
+    
+    /**
+     * @brief Gets the number of addresses learned on a port (in every VLAN)
+     * 
+     * Kept up to date by the table, so it is cheap enough to check against a
+     * port security limit on every frame.
+     * 
+     * @throws std::invalid_argument if the port does not exist
+     */
+    int getPortMACCount(int port) const;
+    
+    /**
+     * @brief Gets the name of the MAC table engine in use
+     */
+    const char* getTableEngineName() const { return macTable->name(); }
+    
+    /**
+     * @brief Gets the heap memory held by the forwarding database
+     * 
+     * The MAC table engine's allocations (entries, spare slots and indexes),
+     * plus the aging wheel's buckets, so bytesPerEntry() is what one learned
+     * station really costs.
+     */
+    MemoryUsage getMemoryUsage() const;
+    
+    /**
+     * @brief Replaces the event observer
+     * 
+     * @param newObserver Observer to notify, or nullptr for silent operation
+     */
+    void setObserver(SwitchObserver* newObserver) { observer = newObserver; }
     
     /**
      * @brief Checks if a MAC address is in the table
+     * 
+     * @param vlan VLAN to look in (the default VLAN when omitted)
+     */
+    bool isLearned(MacAddress mac, uint16_t vlan = FdbKey::kDefaultVlan) const;
+    
+    /**
+     * @brief Text adapter for isLearned(); malformed addresses are never learned
      */
     bool isLearned(const std::string& mac) const;
 };
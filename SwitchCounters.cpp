@@ -0,0 +1,56 @@
+#include "SwitchCounters.h"
+#include <algorithm>
+
+uint64_t PortStatistics::frames() const {
+    uint64_t total = 0;
+    for (uint64_t count : decisions) {
+        total += count;
+    }
+    return total;
+}
+
+PortStatistics& PortStatistics::operator+=(const PortStatistics& other) {
+    bytes += other.bytes;
+    learned += other.learned;
+    moves += other.moves;
+    tableFull += other.tableFull;
+    evictions += other.evictions;
+    for (int kind = 0; kind < kForwardKinds; kind++) {
+        decisions[kind] += other.decisions[kind];
+    }
+    return *this;
+}
+
+SwitchCounters::SwitchCounters(int ports)
+    : numPorts(std::max(ports, 0)), shards(new Shard[numPorts + 1]) {
+    for (int shard = 0; shard <= numPorts; shard++) {
+        for (std::atomic<uint64_t>& value : shards[shard].values) {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+PortStatistics SwitchCounters::getPort(int port) const {
+    PortStatistics stats;
+    if (port < 0 || port > numPorts) {
+        return stats;
+    }
+    const Shard& shard = shards[port];
+    stats.bytes = shard.values[kBytes].load(std::memory_order_relaxed);
+    stats.learned = shard.values[kLearned].load(std::memory_order_relaxed);
+    stats.moves = shard.values[kMoves].load(std::memory_order_relaxed);
+    stats.tableFull = shard.values[kTableFull].load(std::memory_order_relaxed);
+    stats.evictions = shard.values[kEvictions].load(std::memory_order_relaxed);
+    for (int kind = 0; kind < kForwardKinds; kind++) {
+        stats.decisions[kind] = shard.values[kDecisions + kind].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+PortStatistics SwitchCounters::getTotal() const {
+    PortStatistics total;
+    for (int port = 0; port <= numPorts; port++) {
+        total += getPort(port);
+    }
+    return total;
+}
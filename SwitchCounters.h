@@ -0,0 +1,110 @@
+#ifndef SWITCH_COUNTERS_H
+#define SWITCH_COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ForwardDecision.h"
+#include "MacTable.h"
+
+/**
+ * @brief Counter totals for one ingress port, or summed over a switch
+ */
+struct PortStatistics {
+    uint64_t bytes = 0;         // Bytes received (wire length without FCS)
+    uint64_t learned = 0;       // New stations learned
+    uint64_t moves = 0;         // Known stations that moved to this port
+    uint64_t tableFull = 0;     // Sources not learned because the table was full
+    uint64_t evictions = 0;     // Entries replaced to learn a source on this port
+    uint64_t decisions[kForwardKinds] = {};     // Frames received, by forwarding outcome
+
+    uint64_t of(ForwardKind kind) const { return decisions[static_cast<int>(kind)]; }
+
+    // Every received frame gets exactly one decision
+    uint64_t frames() const;
+
+    uint64_t flooded() const { return of(ForwardKind::Broadcast) + of(ForwardKind::UnknownUnicast); }
+
+    PortStatistics& operator+=(const PortStatistics& other);
+};
+
+/**
+ * @brief 64-bit switch counters sharded by ingress port
+ *
+ * Each port's counters live in their own cache-line-aligned shard, and
+ * every shard has a single writer: the thread processing that port's frames
+ * (the only thread for a Switch, the owning worker for a ParallelSwitch). An
+ * update is therefore a relaxed load and store, with no locked instruction
+ * and no cache line bouncing between forwarding threads. Readers on any
+ * thread sum the shards with relaxed loads, so taking statistics never
+ * stalls forwarding; a total read while frames are in flight may be a few
+ * frames behind, but no counter is ever torn.
+ *
+ * Frames on ports the switch does not have are counted in a shard of their
+ * own, which only shows up in the totals.
+ */
+class SwitchCounters {
+public:
+    /**
+     * @param ports Number of ports (shards 1..ports, plus one for bad ports)
+     */
+    explicit SwitchCounters(int ports);
+
+    void countBytes(int port, uint64_t bytes) { bump(shardOf(port).values[kBytes], bytes); }
+
+    void countLearn(int port, LearnResult result, uint64_t times = 1) {
+        if (result == LearnResult::Learned) {
+            bump(shardOf(port).values[kLearned], times);
+        } else if (result == LearnResult::Moved) {
+            bump(shardOf(port).values[kMoves], times);
+        } else if (result == LearnResult::TableFull) {
+            bump(shardOf(port).values[kTableFull], times);
+        }
+    }
+
+    void countLearn(int port, const LearnOutcome& outcome) {
+        countLearn(port, outcome.result);
+        if (outcome.evicted()) {
+            bump(shardOf(port).values[kEvictions], 1);
+        }
+    }
+
+    void countDecision(int port, ForwardKind kind, uint64_t times = 1) {
+        bump(shardOf(port).values[kDecisions + static_cast<int>(kind)], times);
+    }
+
+    /**
+     * @brief Counters of one port (0 for the shard of non-existent ports)
+     */
+    PortStatistics getPort(int port) const;
+
+    /**
+     * @brief Counters summed over every shard
+     */
+    PortStatistics getTotal() const;
+
+    int getPortCount() const { return numPorts; }
+
+private:
+    enum Index { kBytes, kLearned, kMoves, kTableFull, kEvictions, kDecisions };
+    static constexpr int kValues = kDecisions + kForwardKinds;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> values[kValues];
+    };
+
+    int numPorts;
+    std::unique_ptr<Shard[]> shards;    // Indexed by port; 0 holds non-existent ports
+
+    Shard& shardOf(int port) {
+        return shards[port >= 1 && port <= numPorts ? port : 0];
+    }
+
+    // Single-writer increment
+    static void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+#endif // SWITCH_COUNTERS_H
@@ -0,0 +1,284 @@
+#include "SwitchObserver.h"
+#include <string>
+
+// ANSI color codes for better output readability
+#define RESET   "\033[0m"
+#define RED     "\033[31m"
+#define GREEN   "\033[32m"
+#define YELLOW  "\033[33m"
+#define BLUE    "\033[34m"
+#define MAGENTA "\033[35m"
+#define CYAN    "\033[36m"
+
+// ===== ConsoleObserver =====
+
+void ConsoleObserver::onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) {
+    out << CYAN << "╔════════════════════════════════════════════════╗\n";
+    out << "║  Layer 2 Ethernet Learning Switch Simulator    ║\n";
+    out << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    out << "Switch initialized with " << numPorts << " ports\n";
+    if (agingTimeout > 0) {
+        out << "MAC aging enabled: " << agingTimeout
+            << (clock == AgingClock::Logical ? " cycles (logical clock)\n" : " seconds\n");
+    }
+    out << std::string(50, '-') << "\n\n";
+}
+
+void ConsoleObserver::onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                                      MacAddress destMAC, int incomingPort) {
+    out << BLUE << "Frame #" << frameNumber << " received on Port " << incomingPort << RESET << "\n";
+    out << "  Source MAC: " << GREEN << sourceMAC << RESET << "\n";
+    out << "  Dest MAC:   " << YELLOW << destMAC << RESET << "\n";
+}
+
+void ConsoleObserver::onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) {
+    switch (outcome.result) {
+        case LearnResult::Learned:
+            out << "  " << GREEN << "✓ LEARNING:" << RESET
+                << " Added " << sourceMAC << " -> Port " << incomingPort << "\n";
+            if (outcome.evicted()) {
+                out << "  " << YELLOW << "⚠ EVICTED:" << RESET << " " << outcome.evictedKey.mac()
+                    << " (Port " << outcome.evictedPort << ") to make room\n";
+            }
+            break;
+        case LearnResult::Moved:
+            out << "  " << YELLOW << "⚠ UPDATE:" << RESET
+                << " " << sourceMAC << " moved from Port "
+                << outcome.previousPort << " to Port " << incomingPort << "\n";
+            break;
+        case LearnResult::Refreshed:
+            out << "  " << "↻ REFRESH:" << " " << sourceMAC
+                << " timestamp updated on Port " << incomingPort << "\n";
+            break;
+        case LearnResult::TableFull:
+            // Table at capacity - frame is still forwarded, source is not learned
+            out << "  " << RED << "✗ TABLE FULL:" << RESET
+                << " Could not learn " << sourceMAC << "\n";
+            break;
+    }
+}
+
+void ConsoleObserver::onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                                 int incomingPort) {
+    out << "  ";
+
+    switch (decision.kind) {
+        case ForwardKind::Broadcast:
+            out << MAGENTA << "⚡ BROADCAST:" << RESET
+                << " Flooding to all ports except Port " << incomingPort << "\n";
+            break;
+        case ForwardKind::Filter:
+            // Destination is on the same segment - filter/drop
+            out << CYAN << "⊗ FILTERING:" << RESET
+                << " Destination on same port (Port " << incomingPort << ") - frame dropped\n";
+            break;
+        case ForwardKind::Forward:
+            out << GREEN << "→ FORWARDING:" << RESET
+                << " Sending to Port " << decision.outPort << " (Known Unicast)\n";
+            break;
+        case ForwardKind::UnknownUnicast:
+            out << RED << "⚠ UNKNOWN UNICAST:" << RESET
+                << " Destination " << destMAC << " not in MAC table\n";
+            out << "    Flooding to all ports except Port " << incomingPort << "\n";
+            break;
+        case ForwardKind::Drop:
+            out << RED << "✗ DROPPED:" << RESET
+                << " Port " << incomingPort << " is not a member of the frame's VLAN\n";
+            break;
+        case ForwardKind::Blocked:
+            out << RED << "✗ BLOCKED:" << RESET
+                << " Port " << incomingPort << " is not forwarding (spanning tree)\n";
+            break;
+        case ForwardKind::Multicast:
+            out << MAGENTA << "⊕ MULTICAST:" << RESET << " Group " << destMAC << " to ports ";
+            decision.egressPorts.forEach([this](int port) { out << port << " "; });
+            out << "\n";
+            break;
+    }
+
+    if (decision.isFlood()) {
+        // Show which ports would receive the frame
+        out << "    Flooding ports: ";
+        decision.egressPorts.forEach([this](int port) { out << port << " "; });
+        out << "\n";
+    }
+
+    out << "\n";
+}
+
+void ConsoleObserver::onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) {
+    out << YELLOW << "⌛ AGING OUT: " << RESET
+        << mac << " (last seen " << elapsed
+        << (clock == AgingClock::Logical ? " cycles ago)\n" : "s ago)\n");
+}
+
+void ConsoleObserver::onAgingComplete(std::size_t removed) {
+    if (removed > 0) {
+        out << "Removed " << removed << " aged entries from MAC table\n\n";
+    }
+}
+
+void ConsoleObserver::onTableCleared() {
+    out << "MAC table cleared\n\n";
+}
+
+SwitchObserver* consoleObserver() {
+    static ConsoleObserver instance;
+    return &instance;
+}
+
+// ===== SampledObserver =====
+
+void SampledObserver::onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) {
+    inner.onSwitchCreated(numPorts, agingTimeout, clock);
+}
+
+void SampledObserver::onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                                      MacAddress destMAC, int incomingPort) {
+    sampling = (frameNumber % interval) == 0;
+    if (sampling) {
+        inner.onFrameReceived(frameNumber, sourceMAC, destMAC, incomingPort);
+    }
+}
+
+void SampledObserver::onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) {
+    if (sampling) {
+        inner.onLearn(sourceMAC, incomingPort, outcome);
+    }
+}
+
+void SampledObserver::onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                                 int incomingPort) {
+    if (sampling) {
+        inner.onDecision(decision, destMAC, incomingPort);
+    }
+}
+
+void SampledObserver::onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) {
+    inner.onAgeOut(mac, elapsed, clock);
+}
+
+void SampledObserver::onAgingComplete(std::size_t removed) {
+    inner.onAgingComplete(removed);
+}
+
+void SampledObserver::onTableCleared() {
+    inner.onTableCleared();
+}
+
+// ===== BufferedObserver =====
+
+namespace {
+
+ObserverEvent makeEvent(ObserverEvent::Type type) {
+    ObserverEvent event{};
+    event.type = type;
+    return event;
+}
+
+} // namespace
+
+void replayEvent(const ObserverEvent& event, SwitchObserver& target) {
+    switch (event.type) {
+        case ObserverEvent::Type::SwitchCreated:
+            target.onSwitchCreated(event.port, static_cast<int>(event.value), event.clock);
+            break;
+        case ObserverEvent::Type::FrameReceived:
+            target.onFrameReceived(event.value, event.mac, event.peer, event.port);
+            break;
+        case ObserverEvent::Type::Learn:
+            target.onLearn(event.mac, event.port, event.learn);
+            break;
+        case ObserverEvent::Type::Decision:
+            target.onDecision(event.decision, event.peer, event.port);
+            break;
+        case ObserverEvent::Type::AgeOut:
+            target.onAgeOut(event.mac, static_cast<long long>(event.value), event.clock);
+            break;
+        case ObserverEvent::Type::AgingComplete:
+            target.onAgingComplete(static_cast<std::size_t>(event.value));
+            break;
+        case ObserverEvent::Type::TableCleared:
+            target.onTableCleared();
+            break;
+    }
+}
+
+BufferedObserver::BufferedObserver(std::size_t capacity)
+    : maxEvents(capacity), droppedEvents(0) {
+    if (maxEvents > 0) {
+        buffer.reserve(maxEvents);
+    }
+}
+
+void BufferedObserver::record(const ObserverEvent& event) {
+    if (maxEvents > 0 && buffer.size() >= maxEvents) {
+        droppedEvents++;
+        return;
+    }
+    buffer.push_back(event);
+}
+
+void BufferedObserver::onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::SwitchCreated);
+    event.port = numPorts;
+    event.value = static_cast<uint64_t>(agingTimeout);
+    event.clock = clock;
+    record(event);
+}
+
+void BufferedObserver::onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                                       MacAddress destMAC, int incomingPort) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::FrameReceived);
+    event.value = frameNumber;
+    event.mac = sourceMAC;
+    event.peer = destMAC;
+    event.port = incomingPort;
+    record(event);
+}
+
+void BufferedObserver::onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::Learn);
+    event.mac = sourceMAC;
+    event.port = incomingPort;
+    event.learn = outcome;
+    record(event);
+}
+
+void BufferedObserver::onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                                  int incomingPort) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::Decision);
+    event.decision = decision;
+    event.peer = destMAC;
+    event.port = incomingPort;
+    record(event);
+}
+
+void BufferedObserver::onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::AgeOut);
+    event.mac = mac;
+    event.value = static_cast<uint64_t>(elapsed);
+    event.clock = clock;
+    record(event);
+}
+
+void BufferedObserver::onAgingComplete(std::size_t removed) {
+    ObserverEvent event = makeEvent(ObserverEvent::Type::AgingComplete);
+    event.value = removed;
+    record(event);
+}
+
+void BufferedObserver::onTableCleared() {
+    record(makeEvent(ObserverEvent::Type::TableCleared));
+}
+
+void BufferedObserver::replay(SwitchObserver& target) const {
+    for (const ObserverEvent& event : buffer) {
+        replayEvent(event, target);
+    }
+}
+
+void BufferedObserver::clear() {
+    buffer.clear();
+    droppedEvents = 0;
+}
@@ -0,0 +1,214 @@
+#ifndef SWITCH_OBSERVER_H
+#define SWITCH_OBSERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "ForwardDecision.h"
+#include "MacAddress.h"
+#include "MacTable.h"
+
+/**
+ * @brief Receives a Switch's learning, forwarding and aging events
+ *
+ * The switch reports what it did through this interface rather than printing
+ * it, so the forwarding path is the same whether output goes to the console,
+ * to a sample of frames, to a memory buffer, or nowhere at all (a null
+ * observer pointer skips the calls entirely). Every method has an empty
+ * default, so observers only override the events they care about.
+ */
+class SwitchObserver {
+public:
+    virtual ~SwitchObserver() = default;
+
+    /**
+     * @brief A switch finished construction
+     */
+    virtual void onSwitchCreated(int /*numPorts*/, int /*agingTimeout*/, AgingClock /*clock*/) {}
+
+    /**
+     * @brief A frame arrived; the learn and decision events that follow belong to it
+     */
+    virtual void onFrameReceived(uint64_t /*frameNumber*/, MacAddress /*sourceMAC*/,
+                                 MacAddress /*destMAC*/, int /*incomingPort*/) {}
+
+    /**
+     * @brief The source address was learned, moved, refreshed or rejected
+     */
+    virtual void onLearn(MacAddress /*sourceMAC*/, int /*incomingPort*/,
+                         const LearnOutcome& /*outcome*/) {}
+
+    /**
+     * @brief The forwarding decision for the current frame
+     */
+    virtual void onDecision(const ForwardDecision& /*decision*/, MacAddress /*destMAC*/,
+                            int /*incomingPort*/) {}
+
+    /**
+     * @brief An entry was removed by aging
+     *
+     * @param elapsed Time since the entry was last seen, in clock units
+     */
+    virtual void onAgeOut(MacAddress /*mac*/, long long /*elapsed*/, AgingClock /*clock*/) {}
+
+    /**
+     * @brief An aging pass finished
+     */
+    virtual void onAgingComplete(std::size_t /*removed*/) {}
+
+    /**
+     * @brief All learned addresses were removed
+     */
+    virtual void onTableCleared() {}
+
+    /**
+     * @brief Writes out anything reported so far but still held back
+     *
+     * Called before the switch prints tables or statistics, so that they
+     * follow the trace of the frames that produced them.
+     */
+    virtual void flush() {}
+};
+
+/**
+ * @brief Writes the human-readable, colorized trace
+ *
+ * This is the simulator's classic output: several lines per frame, listing
+ * every flooded port. It is the default observer.
+ */
+class ConsoleObserver : public SwitchObserver {
+private:
+    std::ostream& out;
+
+public:
+    explicit ConsoleObserver(std::ostream& stream = std::cout) : out(stream) {}
+
+    void onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) override;
+    void onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                         MacAddress destMAC, int incomingPort) override;
+    void onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) override;
+    void onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                    int incomingPort) override;
+    void onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) override;
+    void onAgingComplete(std::size_t removed) override;
+    void onTableCleared() override;
+    void flush() override { out.flush(); }
+};
+
+/**
+ * @brief Returns the shared console observer used by default
+ */
+SwitchObserver* consoleObserver();
+
+/**
+ * @brief Forwards one frame in every N to another observer
+ *
+ * Non-frame events (creation, aging, clearing) are always forwarded.
+ */
+class SampledObserver : public SwitchObserver {
+private:
+    SwitchObserver& inner;
+    uint64_t interval;
+    bool sampling;      // Whether the current frame is being forwarded
+
+public:
+    /**
+     * @param target Observer that receives the sampled events
+     * @param every Forward frames whose number is a multiple of this (1 = all)
+     */
+    SampledObserver(SwitchObserver& target, uint64_t every)
+        : inner(target), interval(every > 0 ? every : 1), sampling(false) {}
+
+    void onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) override;
+    void onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                         MacAddress destMAC, int incomingPort) override;
+    void onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) override;
+    void onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                    int incomingPort) override;
+    void onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) override;
+    void onAgingComplete(std::size_t removed) override;
+    void onTableCleared() override;
+    void flush() override { inner.flush(); }
+};
+
+/**
+ * @brief Compact record of one observer callback
+ *
+ * Field meaning depends on type:
+ * - SwitchCreated:  port = numPorts, value = agingTimeout, clock
+ * - FrameReceived:  value = frame number, mac = source, peer = destination, port = ingress
+ * - Learn:          mac = source, port = ingress, learn = outcome
+ * - Decision:       peer = destination, port = ingress, decision
+ * - AgeOut:         mac = address, value = elapsed time, clock
+ * - AgingComplete:  value = entries removed
+ */
+struct ObserverEvent {
+    enum class Type : uint8_t {
+        SwitchCreated,
+        FrameReceived,
+        Learn,
+        Decision,
+        AgeOut,
+        AgingComplete,
+        TableCleared
+    };
+
+    Type type;
+    int port;
+    uint64_t value;
+    MacAddress mac;
+    MacAddress peer;
+    AgingClock clock;
+    LearnOutcome learn;
+    ForwardDecision decision;
+};
+
+/**
+ * @brief Dispatches a recorded event to an observer
+ */
+void replayEvent(const ObserverEvent& event, SwitchObserver& target);
+
+/**
+ * @brief Records events in memory for later inspection or replay
+ *
+ * Recording is a plain append, so the trace of a fast run can be rendered
+ * afterwards (e.g. by replaying into a ConsoleObserver) without slowing the
+ * run itself down with formatting and I/O.
+ */
+class BufferedObserver : public SwitchObserver {
+private:
+    std::vector<ObserverEvent> buffer;
+    std::size_t maxEvents;      // 0 = unbounded
+    uint64_t droppedEvents;     // Events discarded because the buffer was full
+
+    void record(const ObserverEvent& event);
+
+public:
+    /**
+     * @param capacity Maximum events kept (0 = unbounded); later events are counted and dropped
+     */
+    explicit BufferedObserver(std::size_t capacity = 0);
+
+    void onSwitchCreated(int numPorts, int agingTimeout, AgingClock clock) override;
+    void onFrameReceived(uint64_t frameNumber, MacAddress sourceMAC,
+                         MacAddress destMAC, int incomingPort) override;
+    void onLearn(MacAddress sourceMAC, int incomingPort, const LearnOutcome& outcome) override;
+    void onDecision(const ForwardDecision& decision, MacAddress destMAC,
+                    int incomingPort) override;
+    void onAgeOut(MacAddress mac, long long elapsed, AgingClock clock) override;
+    void onAgingComplete(std::size_t removed) override;
+    void onTableCleared() override;
+
+    const std::vector<ObserverEvent>& events() const { return buffer; }
+    uint64_t dropped() const { return droppedEvents; }
+
+    /**
+     * @brief Sends every recorded event, in order, to another observer
+     */
+    void replay(SwitchObserver& target) const;
+
+    void clear();
+};
+
+#endif // SWITCH_OBSERVER_H
@@ -0,0 +1,103 @@
+#include "TableSnapshot.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'L', '2', 'F', 'D', 'B', '\r', '\n', '\x1a'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t recordSize;
+    uint32_t agingClock;
+    uint64_t recordCount;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "snapshot header must stay 32 bytes");
+
+} // namespace
+
+void TableSnapshot::write(const std::string& path, AgingClock clock,
+                          const std::vector<SnapshotRecord>& records) {
+    SnapshotHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.agingClock = clock == AgingClock::Logical ? 1 : 0;
+    header.recordCount = records.size();
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("snapshot: cannot create " + path + ": " + std::strerror(errno));
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !records.empty()) {
+        ok = std::fwrite(records.data(), sizeof(SnapshotRecord), records.size(), file) == records.size();
+    }
+    if (std::fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        throw std::runtime_error("snapshot: cannot write " + path);
+    }
+}
+
+TableSnapshot::TableSnapshot(const std::string& path)
+    : mapping(nullptr), fileSize(0), first(nullptr), count(0), clock(AgingClock::WallClock) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("snapshot: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error("snapshot: " + path + " is not a table snapshot");
+    }
+    fileSize = static_cast<std::size_t>(info.st_size);
+
+    // The mapping outlives the descriptor
+    mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("snapshot: cannot map " + path + ": " + std::strerror(errno));
+    }
+    ::madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    SnapshotHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const char* problem = nullptr;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        problem = "is not a table snapshot";
+    } else if (header.byteOrder != kByteOrderMark) {
+        problem = "was written with a different byte order";
+    } else if (header.version != kVersion || header.recordSize != sizeof(SnapshotRecord)) {
+        problem = "is of an unsupported snapshot version";
+    } else if (header.agingClock > 1) {
+        problem = "has an unknown aging clock";
+    } else if (header.recordCount > (fileSize - sizeof(header)) / sizeof(SnapshotRecord)) {
+        problem = "is truncated";
+    }
+    if (problem) {
+        ::munmap(mapping, fileSize);
+        throw std::runtime_error("snapshot: " + path + " " + problem);
+    }
+
+    // The header keeps the records 8-byte aligned within the page-aligned mapping
+    first = reinterpret_cast<const SnapshotRecord*>(static_cast<const uint8_t*>(mapping) + sizeof(header));
+    count = static_cast<std::size_t>(header.recordCount);
+    clock = header.agingClock == 1 ? AgingClock::Logical : AgingClock::WallClock;
+}
+
+TableSnapshot::~TableSnapshot() {
+    ::munmap(mapping, fileSize);
+}
@@ -0,0 +1,83 @@
+#ifndef TABLE_SNAPSHOT_H
+#define TABLE_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MacTable.h"
+
+/**
+ * @brief One learned station in a table snapshot file
+ *
+ * Stored as-is on disk, so a mapped file is read as an array of these.
+ */
+struct SnapshotRecord {
+    uint64_t key;       // Packed (VLAN, MAC), as FdbKey::toUint64()
+    uint32_t port;      // Port the station was learned on
+    uint32_t age;       // Time since last seen when saved, in the snapshot's AgingClock units
+};
+
+static_assert(sizeof(SnapshotRecord) == 16, "snapshot records must stay 16 bytes");
+
+/**
+ * @brief Binary snapshot of a MAC table, for warm starts
+ *
+ * The format is a 32-byte header followed by a packed array of
+ * SnapshotRecord in the writer's byte order:
+ *
+ * | Offset | Size | Field |
+ * |--------|------|-------|
+ * | 0 | 8 | Magic "L2FDB\r\n\x1a" |
+ * | 8 | 4 | Format version (kVersion) |
+ * | 12 | 4 | Byte order mark 0x01020304 |
+ * | 16 | 4 | Record size (16) |
+ * | 20 | 4 | AgingClock the ages are in (0 = wall clock, 1 = logical) |
+ * | 24 | 8 | Record count |
+ *
+ * Ages rather than timestamps are stored, since each switch's clock starts
+ * at its own epoch. Reading maps the file and hands out the records in
+ * place, so restoring costs one table insert per entry and no parsing.
+ */
+class TableSnapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Writes a snapshot file, replacing any existing one
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void write(const std::string& path, AgingClock clock,
+                      const std::vector<SnapshotRecord>& records);
+
+    /**
+     * @brief Maps and validates a snapshot file
+     *
+     * @throws std::runtime_error if the file cannot be mapped, is not a
+     *         snapshot, is of another version or byte order, or is truncated
+     */
+    explicit TableSnapshot(const std::string& path);
+    ~TableSnapshot();
+
+    TableSnapshot(const TableSnapshot&) = delete;
+    TableSnapshot& operator=(const TableSnapshot&) = delete;
+
+    AgingClock getAgingClock() const { return clock; }
+
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief The records, pointing into the mapping; valid while this lives
+     */
+    const SnapshotRecord* records() const { return first; }
+
+private:
+    void* mapping;
+    std::size_t fileSize;
+    const SnapshotRecord* first;
+    std::size_t count;
+    AgingClock clock;
+};
+
+#endif // TABLE_SNAPSHOT_H
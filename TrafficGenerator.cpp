@@ -0,0 +1,97 @@
+#include "TrafficGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+TrafficGenerator::TrafficGenerator(const TrafficConfig& cfg)
+    : config(cfg), rng(cfg.seed), moveCount(0) {
+    if (config.stations == 0) {
+        config.stations = 1;
+    }
+    if (config.numPorts < 1) {
+        config.numPorts = 1;
+    }
+
+    std::uniform_int_distribution<int> portDist(1, config.numPorts);
+    stationMACs.reserve(config.stations);
+    stationPorts.reserve(config.stations);
+    for (std::size_t i = 0; i < config.stations; i++) {
+        stationMACs.push_back(stationAddress(i));
+        stationPorts.push_back(portDist(rng));
+    }
+
+    // Zipf: P(rank k) is proportional to 1 / k^s
+    if (config.zipfSkew > 0.0) {
+        zipfCdf.resize(config.stations);
+        double total = 0.0;
+        for (std::size_t k = 0; k < config.stations; k++) {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), config.zipfSkew);
+            zipfCdf[k] = total;
+        }
+        for (double& value : zipfCdf) {
+            value /= total;
+        }
+    }
+}
+
+MacAddress TrafficGenerator::stationAddress(std::size_t index) {
+    // 02:xx:xx:xx:xx:xx - locally administered unicast, never broadcast
+    return MacAddress(0x020000000000ULL | (static_cast<uint64_t>(index) & 0xFFFFFFFFFFULL));
+}
+
+std::size_t TrafficGenerator::pickStation() {
+    return std::uniform_int_distribution<std::size_t>(0, config.stations - 1)(rng);
+}
+
+std::size_t TrafficGenerator::pickDestination() {
+    if (zipfCdf.empty()) {
+        return pickStation();
+    }
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    auto it = std::lower_bound(zipfCdf.begin(), zipfCdf.end(), u);
+    if (it == zipfCdf.end()) {
+        --it;
+    }
+    return static_cast<std::size_t>(it - zipfCdf.begin());
+}
+
+TrafficRecord TrafficGenerator::next() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    if (config.moveRate > 0.0 && config.numPorts > 1 && unit(rng) < config.moveRate) {
+        // Re-home a random station onto a different port
+        std::size_t station = pickStation();
+        int offset = std::uniform_int_distribution<int>(1, config.numPorts - 1)(rng);
+        stationPorts[station] = (stationPorts[station] - 1 + offset) % config.numPorts + 1;
+        moveCount++;
+    }
+
+    std::size_t src = pickStation();
+    MacAddress dest;
+    if (unit(rng) < config.broadcastRatio) {
+        dest = MacAddress::broadcast();
+    } else {
+        std::size_t dst = pickDestination();
+        if (dst == src && config.stations > 1) {
+            dst = (dst + 1) % config.stations;
+        }
+        dest = stationMACs[dst];
+    }
+
+    return {stationMACs[src], dest, stationPorts[src]};
+}
+
+void TrafficGenerator::generate(std::size_t count, std::vector<TrafficRecord>& out) {
+    out.reserve(out.size() + count);
+    for (std::size_t i = 0; i < count; i++) {
+        out.push_back(next());
+    }
+}
+
+std::vector<TrafficRecord> TrafficGenerator::warmup() const {
+    std::vector<TrafficRecord> frames;
+    frames.reserve(config.stations);
+    for (std::size_t i = 0; i < config.stations; i++) {
+        frames.push_back({stationMACs[i], MacAddress::broadcast(), stationPorts[i]});
+    }
+    return frames;
+}
@@ -0,0 +1,81 @@
+#ifndef TRAFFIC_GENERATOR_H
+#define TRAFFIC_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "MacAddress.h"
+
+/**
+ * @brief Parameters of a synthetic traffic workload
+ */
+struct TrafficConfig {
+    std::size_t stations = 10000;   // Size of the MAC address population
+    int numPorts = 48;              // Ports the stations are spread across
+    double zipfSkew = 1.0;          // Destination popularity skew (0 = uniform)
+    double broadcastRatio = 0.01;   // Fraction of frames sent to FF:FF:FF:FF:FF:FF
+    double moveRate = 0.0;          // Probability per frame that some station changes port
+    uint64_t seed = 1;              // RNG seed; equal seeds give identical traffic
+};
+
+/**
+ * @brief One generated frame: who sent it, to whom, and where it entered
+ */
+struct TrafficRecord {
+    MacAddress sourceMAC;
+    MacAddress destMAC;
+    int port;
+};
+
+/**
+ * @brief Deterministic generator of switch traffic
+ *
+ * Each station has a fixed locally administered MAC and a home port.
+ * Sources are drawn uniformly; destinations follow a Zipf distribution so a
+ * few "servers" receive most of the traffic, as in real LANs. Station moves
+ * re-home a random station to a different port, exercising the MAC move path.
+ */
+class TrafficGenerator {
+private:
+    TrafficConfig config;
+    std::mt19937_64 rng;
+    std::vector<MacAddress> stationMACs;
+    std::vector<int> stationPorts;
+    std::vector<double> zipfCdf;        // Cumulative destination popularity by rank
+    uint64_t moveCount;
+
+    std::size_t pickStation();
+    std::size_t pickDestination();
+
+public:
+    explicit TrafficGenerator(const TrafficConfig& cfg);
+
+    /**
+     * @brief Generates the next frame
+     */
+    TrafficRecord next();
+
+    /**
+     * @brief Appends count frames to out
+     */
+    void generate(std::size_t count, std::vector<TrafficRecord>& out);
+
+    /**
+     * @brief One broadcast per station from its home port
+     *
+     * Feeding these first brings a switch to steady state, with every
+     * station learned, before measurement starts.
+     */
+    std::vector<TrafficRecord> warmup() const;
+
+    /**
+     * @brief The MAC address assigned to a station index
+     */
+    static MacAddress stationAddress(std::size_t index);
+
+    const TrafficConfig& getConfig() const { return config; }
+    uint64_t getMoveCount() const { return moveCount; }
+};
+
+#endif // TRAFFIC_GENERATOR_H
@@ -0,0 +1,1053 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncObserver.h"
+#include "BasicSwitch.h"
+#include "CompactMacTable.h"
+#include "ConcurrentMacTable.h"
+#include "Fabric.h"
+#include "HashMacTable.h"
+#include "ParallelSwitch.h"
+#include "Switch.h"
+#include "SwitchObserver.h"
+#include "TrafficGenerator.h"
+
+// ANSI color codes
+#define RESET   "\033[0m"
+#define BOLD    "\033[1m"
+#define CYAN    "\033[36m"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Benchmark command-line options
+ */
+struct BenchOptions {
+    TrafficConfig traffic;
+    std::size_t frames = 2000000;           // Frames in the throughput pass
+    std::size_t latencySamples = 200000;    // Individually timed frames
+    std::size_t burst = 32;                 // processBurst() size (0 = processFrame only)
+    std::size_t capacity = 0;               // Table capacity (0 = fit the population)
+    EvictionPolicy eviction = EvictionPolicy::NoLearn; // Throughput pass: what a full table does
+    std::vector<std::string> engines = {"hash", "flat", "concurrent", "compact"};
+    std::vector<std::string> observers = {"silent", "sampled", "buffered", "async"};
+    std::vector<int> threads = {1, 2, 4, 8, 16}; // ParallelSwitch worker counts (empty = skip)
+    int fabricSwitches = 256;               // Switches in the fabric pass (0 = skip)
+    int fabricFanout = 4;                   // Children per switch in the fabric tree
+    std::size_t fabricFrames = 1000000;     // Frames injected into the fabric
+    std::vector<int> fabricPartitions = {1, 2, 4}; // Fabric thread counts
+    std::string snapshotPath = "l2bench-table.bin"; // Scratch file for the warm start pass ("" = skip)
+    std::size_t snapshotEntries = 1000000;  // Stations in the warm start pass
+    std::size_t parseAddresses = 1000000;   // Address texts in the parsing pass (0 = skip)
+    int lagMembers = 4;                     // Ports 1..N bundled in the LAG pass (0 = skip)
+};
+
+/**
+ * @brief Stream buffer that discards everything written to it
+ *
+ * Lets the console observer's formatting cost be measured without the
+ * terminal becoming the bottleneck.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+struct BenchResult {
+    double mpps;
+    double p50;
+    double p99;
+    double p999;
+    int tableSize;
+    double floodPercent;
+    double bytesPerEntry;       // Table and aging wheel memory over the learned entries
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void printUsage() {
+    std::cout << "Usage: l2bench [options]\n"
+              << "  --frames N           Frames in the throughput pass (default 2000000)\n"
+              << "  --stations N         MAC population size (default 10000)\n"
+              << "  --ports N            Switch port count (default 48)\n"
+              << "  --zipf S             Destination Zipf skew, 0 = uniform (default 1.0)\n"
+              << "  --broadcast R        Broadcast frame ratio (default 0.01)\n"
+              << "  --moves R            Station move probability per frame (default 0)\n"
+              << "  --burst N            Burst size, 0 = frame at a time (default 32)\n"
+              << "  --capacity N         MAC table capacity (default: fits the population)\n"
+              << "  --eviction NAME      Full table in the throughput pass: none, lru or clock\n"
+              << "                       (default none; concurrent does not evict and is skipped)\n"
+              << "  --latency-samples N  Individually timed frames (default 200000)\n"
+              << "  --engines LIST       Table engines: hash,flat,concurrent,compact (default all)\n"
+              << "  --observers LIST     silent,sampled,buffered,console,async\n"
+              << "                       (default silent,sampled,buffered,async)\n"
+              << "  --threads LIST       Parallel worker counts, \"\" to skip (default 1,2,4,8,16)\n"
+              << "  --fabric-switches N  Switches in the fabric pass, 0 to skip (default 256)\n"
+              << "  --fabric-fanout N    Children per fabric switch (default 4)\n"
+              << "  --fabric-frames N    Frames injected into the fabric (default 1000000)\n"
+              << "  --fabric-partitions LIST  Fabric thread counts (default 1,2,4)\n"
+              << "  --snapshot PATH      Scratch file for the warm start pass, \"\" to skip\n"
+              << "                       (default l2bench-table.bin, removed afterwards)\n"
+              << "  --snapshot-entries N Stations saved and restored (default 1000000)\n"
+              << "  --parse-addresses N  Address texts in the parsing pass, 0 to skip (default 1000000)\n"
+              << "  --lag-members N      Ports 1..N bundled in the LAG pass, 0 to skip (default 4)\n"
+              << "  --seed N             Traffic RNG seed (default 1)\n";
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--frames") {
+            options.frames = std::stoull(value);
+        } else if (arg == "--stations") {
+            options.traffic.stations = std::stoull(value);
+        } else if (arg == "--ports") {
+            options.traffic.numPorts = std::stoi(value);
+        } else if (arg == "--zipf") {
+            options.traffic.zipfSkew = std::stod(value);
+        } else if (arg == "--broadcast") {
+            options.traffic.broadcastRatio = std::stod(value);
+        } else if (arg == "--moves") {
+            options.traffic.moveRate = std::stod(value);
+        } else if (arg == "--burst") {
+            options.burst = std::stoull(value);
+        } else if (arg == "--capacity") {
+            options.capacity = std::stoull(value);
+        } else if (arg == "--eviction" && (value == "none" || value == "lru" || value == "clock")) {
+            options.eviction = value == "none" ? EvictionPolicy::NoLearn
+                             : value == "lru"  ? EvictionPolicy::LRU : EvictionPolicy::Clock;
+        } else if (arg == "--latency-samples") {
+            options.latencySamples = std::stoull(value);
+        } else if (arg == "--engines") {
+            options.engines = splitList(value);
+        } else if (arg == "--observers") {
+            options.observers = splitList(value);
+        } else if (arg == "--threads") {
+            options.threads.clear();
+            for (const std::string& item : splitList(value)) {
+                options.threads.push_back(std::stoi(item));
+            }
+        } else if (arg == "--fabric-switches") {
+            options.fabricSwitches = std::stoi(value);
+        } else if (arg == "--fabric-fanout") {
+            options.fabricFanout = std::stoi(value);
+        } else if (arg == "--fabric-frames") {
+            options.fabricFrames = std::stoull(value);
+        } else if (arg == "--fabric-partitions") {
+            options.fabricPartitions.clear();
+            for (const std::string& item : splitList(value)) {
+                options.fabricPartitions.push_back(std::stoi(item));
+            }
+        } else if (arg == "--snapshot") {
+            options.snapshotPath = value;
+        } else if (arg == "--snapshot-entries") {
+            options.snapshotEntries = std::stoull(value);
+        } else if (arg == "--parse-addresses") {
+            options.parseAddresses = std::stoull(value);
+        } else if (arg == "--lag-members") {
+            options.lagMembers = std::stoi(value);
+        } else if (arg == "--seed") {
+            options.traffic.seed = std::stoull(value);
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseEngine(const std::string& name, TableEngine& engine) {
+    if (name == "hash") {
+        engine = TableEngine::Hash;
+    } else if (name == "flat") {
+        engine = TableEngine::Flat;
+    } else if (name == "concurrent") {
+        engine = TableEngine::Concurrent;
+    } else if (name == "compact") {
+        engine = TableEngine::Compact;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double percentile(std::vector<uint32_t>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::size_t index = static_cast<std::size_t>(fraction * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+/**
+ * @brief Runs the throughput and latency passes for one configuration
+ */
+BenchResult runOne(const BenchOptions& options, TableEngine engine, const std::string& observerName,
+                   const std::vector<TrafficRecord>& warmup, const std::vector<TrafficRecord>& traffic) {
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    ConsoleObserver console(nullStream);
+    SampledObserver sampled(console, 1024);
+    BufferedObserver buffered;
+    std::unique_ptr<AsyncObserver> async;
+
+    SwitchObserver* observer = nullptr;
+    if (observerName == "sampled") {
+        observer = &sampled;
+    } else if (observerName == "buffered") {
+        observer = &buffered;
+    } else if (observerName == "console") {
+        observer = &console;
+    } else if (observerName == "async") {
+        // Only this case starts a logging thread
+        async = std::make_unique<AsyncObserver>(console);
+        observer = async.get();
+    }
+
+    SwitchConfig config;
+    config.numPorts = options.traffic.numPorts;
+    config.agingTimeout = 0;
+    config.tableEngine = engine;
+    config.tableCapacity = options.capacity > 0 ? options.capacity : options.traffic.stations;
+    config.tableEviction = options.eviction;
+    config.observer = nullptr;
+    Switch sw(config);
+
+    // Steady state first: every station learned, nothing reported
+    for (const TrafficRecord& record : warmup) {
+        sw.processFrame(record.sourceMAC, record.destMAC, record.port);
+    }
+    sw.setObserver(observer);
+
+    // The buffered observer is drained periodically so memory stays bounded
+    const std::size_t drainEvery = 4096;
+    std::size_t sinceDrain = 0;
+    auto account = [&](std::size_t processed) {
+        sinceDrain += processed;
+        if (sinceDrain >= drainEvery) {
+            if (observer == &buffered) {
+                buffered.clear();
+            }
+            sinceDrain = 0;
+        }
+    };
+
+    // Throughput pass
+    std::size_t floods = 0;
+    auto start = Clock::now();
+    if (options.burst > 0) {
+        std::vector<FrameView> frames(options.burst);
+        std::vector<int> ports(options.burst);
+        std::vector<ForwardDecision> decisions(options.burst);
+        for (std::size_t base = 0; base < traffic.size(); base += options.burst) {
+            std::size_t n = std::min(options.burst, traffic.size() - base);
+            for (std::size_t i = 0; i < n; i++) {
+                frames[i].sourceMAC = traffic[base + i].sourceMAC;
+                frames[i].destMAC = traffic[base + i].destMAC;
+                ports[i] = traffic[base + i].port;
+            }
+            sw.processBurst(frames.data(), ports.data(), n, decisions.data());
+            for (std::size_t i = 0; i < n; i++) {
+                floods += decisions[i].isFlood();
+            }
+            account(n);
+        }
+    } else {
+        for (std::size_t i = 0; i < traffic.size(); i++) {
+            const TrafficRecord& record = traffic[i];
+            floods += sw.processFrame(record.sourceMAC, record.destMAC, record.port).isFlood();
+            account(1);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Latency pass: frames timed one at a time
+    std::size_t samples = std::min(options.latencySamples, traffic.size());
+    std::vector<uint32_t> latencies;
+    latencies.reserve(samples);
+    for (std::size_t i = 0; i < samples; i++) {
+        const TrafficRecord& record = traffic[i];
+        auto t0 = Clock::now();
+        sw.processFrame(record.sourceMAC, record.destMAC, record.port);
+        auto t1 = Clock::now();
+        latencies.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+        account(1);
+    }
+
+    BenchResult result;
+    result.mpps = seconds > 0 ? traffic.size() / seconds / 1e6 : 0.0;
+    result.p50 = percentile(latencies, 0.50);
+    result.p99 = percentile(latencies, 0.99);
+    result.p999 = percentile(latencies, 0.999);
+    result.tableSize = sw.getMACTableSize();
+    result.floodPercent = traffic.empty() ? 0.0 : 100.0 * floods / traffic.size();
+    result.bytesPerEntry = sw.getMemoryUsage().bytesPerEntry();
+    return result;
+}
+
+struct SpecializedResult {
+    double runtimeMpps;         // Switch configured at run time
+    double fixedMpps;           // BasicSwitch with the same settings as template arguments
+    bool identical;             // Every decision matched
+};
+
+// Port counts the specialized pass is compiled for
+constexpr int kSpecializedPorts[] = {8, 24, 48, 64};
+
+/**
+ * @brief Compares Switch with a BasicSwitch fixed to the same port count and engine
+ *
+ * Both run without aging or an observer. Throughput is timed on separate
+ * switches first; a second, untimed run then checks every decision.
+ */
+template <int NumPorts, typename Table>
+SpecializedResult runSpecialized(const BenchOptions& options, TableEngine engine,
+                                 const std::vector<TrafficRecord>& warmup,
+                                 const std::vector<TrafficRecord>& traffic) {
+    using Fixed = BasicSwitch<NumPorts, NoAging, Table, NoObserver>;
+    SwitchConfig config;
+    config.numPorts = NumPorts;
+    config.agingTimeout = 0;
+    config.tableEngine = engine;
+    config.tableCapacity = options.capacity > 0 ? options.capacity : options.traffic.stations;
+    config.observer = nullptr;
+    const std::size_t burst = std::max<std::size_t>(options.burst, 1);
+
+    // Runs the traffic through sw in bursts, handing each burst's decisions to check
+    auto run = [&](auto& sw, auto& decisions, auto check) {
+        for (const TrafficRecord& record : warmup) {
+            sw.processFrame(record.sourceMAC, record.destMAC, record.port);
+        }
+        std::vector<FrameView> frames(burst);
+        std::vector<int> ports(burst);
+        for (std::size_t base = 0; base < traffic.size(); base += burst) {
+            const std::size_t n = std::min(burst, traffic.size() - base);
+            for (std::size_t i = 0; i < n; i++) {
+                frames[i].sourceMAC = traffic[base + i].sourceMAC;
+                frames[i].destMAC = traffic[base + i].destMAC;
+                ports[i] = traffic[base + i].port;
+            }
+            sw.processBurst(frames.data(), ports.data(), n, decisions.data());
+            check(base, n);
+        }
+    };
+    auto timed = [&](auto& sw, auto& decisions) {
+        const auto start = Clock::now();
+        run(sw, decisions, [](std::size_t, std::size_t) {});
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return seconds > 0 ? (warmup.size() + traffic.size()) / seconds / 1e6 : 0.0;
+    };
+
+    SpecializedResult result;
+    std::vector<ForwardDecision> runtimeDecisions(burst);
+    std::vector<typename Fixed::Decision> fixedDecisions(burst);
+    {
+        Switch runtime(config);
+        result.runtimeMpps = timed(runtime, runtimeDecisions);
+    }
+    {
+        auto fixed = std::make_unique<Fixed>(config.tableCapacity);
+        result.fixedMpps = timed(*fixed, fixedDecisions);
+    }
+
+    // Decisions come a burst at a time, so the reference run keeps all of its own
+    std::vector<ForwardDecision> expected(traffic.size());
+    Switch runtime(config);
+    run(runtime, runtimeDecisions, [&](std::size_t base, std::size_t n) {
+        std::copy(runtimeDecisions.begin(), runtimeDecisions.begin() + n, expected.begin() + base);
+    });
+    auto fixed = std::make_unique<Fixed>(config.tableCapacity);
+    result.identical = true;
+    run(*fixed, fixedDecisions, [&](std::size_t base, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            const ForwardDecision& want = expected[base + i];
+            const typename Fixed::Decision& got = fixedDecisions[i];
+            result.identical = result.identical && got.kind == want.kind &&
+                               got.outPort == want.outPort &&
+                               got.egressPorts.toPortMask() == want.egressPorts;
+        }
+    });
+    return result;
+}
+
+template <int NumPorts>
+SpecializedResult runSpecializedEngine(const BenchOptions& options, const std::string& engineName,
+                                       const std::vector<TrafficRecord>& warmup,
+                                       const std::vector<TrafficRecord>& traffic) {
+    if (engineName == "hash") {
+        return runSpecialized<NumPorts, HashMacTable>(options, TableEngine::Hash, warmup, traffic);
+    }
+    if (engineName == "concurrent") {
+        return runSpecialized<NumPorts, ConcurrentMacTable>(options, TableEngine::Concurrent,
+                                                            warmup, traffic);
+    }
+    if (engineName == "compact") {
+        return runSpecialized<NumPorts, CompactMacTable>(options, TableEngine::Compact, warmup, traffic);
+    }
+    return runSpecialized<NumPorts, FlatMacTable>(options, TableEngine::Flat, warmup, traffic);
+}
+
+SpecializedResult runSpecializedPorts(const BenchOptions& options, const std::string& engineName,
+                                      const std::vector<TrafficRecord>& warmup,
+                                      const std::vector<TrafficRecord>& traffic) {
+    switch (options.traffic.numPorts) {
+    case 8:
+        return runSpecializedEngine<8>(options, engineName, warmup, traffic);
+    case 24:
+        return runSpecializedEngine<24>(options, engineName, warmup, traffic);
+    case 48:
+        return runSpecializedEngine<48>(options, engineName, warmup, traffic);
+    default:
+        return runSpecializedEngine<64>(options, engineName, warmup, traffic);
+    }
+}
+
+struct ScalingResult {
+    double mpps;
+    double floodPercent;
+    uint64_t moves;
+};
+
+/**
+ * @brief Pushes one worker's share of the traffic into its ports' rings
+ */
+void inject(ParallelSwitch& sw, const std::vector<TrafficRecord>& records) {
+    for (const TrafficRecord& record : records) {
+        while (!sw.enqueue(record.sourceMAC, record.destMAC, record.port)) {
+            std::this_thread::yield();  // Ring full: let the worker catch up
+        }
+    }
+}
+
+/**
+ * @brief Measures ParallelSwitch throughput with a given worker count
+ *
+ * Every worker gets its own injector thread feeding exactly the ports that
+ * worker owns, so each receive ring keeps a single producer.
+ */
+ScalingResult runParallel(const BenchOptions& options, int threads,
+                          const std::vector<TrafficRecord>& warmup,
+                          const std::vector<TrafficRecord>& traffic) {
+    SwitchConfig config;
+    config.numPorts = options.traffic.numPorts;
+    config.agingTimeout = 0;
+    config.tableCapacity = options.capacity > 0 ? options.capacity : options.traffic.stations;
+    ParallelSwitch sw(config, threads, 4096);
+    sw.start();
+
+    inject(sw, warmup);
+    sw.waitIdle();
+    const ParallelStatistics before = sw.getStatistics();
+
+    // Split the traffic by owning worker up front, preserving per-port order
+    std::vector<std::vector<TrafficRecord>> shares(threads);
+    for (const TrafficRecord& record : traffic) {
+        shares[sw.workerForPort(record.port)].push_back(record);
+    }
+
+    auto start = Clock::now();
+    std::vector<std::thread> injectors;
+    for (int t = 0; t < threads; t++) {
+        injectors.emplace_back(inject, std::ref(sw), std::cref(shares[t]));
+    }
+    for (std::thread& injector : injectors) {
+        injector.join();
+    }
+    sw.waitIdle();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    sw.stop();
+
+    const ParallelStatistics after = sw.getStatistics();
+    ScalingResult result;
+    result.mpps = seconds > 0 ? traffic.size() / seconds / 1e6 : 0.0;
+    result.floodPercent = traffic.empty() ? 0.0
+        : 100.0 * (after.floodingEvents - before.floodingEvents) / traffic.size();
+    result.moves = after.stationMoves - before.stationMoves;
+    return result;
+}
+
+struct FabricResult {
+    int partitions;
+    uint64_t events;
+    double meventsPerSecond;
+    uint64_t delivered;
+    double simulatedMs;
+    double busiestLink;
+    std::size_t hosts;
+    uint64_t checksum;          // Deliveries in order and every link's counters
+};
+
+/**
+ * @brief Measures the event rate of a tree fabric carrying host-to-host traffic
+ *
+ * Every host first broadcasts once so the fabric learns it, then minimum-size
+ * frames between random host pairs are injected at a fixed fabric-wide rate.
+ * Injection and simulation alternate in chunks so only frames in flight need
+ * buffers. The checksum lets runs with different partition counts be
+ * compared for identical results.
+ */
+FabricResult runFabric(const BenchOptions& options, int partitions) {
+    constexpr int kHostPorts = 4;
+    constexpr uint64_t kInjectIntervalNs = 20;     // Fabric-wide: 50 Mframes/s offered
+    constexpr std::size_t kChunk = 4096;
+
+    FabricConfig config;
+    config.switchConfig.agingTimeout = 0;
+    config.switchConfig.tableEngine = TableEngine::Flat;
+    config.frameBuffers = 1 << 16;
+    config.bufferSize = 128;
+    config.partitions = partitions;
+    Fabric fabric(config);
+    const std::vector<EdgePort> hosts =
+        buildTree(fabric, options.fabricSwitches, options.fabricFanout, kHostPorts);
+
+    // A 64-byte frame on the wire (60 bytes without FCS)
+    static const char payload[46] = {};
+    FrameView frame;
+    frame.etherType = EtherType::kIPv4;
+    frame.payload = std::string_view(payload, sizeof(payload));
+    auto hostMAC = [](std::size_t host) { return MacAddress(0x020000000000ULL | host); };
+
+    // FNV-1a over everything a run observes
+    uint64_t checksum = 14695981039346656037ULL;
+    auto mix = [&checksum](uint64_t value) { checksum = (checksum ^ value) * 1099511628211ULL; };
+    fabric.setDeliveryHandler([&mix](int switchId, int port, const FrameView& delivered,
+                                     uint64_t timeNs) {
+        mix(timeNs);
+        mix(static_cast<uint64_t>(switchId) << 16 | static_cast<uint64_t>(port));
+        mix(delivered.sourceMAC.toUint64());
+    });
+
+    uint64_t time = 0;
+    frame.destMAC = MacAddress::broadcast();
+    for (std::size_t h = 0; h < hosts.size(); h++) {
+        frame.sourceMAC = hostMAC(h);
+        fabric.inject(time += 1000, hosts[h].switchId, hosts[h].port, frame);
+    }
+    fabric.run();
+    time = fabric.now();
+
+    std::mt19937_64 rng(options.traffic.seed);
+    std::uniform_int_distribution<std::size_t> pick(0, hosts.size() - 1);
+    const uint64_t eventsBefore = fabric.getEventsProcessed();
+    const uint64_t deliveredBefore = fabric.getFramesDelivered();
+    const uint64_t startTime = fabric.now();
+
+    auto start = Clock::now();
+    for (std::size_t sent = 0; sent < options.fabricFrames; ) {
+        const std::size_t chunk = std::min(kChunk, options.fabricFrames - sent);
+        for (std::size_t i = 0; i < chunk; i++) {
+            const std::size_t src = pick(rng);
+            std::size_t dst = pick(rng);
+            if (dst == src) {
+                dst = (dst + 1) % hosts.size();
+            }
+            frame.sourceMAC = hostMAC(src);
+            frame.destMAC = hostMAC(dst);
+            fabric.inject(time += kInjectIntervalNs, hosts[src].switchId, hosts[src].port, frame);
+        }
+        sent += chunk;
+        fabric.run(time - 1);
+    }
+    fabric.run();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    FabricResult result;
+    result.partitions = partitions;
+    result.events = fabric.getEventsProcessed() - eventsBefore;
+    result.meventsPerSecond = seconds > 0 ? result.events / seconds / 1e6 : 0.0;
+    result.delivered = fabric.getFramesDelivered() - deliveredBefore;
+    result.simulatedMs = (fabric.now() - startTime) / 1e6;
+    result.busiestLink = 0.0;
+    for (int link = 0; link < fabric.getLinkCount(); link++) {
+        for (bool reverse : {false, true}) {
+            const LinkStatistics& stats = fabric.getLinkStatistics(link, reverse);
+            result.busiestLink = std::max(result.busiestLink, stats.utilization(fabric.now()));
+            mix(stats.frames);
+            mix(stats.busyNs);
+            mix(stats.drops);
+        }
+    }
+    result.hosts = hosts.size();
+    result.checksum = checksum;
+    return result;
+}
+
+struct SnapshotResult {
+    double learnMs;
+    double saveMs;
+    double loadMs;
+    std::size_t entries;
+    std::size_t restored;
+    bool identical;             // Every station restored, with the same per-port counts
+};
+
+/**
+ * @brief Compares learning a large table from traffic with restoring it
+ *
+ * The cold switch learns every station from one broadcast each (as a warm-up
+ * of unknown-unicast floods would) and saves its table; a second switch then
+ * loads the snapshot.
+ */
+SnapshotResult runSnapshot(const BenchOptions& options, TableEngine engine) {
+    SwitchConfig config;
+    config.numPorts = options.traffic.numPorts;
+    config.agingTimeout = 0;
+    config.tableEngine = engine;
+    config.tableCapacity = options.snapshotEntries;
+    config.observer = nullptr;
+    auto stationMAC = [](std::size_t station) { return MacAddress(0x020000000000ULL | station); };
+
+    SnapshotResult result;
+    Switch cold(config);
+    std::vector<FrameView> frames(Switch::kMaxBurst);
+    std::vector<int> ports(Switch::kMaxBurst);
+    std::vector<ForwardDecision> decisions(Switch::kMaxBurst);
+    auto start = Clock::now();
+    for (std::size_t base = 0; base < options.snapshotEntries; base += Switch::kMaxBurst) {
+        const std::size_t n = std::min(Switch::kMaxBurst, options.snapshotEntries - base);
+        for (std::size_t i = 0; i < n; i++) {
+            frames[i].sourceMAC = stationMAC(base + i);
+            frames[i].destMAC = MacAddress::broadcast();
+            ports[i] = 1 + static_cast<int>((base + i) % options.traffic.numPorts);
+        }
+        cold.processBurst(frames.data(), ports.data(), n, decisions.data());
+    }
+    result.learnMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    result.entries = cold.saveTable(options.snapshotPath);
+    result.saveMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    Switch warm(config);
+    start = Clock::now();
+    result.restored = warm.loadTable(options.snapshotPath);
+    result.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::remove(options.snapshotPath.c_str());
+
+    result.identical = result.restored == result.entries;
+    for (int port = 1; port <= options.traffic.numPorts; port++) {
+        result.identical = result.identical && warm.getPortMACCount(port) == cold.getPortMACCount(port);
+    }
+    for (std::size_t station = 0; result.identical && station < options.snapshotEntries; station++) {
+        result.identical = warm.isLearned(stationMAC(station));
+    }
+    return result;
+}
+
+struct ParseResult {
+    double scalarMps;           // Million addresses per second through parse()
+    double batchMps;            // ... through parseBatch()
+    double classifyMps;         // ... through classifyBatch()
+    std::size_t valid;
+    bool identical;             // parseBatch() and classifyBatch() agree with the scalar calls
+};
+
+/**
+ * @brief Compares parsing address text one at a time with parseBatch()
+ *
+ * The texts mix upper and lower case and both separators, and one in 64 is
+ * malformed, so the validity checks are exercised as well as the decoding.
+ */
+ParseResult runParse(const BenchOptions& options) {
+    std::mt19937_64 rng(options.traffic.seed);
+    std::vector<std::string> texts(options.parseAddresses);
+    for (std::string& text : texts) {
+        text = MacAddress(rng()).toString();
+        if (rng() & 1) {
+            std::replace(text.begin(), text.end(), ':', '-');
+        }
+        if (rng() & 1) {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](char c) { return static_cast<char>(std::tolower(c)); });
+        }
+        if (rng() % 64 == 0) {
+            text[rng() % text.size()] = 'g';
+        }
+    }
+    const std::vector<std::string_view> views(texts.begin(), texts.end());
+    std::vector<MacAddress> scalar(views.size());
+    std::vector<MacAddress> batch(views.size());
+    std::vector<uint8_t> flags(views.size());
+
+    ParseResult result;
+    auto start = Clock::now();
+    result.valid = 0;
+    for (std::size_t i = 0; i < views.size(); i++) {
+        if (MacAddress::parse(views[i], scalar[i])) {
+            result.valid++;
+        } else {
+            scalar[i] = MacAddress();
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.scalarMps = seconds > 0 ? views.size() / seconds / 1e6 : 0.0;
+
+    start = Clock::now();
+    const std::size_t batchValid = MacAddress::parseBatch(views.data(), views.size(), batch.data());
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.batchMps = seconds > 0 ? views.size() / seconds / 1e6 : 0.0;
+
+    start = Clock::now();
+    MacAddress::classifyBatch(batch.data(), batch.size(), flags.data());
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.classifyMps = seconds > 0 ? views.size() / seconds / 1e6 : 0.0;
+
+    result.identical = batchValid == result.valid;
+    for (std::size_t i = 0; result.identical && i < views.size(); i++) {
+        const uint8_t expected = (scalar[i].isMulticast() ? MacAddress::kGroupFlag : 0) |
+                                 (scalar[i].isLocallyAdministered() ? MacAddress::kLocalFlag : 0) |
+                                 (scalar[i].isBroadcast() ? MacAddress::kBroadcastFlag : 0);
+        result.identical = batch[i] == scalar[i] && flags[i] == expected;
+    }
+    return result;
+}
+
+struct LagResult {
+    double plainMpps;           // Ports 1..N as separate ports
+    double lagMpps;             // Ports 1..N as one LAG
+    double hashMps;             // flowHash() alone, millions per second
+    uint64_t lagFrames;         // Frames sent on LAG members
+    double imbalance;           // Busiest member over the mean
+    double minShare;            // Least loaded member's share of the LAG's frames
+    double maxShare;            // Most loaded member's share
+};
+
+/**
+ * @brief Runs the throughput traffic with ports 1..N as single ports, then as one LAG
+ *
+ * The generated frames carry no L3 header, so members are picked by the L2
+ * (MAC pair) hash.
+ */
+LagResult runLag(const BenchOptions& options, const std::vector<TrafficRecord>& warmup,
+                 const std::vector<TrafficRecord>& traffic) {
+    const std::size_t burst = std::max<std::size_t>(options.burst, 1);
+    PortMask members = PortMask::firstPorts(options.lagMembers);
+
+    auto run = [&](bool aggregated, LagResult& result) {
+        SwitchConfig config;
+        config.numPorts = options.traffic.numPorts;
+        config.agingTimeout = 0;
+        config.tableEngine = TableEngine::Flat;
+        config.tableCapacity = options.capacity > 0 ? options.capacity : options.traffic.stations;
+        config.observer = nullptr;
+        Switch sw(config);
+        if (aggregated) {
+            sw.addLag(members);
+        }
+        for (const TrafficRecord& record : warmup) {
+            sw.processFrame(record.sourceMAC, record.destMAC, record.port);
+        }
+
+        std::vector<FrameView> frames(burst);
+        std::vector<int> ports(burst);
+        std::vector<ForwardDecision> decisions(burst);
+        auto start = Clock::now();
+        for (std::size_t base = 0; base < traffic.size(); base += burst) {
+            const std::size_t n = std::min(burst, traffic.size() - base);
+            for (std::size_t i = 0; i < n; i++) {
+                frames[i].sourceMAC = traffic[base + i].sourceMAC;
+                frames[i].destMAC = traffic[base + i].destMAC;
+                ports[i] = traffic[base + i].port;
+            }
+            sw.processBurst(frames.data(), ports.data(), n, decisions.data());
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double mpps = seconds > 0 ? traffic.size() / seconds / 1e6 : 0.0;
+        if (!aggregated) {
+            result.plainMpps = mpps;
+            return;
+        }
+        result.lagMpps = mpps;
+
+        // Warm-up floods count too; the shares are of the whole run
+        const LinkAggregation& lags = sw.getLinkAggregation();
+        result.lagFrames = 0;
+        uint64_t least = UINT64_MAX;
+        uint64_t most = 0;
+        members.forEach([&](int port) {
+            result.lagFrames += lags.getLoad(port);
+            least = std::min(least, lags.getLoad(port));
+            most = std::max(most, lags.getLoad(port));
+        });
+        result.imbalance = lags.imbalance(1);
+        result.minShare = result.lagFrames ? 100.0 * least / result.lagFrames : 0.0;
+        result.maxShare = result.lagFrames ? 100.0 * most / result.lagFrames : 0.0;
+    };
+
+    LagResult result{};
+    run(false, result);
+    run(true, result);
+
+    uint32_t sink = 0;
+    FrameView frame;
+    auto start = Clock::now();
+    for (const TrafficRecord& record : traffic) {
+        frame.sourceMAC = record.sourceMAC;
+        frame.destMAC = record.destMAC;
+        sink ^= LinkAggregation::flowHash(frame, LagHash::L2);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.hashMps = seconds > 0 && sink != 1 ? traffic.size() / seconds / 1e6 : 0.0;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::cout << BOLD << CYAN << "╔════════════════════════════════════════════════╗\n";
+    std::cout << "║         L2-Sim Forwarding Benchmark            ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝" << RESET << "\n";
+    std::cout << "Stations: " << options.traffic.stations
+              << "  Ports: " << options.traffic.numPorts
+              << "  Zipf: " << options.traffic.zipfSkew
+              << "  Broadcast: " << options.traffic.broadcastRatio
+              << "  Moves: " << options.traffic.moveRate << "\n";
+    std::cout << "Frames: " << options.frames
+              << "  Burst: " << options.burst
+              << "  Latency samples: " << options.latencySamples
+              << "  Seed: " << options.traffic.seed << "\n\n";
+
+    // Traffic is generated up front so the generator is not measured
+    TrafficGenerator generator(options.traffic);
+    std::vector<TrafficRecord> warmup = generator.warmup();
+    std::vector<TrafficRecord> traffic;
+    generator.generate(options.frames, traffic);
+
+    std::cout << std::left << std::setw(12) << "Engine"
+              << std::setw(10) << "Observer"
+              << std::right << std::setw(10) << "Mpps"
+              << std::setw(10) << "p50 ns"
+              << std::setw(10) << "p99 ns"
+              << std::setw(10) << "p999 ns"
+              << std::setw(10) << "Flood %"
+              << std::setw(10) << "Entries"
+              << std::setw(10) << "B/entry" << "\n";
+    std::cout << std::string(92, '-') << "\n";
+
+    for (const std::string& engineName : options.engines) {
+        TableEngine engine;
+        if (!parseEngine(engineName, engine)) {
+            std::cerr << "Unknown engine " << engineName << "\n";
+            return 1;
+        }
+        if (engine == TableEngine::Concurrent && options.eviction != EvictionPolicy::NoLearn) {
+            continue;
+        }
+        for (const std::string& observerName : options.observers) {
+            BenchResult r = runOne(options, engine, observerName, warmup, traffic);
+            std::cout << std::left << std::setw(12) << engineName
+                      << std::setw(10) << observerName
+                      << std::right << std::fixed
+                      << std::setw(10) << std::setprecision(2) << r.mpps
+                      << std::setw(10) << std::setprecision(0) << r.p50
+                      << std::setw(10) << r.p99
+                      << std::setw(10) << r.p999
+                      << std::setw(10) << std::setprecision(1) << r.floodPercent
+                      << std::setw(10) << r.tableSize
+                      << std::setw(10) << r.bytesPerEntry << "\n";
+        }
+    }
+    std::cout << "\n";
+
+    if (std::find(std::begin(kSpecializedPorts), std::end(kSpecializedPorts), options.traffic.numPorts) !=
+        std::end(kSpecializedPorts)) {
+        std::cout << BOLD << "Compile-time switch" << RESET << " (Switch vs BasicSwitch<"
+                  << options.traffic.numPorts << ", NoAging, engine, NoObserver>, warm-up included)\n";
+        std::cout << std::left << std::setw(12) << "Engine"
+                  << std::right << std::setw(14) << "Switch Mpps"
+                  << std::setw(14) << "Basic Mpps"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(11) << "Identical" << "\n";
+        std::cout << std::string(61, '-') << "\n";
+        for (const std::string& engineName : options.engines) {
+            const SpecializedResult r = runSpecializedPorts(options, engineName, warmup, traffic);
+            std::cout << std::left << std::setw(12) << engineName
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(14) << r.runtimeMpps
+                      << std::setw(14) << r.fixedMpps
+                      << std::setw(9) << (r.runtimeMpps > 0 ? r.fixedMpps / r.runtimeMpps : 0.0) << "x"
+                      << std::setw(11) << (r.identical ? "yes" : "NO") << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (!options.threads.empty()) {
+        std::cout << BOLD << "Thread scaling" << RESET << " (ParallelSwitch, concurrent engine, "
+                  << std::thread::hardware_concurrency() << " hardware threads)\n";
+        std::cout << std::left << std::setw(8) << "Workers"
+                  << std::right << std::setw(10) << "Mpps"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(10) << "Flood %"
+                  << std::setw(10) << "Moves" << "\n";
+        std::cout << std::string(48, '-') << "\n";
+
+        double baseline = 0.0;
+        for (int threads : options.threads) {
+            if (threads < 1 || threads > options.traffic.numPorts) {
+                std::cerr << "Worker count " << threads << " must be between 1 and the port count\n";
+                return 1;
+            }
+            ScalingResult r = runParallel(options, threads, warmup, traffic);
+            if (baseline == 0.0) {
+                baseline = r.mpps;
+            }
+            std::cout << std::left << std::setw(8) << threads
+                      << std::right << std::fixed
+                      << std::setw(10) << std::setprecision(2) << r.mpps
+                      << std::setw(9) << (baseline > 0 ? r.mpps / baseline : 0.0) << "x"
+                      << std::setw(10) << std::setprecision(1) << r.floodPercent
+                      << std::setw(10) << r.moves << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (options.fabricSwitches > 0 && !options.fabricPartitions.empty()) {
+        std::vector<FabricResult> results;
+        for (int partitions : options.fabricPartitions) {
+            results.push_back(runFabric(options, partitions));
+        }
+        std::cout << BOLD << "Fabric" << RESET << " (event-driven, " << options.fabricSwitches
+                  << "-switch tree, fanout " << options.fabricFanout << ", "
+                  << results.front().hosts << " hosts, 10G links)\n";
+        std::cout << std::right << std::setw(10) << "Threads"
+                  << std::setw(12) << "Events"
+                  << std::setw(12) << "Mevents/s"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(12) << "Delivered"
+                  << std::setw(10) << "Sim ms"
+                  << std::setw(14) << "Busiest link"
+                  << std::setw(11) << "Identical" << "\n";
+        std::cout << std::string(91, '-') << "\n";
+        for (const FabricResult& r : results) {
+            const double base = results.front().meventsPerSecond;
+            std::cout << std::fixed
+                      << std::setw(10) << r.partitions
+                      << std::setw(12) << r.events
+                      << std::setw(12) << std::setprecision(2) << r.meventsPerSecond
+                      << std::setw(9) << (base > 0 ? r.meventsPerSecond / base : 0.0) << "x"
+                      << std::setw(12) << r.delivered
+                      << std::setw(10) << std::setprecision(1) << r.simulatedMs
+                      << std::setw(13) << 100.0 * r.busiestLink << "%"
+                      << std::setw(11) << (r.checksum == results.front().checksum ? "yes" : "NO")
+                      << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (!options.snapshotPath.empty() && options.snapshotEntries > 0) {
+        std::cout << BOLD << "Warm start" << RESET << " (" << options.snapshotEntries
+                  << " stations: learned from floods vs saveTable()/loadTable())\n";
+        std::cout << std::left << std::setw(12) << "Engine"
+                  << std::right << std::setw(12) << "Learn ms"
+                  << std::setw(10) << "Save ms"
+                  << std::setw(10) << "Load ms"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(10) << "Entries"
+                  << std::setw(11) << "Identical" << "\n";
+        std::cout << std::string(75, '-') << "\n";
+        for (const std::string& engineName : options.engines) {
+            TableEngine engine;
+            parseEngine(engineName, engine);
+            const SnapshotResult r = runSnapshot(options, engine);
+            std::cout << std::left << std::setw(12) << engineName
+                      << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(12) << r.learnMs
+                      << std::setw(10) << r.saveMs
+                      << std::setw(10) << r.loadMs
+                      << std::setw(9) << (r.loadMs > 0 ? r.learnMs / r.loadMs : 0.0) << "x"
+                      << std::setw(10) << r.restored
+                      << std::setw(11) << (r.identical ? "yes" : "NO") << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (options.lagMembers > 0) {
+        if (options.lagMembers > options.traffic.numPorts) {
+            std::cerr << "--lag-members must not exceed the port count\n";
+            return 1;
+        }
+        const LagResult r = runLag(options, warmup, traffic);
+        std::cout << BOLD << "Link aggregation" << RESET << " (ports 1-" << options.lagMembers
+                  << " as one LAG, flat engine, L2 CRC32C hash using "
+                  << LinkAggregation::crcImplementation() << ")\n";
+        std::cout << std::right << std::setw(12) << "Ports Mpps"
+                  << std::setw(10) << "LAG Mpps"
+                  << std::setw(12) << "Hash Mh/s"
+                  << std::setw(12) << "LAG frames"
+                  << std::setw(11) << "Imbalance"
+                  << std::setw(10) << "Min %"
+                  << std::setw(10) << "Max %" << "\n";
+        std::cout << std::string(77, '-') << "\n";
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(12) << r.plainMpps
+                  << std::setw(10) << r.lagMpps
+                  << std::setw(12) << std::setprecision(1) << r.hashMps
+                  << std::setw(12) << r.lagFrames
+                  << std::setw(10) << std::setprecision(3) << r.imbalance << "x"
+                  << std::setw(10) << std::setprecision(1) << r.minShare
+                  << std::setw(10) << r.maxShare << "\n\n";
+    }
+
+    if (options.parseAddresses > 0) {
+        const ParseResult r = runParse(options);
+        std::cout << BOLD << "Address parsing" << RESET << " (" << options.parseAddresses
+                  << " texts, parseBatch() using " << MacAddress::batchParser() << ")\n";
+        std::cout << std::left << std::setw(16) << "Scalar Ma/s"
+                  << std::right << std::setw(12) << "Batch Ma/s"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(15) << "Classify Ma/s"
+                  << std::setw(10) << "Valid"
+                  << std::setw(11) << "Identical" << "\n";
+        std::cout << std::string(74, '-') << "\n";
+        std::cout << std::left << std::fixed << std::setprecision(1)
+                  << std::setw(16) << r.scalarMps
+                  << std::right << std::setw(12) << r.batchMps
+                  << std::setw(9) << (r.scalarMps > 0 ? r.batchMps / r.scalarMps : 0.0) << "x"
+                  << std::setw(15) << r.classifyMps
+                  << std::setw(10) << r.valid
+                  << std::setw(11) << (r.identical ? "yes" : "NO") << "\n\n";
+    }
+    return 0;
+}
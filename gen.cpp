@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "EtherType.h"
+#include "Scenario.h"
+#include "TrafficGenerator.h"
+
+// ANSI color codes
+#define RESET   "\033[0m"
+#define BOLD    "\033[1m"
+
+namespace {
+
+/**
+ * @brief Generator command-line options
+ */
+struct GenOptions {
+    TrafficConfig traffic;
+    std::string output;
+    ScenarioFormat format = ScenarioFormat::Binary;
+    uint64_t frames = 1000000;          // Frames after the warm-up
+    uint64_t rate = 1000;               // Frames per cycle
+    uint16_t minLength = 60;            // Frame length without FCS
+    uint16_t maxLength = 0;             // Upper bound for random lengths (0 = all minLength)
+    uint16_t vlan = 0;                  // VID every frame is tagged with (0 = untagged)
+    bool warmup = false;                // Start with one broadcast per station
+};
+
+void printUsage() {
+    std::cout << "Usage: l2gen -o FILE [options]   Write a synthetic scenario for l2sim --scenario\n"
+              << "  -o, --output FILE    Scenario file to write\n"
+              << "  --format NAME        binary or text (default binary)\n"
+              << "  --frames N           Frames to generate (default 1000000)\n"
+              << "  --stations N         MAC population size (default 10000)\n"
+              << "  --ports N            Ports the stations are spread across (default 48)\n"
+              << "  --zipf S             Destination Zipf skew, 0 = uniform (default 1.0)\n"
+              << "  --broadcast R        Broadcast frame ratio (default 0.01)\n"
+              << "  --moves R            Station move probability per frame (default 0)\n"
+              << "  --rate N             Frames per clock cycle (default 1000)\n"
+              << "  --length N[-M]       Frame length, or a uniform range (default 60)\n"
+              << "  --vlan N             Tag every frame with VID N (default untagged; l2sim\n"
+              << "                       admits it unless --vlans leaves N out)\n"
+              << "  --warmup             Start with one broadcast from every station\n"
+              << "  --seed N             Traffic RNG seed (default 1)\n";
+}
+
+uint16_t parseLength(const std::string& text) {
+    const unsigned long value = std::stoul(text);
+    if (value < 18 || value > 0xFFFF) {
+        throw std::invalid_argument("frame length must be between 18 and 65535");
+    }
+    return static_cast<uint16_t>(value);
+}
+
+bool parseOptions(int argc, char* argv[], GenOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (arg == "--warmup") {
+            options.warmup = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "-o" || arg == "--output") {
+            options.output = value;
+        } else if (arg == "--format" && (value == "binary" || value == "text")) {
+            options.format = value == "binary" ? ScenarioFormat::Binary : ScenarioFormat::Text;
+        } else if (arg == "--frames") {
+            options.frames = std::stoull(value);
+        } else if (arg == "--stations") {
+            options.traffic.stations = std::stoull(value);
+        } else if (arg == "--ports") {
+            options.traffic.numPorts = std::stoi(value);
+        } else if (arg == "--zipf") {
+            options.traffic.zipfSkew = std::stod(value);
+        } else if (arg == "--broadcast") {
+            options.traffic.broadcastRatio = std::stod(value);
+        } else if (arg == "--moves") {
+            options.traffic.moveRate = std::stod(value);
+        } else if (arg == "--rate") {
+            options.rate = std::max<uint64_t>(1, std::stoull(value));
+        } else if (arg == "--length") {
+            const std::size_t dash = value.find('-');
+            options.minLength = parseLength(value.substr(0, dash));
+            options.maxLength = dash == std::string::npos ? 0 : parseLength(value.substr(dash + 1));
+            if (options.maxLength != 0 && options.maxLength < options.minLength) {
+                std::cerr << "Invalid length range " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--vlan") {
+            const int vlan = std::stoi(value);
+            if (vlan < 0 || vlan > 4094) {
+                std::cerr << "VLAN must be between 0 and 4094\n";
+                return false;
+            }
+            options.vlan = static_cast<uint16_t>(vlan);
+        } else if (arg == "--seed") {
+            options.traffic.seed = std::stoull(value);
+        } else {
+            std::cerr << "Invalid option " << arg << " " << value << "\n";
+            return false;
+        }
+    }
+    return !options.output.empty();
+}
+
+/**
+ * @brief Streams generated traffic into a scenario file
+ *
+ * Frames are produced and written one at a time, so the generator's memory
+ * does not grow with the frame count (only the warm-up, one frame per
+ * station, is generated up front).
+ */
+void generate(const GenOptions& options) {
+    TrafficGenerator generator(options.traffic);
+    ScenarioWriter writer(options.output, options.format);
+    std::mt19937_64 lengths(options.traffic.seed);
+    std::uniform_int_distribution<int> pickLength(options.minLength,
+                                                  std::max(options.minLength, options.maxLength));
+
+    uint64_t written = 0;
+    auto emit = [&](const TrafficRecord& record) {
+        const uint32_t cycle = static_cast<uint32_t>(written / options.rate);
+        const uint16_t etherType = record.destMAC.isBroadcast() ? EtherType::kARP : EtherType::kIPv4;
+        const uint16_t length = options.maxLength != 0 ? static_cast<uint16_t>(pickLength(lengths))
+                                                       : options.minLength;
+        writer.write(ScenarioRecord::make(cycle, record.port, record.sourceMAC, record.destMAC,
+                                          etherType, length, options.vlan));
+        written++;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    if (options.warmup) {
+        for (const TrafficRecord& record : generator.warmup()) {
+            emit(record);
+        }
+    }
+    for (uint64_t i = 0; i < options.frames; i++) {
+        emit(generator.next());
+    }
+    writer.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << BOLD << "Wrote " << written << " frames" << RESET << " over "
+              << (written + options.rate - 1) / options.rate << " cycles to " << options.output
+              << " (" << (options.format == ScenarioFormat::Binary ? "binary" : "text") << ", "
+              << generator.getMoveCount() << " station moves) in " << seconds << " s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    GenOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 1;
+        }
+        generate(options);
+    } catch (const std::exception& e) {
+        std::cerr << "l2gen: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
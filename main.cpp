@@ -1,14 +1,26 @@
-#include <iostream>
-#include <thread>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "Switch.h"
+#include "AsyncObserver.h"
 #include "Frame.h"
+#include "FrameView.h"
+#include "PcapReader.h"
+#include "Scenario.h"
 
 // ANSI color codes
 #define RESET   "\033[0m"
 #define BOLD    "\033[1m"
 #define CYAN    "\033[36m"
 #define MAGENTA "\033[35m"
+#define YELLOW  "\033[33m"
 
 /**
  * @brief Simulates a realistic network scenario with multiple devices
@@ -133,8 +145,13 @@ void demonstrateAging() {
     std::cout << "This demo shows how switches remove old MAC entries\n";
     std::cout << "to handle moved devices and free up table space.\n\n";
     
-    // Create switch with 5-second aging for demo purposes
-    Switch mySwitch(4, 5);
+    // Create switch with 5-cycle aging on the logical clock, so the demo
+    // advances simulated time instead of sleeping
+    SwitchConfig config;
+    config.numPorts = 4;
+    config.agingTimeout = 5;
+    config.agingClock = AgingClock::Logical;
+    Switch mySwitch(config);
     
     std::string MAC_A = "AA:AA:AA:AA:AA:AA";
     std::string MAC_B = "BB:BB:BB:BB:BB:BB";
@@ -147,8 +164,8 @@ void demonstrateAging() {
     
     mySwitch.printMACTable();
     
-    std::cout << "Waiting 6 seconds for aging...\n\n";
-    std::this_thread::sleep_for(std::chrono::seconds(6));
+    std::cout << "Advancing simulation clock by 6 cycles for aging...\n\n";
+    mySwitch.advanceCycles(6);
     
     // Try to cleanup aged entries
     std::cout << "Running cleanup...\n";
@@ -198,7 +215,447 @@ void demonstrateMACMove() {
     mySwitch.printStatistics();
 }
 
-int main() {
+/**
+ * @brief How replayed packets are assigned to switch ports
+ */
+enum class PortMapping {
+    SourceHash,     // Each source MAC gets a stable port from its hash
+    Interface       // pcapng interface N enters on port N+1
+};
+
+/**
+ * @brief Settings for replaying a capture or scenario file
+ */
+struct ReplayOptions {
+    std::string path;                   // pcap/pcapng capture
+    std::string scenarioPath;           // Scenario file (binary or text)
+    int numPorts = 48;
+    int agingTimeout = 300;             // In capture seconds or scenario cycles (0 = no aging)
+    TableEngine engine = TableEngine::Flat;
+    std::size_t capacity = 0;
+    EvictionPolicy eviction = EvictionPolicy::NoLearn;
+    std::size_t burst = 32;
+    PortMapping mapping = PortMapping::SourceHash;
+    bool verbose = false;               // Report every frame on the console
+    bool asyncTrace = false;            // Format the verbose trace on a logging thread
+    bool snooping = false;              // IGMP/MLD snooping
+    std::vector<PortMask> lags;         // Port sets bundled into LAGs
+    std::vector<uint16_t> vlans;        // VIDs every port carries tagged (empty = all of them)
+    LagHash lagHash = LagHash::L2;
+    std::string profilePath;            // Stage timings as JSON (instrumented builds)
+};
+
+void printUsage() {
+    std::cout << "Usage: l2sim                     Run the built-in demonstrations\n"
+              << "       l2sim --pcap FILE [options]  Replay a pcap/pcapng capture\n"
+              << "       l2sim --scenario FILE [options]  Run a scenario file (see l2gen)\n"
+              << "  --ports N          Switch port count (default 48)\n"
+              << "  --aging N          Aging timeout in capture seconds or scenario cycles,\n"
+              << "                     0 = off (default 300)\n"
+              << "  --engine NAME      MAC table engine: hash, flat, compact (default flat)\n"
+              << "  --capacity N       MAC table capacity (default: engine default)\n"
+              << "  --eviction NAME    When the table is full: none (flood new sources), lru or\n"
+              << "                     clock (default none)\n"
+              << "  --burst N          Frames per processBurst() call (default 32)\n"
+              << "  --port-map MODE    hash (by source MAC) or interface (pcapng) (default hash)\n"
+              << "  --snooping         Forward multicast to the groups learned from IGMP/MLD\n"
+              << "  --vlans LIST       VIDs every port carries tagged, e.g. 10,20, or all to\n"
+              << "                     admit any VID (default all; untagged frames use VLAN 1)\n"
+              << "  --lag LIST         Bundle ports into a LAG, e.g. 1,2,3,4 (repeatable)\n"
+              << "  --lag-hash NAME    LAG member selection: l2, l2l3 or l3l4 (default l2)\n"
+              << "  --verbose          Report every frame (and print the final MAC table)\n"
+              << "  --async-trace      As --verbose, formatting the trace on a background thread\n"
+              << "                     (records that overflow its buffer are counted and dropped)\n"
+              << "  --profile FILE     Write per-stage timings as JSON (make INSTRUMENT=1 builds)\n";
+}
+
+/**
+ * @brief Parses a comma-separated list of port numbers
+ */
+bool parsePortList(const std::string& text, PortMask& ports) {
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        const std::size_t end = std::min(text.find(',', start), text.size());
+        const int port = std::stoi(text.substr(start, end - start));
+        if (port < 1 || port > PortMask::kMaxPorts) {
+            return false;
+        }
+        ports.set(port);
+        start = end + 1;
+    }
+    return ports.any();
+}
+
+/**
+ * @brief Parses a comma-separated list of VLAN IDs, or "all" (an empty list)
+ */
+bool parseVlanList(const std::string& text, std::vector<uint16_t>& vlans) {
+    vlans.clear();
+    if (text == "all") {
+        return true;
+    }
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        const std::size_t end = std::min(text.find(',', start), text.size());
+        const int vlan = std::stoi(text.substr(start, end - start));
+        if (vlan < 1 || vlan > FdbKey::kMaxVlan) {
+            return false;
+        }
+        vlans.push_back(static_cast<uint16_t>(vlan));
+        start = end + 1;
+    }
+    return true;
+}
+
+bool parseReplayOptions(int argc, char* argv[], ReplayOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (arg == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (arg == "--async-trace") {
+            options.verbose = true;
+            options.asyncTrace = true;
+            continue;
+        }
+        if (arg == "--snooping") {
+            options.snooping = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--pcap") {
+            options.path = value;
+        } else if (arg == "--scenario") {
+            options.scenarioPath = value;
+        } else if (arg == "--ports") {
+            options.numPorts = std::stoi(value);
+        } else if (arg == "--aging") {
+            options.agingTimeout = std::stoi(value);
+        } else if (arg == "--engine" && (value == "hash" || value == "flat" || value == "compact")) {
+            options.engine = value == "hash" ? TableEngine::Hash
+                           : value == "flat" ? TableEngine::Flat : TableEngine::Compact;
+        } else if (arg == "--capacity") {
+            options.capacity = std::stoull(value);
+        } else if (arg == "--eviction" && (value == "none" || value == "lru" || value == "clock")) {
+            options.eviction = value == "none" ? EvictionPolicy::NoLearn
+                             : value == "lru"  ? EvictionPolicy::LRU : EvictionPolicy::Clock;
+        } else if (arg == "--burst") {
+            options.burst = std::max<std::size_t>(1, std::stoull(value));
+        } else if (arg == "--port-map" && (value == "hash" || value == "interface")) {
+            options.mapping = value == "hash" ? PortMapping::SourceHash : PortMapping::Interface;
+        } else if (arg == "--vlans") {
+            if (!parseVlanList(value, options.vlans)) {
+                std::cerr << "Invalid VLAN list " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--lag") {
+            PortMask members;
+            if (!parsePortList(value, members)) {
+                std::cerr << "Invalid port list " << value << "\n";
+                return false;
+            }
+            options.lags.push_back(members);
+        } else if (arg == "--lag-hash" && (value == "l2" || value == "l2l3" || value == "l3l4")) {
+            options.lagHash = value == "l2" ? LagHash::L2 : value == "l2l3" ? LagHash::L2L3 : LagHash::L3L4;
+        } else if (arg == "--profile") {
+#ifndef L2SIM_INSTRUMENT
+            std::cerr << "--profile needs an instrumented build (make INSTRUMENT=1)\n";
+            return false;
+#endif
+            options.profilePath = value;
+        } else {
+            std::cerr << "Invalid option " << arg << " " << value << "\n";
+            return false;
+        }
+    }
+    // Exactly one input
+    return options.path.empty() != options.scenarioPath.empty();
+}
+
+/**
+ * @brief Switch settings shared by capture and scenario replay
+ * 
+ * Aging runs on the logical clock, which replay drives from the input's
+ * timestamps, with a bounded slice of aging after every burst.
+ */
+SwitchConfig replayConfig(const ReplayOptions& options, SwitchObserver* trace) {
+    SwitchConfig config;
+    config.numPorts = options.numPorts;
+    config.agingTimeout = options.agingTimeout;
+    config.agingClock = AgingClock::Logical;
+    config.tableEngine = options.engine;
+    config.tableCapacity = options.capacity;
+    config.tableEviction = options.eviction;
+    config.agingBudgetPerBurst = 256;
+    config.multicastSnooping = options.snooping;
+    config.lagHash = options.lagHash;
+    config.observer = trace ? trace : options.verbose ? consoleObserver() : nullptr;
+    return config;
+}
+
+/**
+ * @brief Creates the --async-trace logging thread (nullptr without the option)
+ * 
+ * It must outlive the replay switch, so callers create it first.
+ */
+std::unique_ptr<AsyncObserver> makeTrace(const ReplayOptions& options) {
+    if (!options.asyncTrace) {
+        return nullptr;
+    }
+    return std::make_unique<AsyncObserver>(*consoleObserver());
+}
+
+/**
+ * @brief Reports trace records lost to a full logging ring
+ */
+void printTraceDrops(const AsyncObserver* trace) {
+    if (trace) {
+        std::cout << "Trace Records Dropped:   " << trace->dropped() << "\n";
+    }
+}
+
+/**
+ * @brief Makes every port of a replay switch a member of the --vlans VIDs
+ * 
+ * Captures are mostly 802.1Q-tagged and the replay cannot know the VLAN
+ * plan they came from, so by default every VID is admitted on every port:
+ * learning and flooding stay per VLAN, but no tagged frame is filtered.
+ */
+void configureVlans(Switch& replaySwitch, const ReplayOptions& options) {
+    const PortMask members = PortMask::firstPorts(options.numPorts);
+    if (options.vlans.empty()) {
+        for (uint16_t vlan = 1; vlan <= FdbKey::kMaxVlan; vlan++) {
+            replaySwitch.setVlanMembers(vlan, members);
+        }
+        return;
+    }
+    for (uint16_t vlan : options.vlans) {
+        replaySwitch.setVlanMembers(vlan, members);
+    }
+}
+
+/**
+ * @brief Creates the --lag groups on a replay switch
+ */
+void configureLags(Switch& replaySwitch, const ReplayOptions& options) {
+    for (const PortMask& members : options.lags) {
+        replaySwitch.addLag(members);
+    }
+}
+
+/**
+ * @brief Writes the switch's stage timings to the --profile file, if one was given
+ */
+void writeProfile(const Switch& replaySwitch, const ReplayOptions& options) {
+    const StageProfile* profile = replaySwitch.getStageProfile();
+    if (options.profilePath.empty() || !profile) {
+        return;
+    }
+    std::ofstream out(options.profilePath);
+    profile->writeJson(out);
+    if (!out) {
+        throw std::runtime_error("cannot write profile " + options.profilePath);
+    }
+    std::cout << "Stage profile written to " << options.profilePath << "\n\n";
+}
+
+/**
+ * @brief Feeds a capture file through a switch in bursts
+ * 
+ * Packets are decoded in place from the file mapping, so memory use does not
+ * depend on the capture size. Aging runs on the logical clock, driven by the
+ * capture timestamps, so entries expire in capture time however fast the
+ * replay runs.
+ */
+int runPcapReplay(const ReplayOptions& options) {
+    PcapReader reader(options.path);
+    std::unique_ptr<AsyncObserver> trace = makeTrace(options);
+    const SwitchConfig config = replayConfig(options, trace.get());
+    
+    std::cout << BOLD << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              PCAP REPLAY                       ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝\n" << RESET;
+    std::cout << "Capture: " << options.path << " ("
+              << (reader.getFormat() == PcapReader::Format::PcapNg ? "pcapng" : "pcap") << ", "
+              << reader.getFileSize() << " bytes)\n";
+    
+    Switch replaySwitch(config);
+    configureVlans(replaySwitch, options);
+    configureLags(replaySwitch, options);
+    
+    std::vector<FrameView> frames(options.burst);
+    std::vector<int> ports(options.burst);
+    std::vector<ForwardDecision> decisions(options.burst);
+    std::size_t n = 0;
+    uint64_t replayed = 0;
+    uint64_t runts = 0;
+    uint64_t firstTimestamp = 0;
+    uint64_t lastTimestamp = 0;
+    
+    auto flush = [&]() {
+        replaySwitch.processBurst(frames.data(), ports.data(), n, decisions.data());
+        replayed += n;
+        n = 0;
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    PcapPacket packet;
+    while (reader.next(packet)) {
+        FrameView frame;
+        if (!FrameView::parse(packet.data, packet.capturedLength, frame)) {
+            runts++;
+            continue;
+        }
+        
+        // Whole capture seconds since the first packet drive the aging clock.
+        // Simple Packet Blocks carry no timestamp and don't move it.
+        if (packet.timestampNs != 0) {
+            if (firstTimestamp == 0) {
+                firstTimestamp = packet.timestampNs;
+            }
+            lastTimestamp = std::max(lastTimestamp, packet.timestampNs);
+        }
+        const uint32_t captureSecond = static_cast<uint32_t>(
+            (lastTimestamp - firstTimestamp) / 1000000000ULL);
+        
+        // A burst is stamped with one clock value, so end it at each new second
+        if (n == options.burst || (n > 0 && captureSecond != replaySwitch.getCurrentCycle())) {
+            flush();
+        }
+        if (captureSecond > replaySwitch.getCurrentCycle()) {
+            replaySwitch.advanceCycles(captureSecond - replaySwitch.getCurrentCycle());
+        }
+        
+        frames[n] = frame;
+        ports[n] = options.mapping == PortMapping::Interface
+            ? static_cast<int>(packet.interfaceId % options.numPorts) + 1
+            : static_cast<int>(frame.sourceMAC.hash() % options.numPorts) + 1;
+        n++;
+    }
+    if (n > 0) {
+        flush();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (options.snooping) {
+        replaySwitch.printGroupTable();
+    }
+    if (!options.lags.empty()) {
+        replaySwitch.printLagStatistics();
+    }
+    replaySwitch.printStatistics();
+    std::cout << "Frames Replayed:         " << replayed << "\n";
+    std::cout << "Skipped (non-Ethernet):  " << reader.getPacketsSkipped() << "\n";
+    std::cout << "Skipped (runt frames):   " << runts << "\n";
+    printTraceDrops(trace.get());
+    std::cout << std::setprecision(3);
+    std::cout << "Capture Duration:        " << (lastTimestamp - firstTimestamp) / 1e9 << " s\n";
+    std::cout << "Replay Time:             " << seconds << " s ("
+              << (seconds > 0 ? replayed / seconds / 1e6 : 0.0) << " Mpps)\n";
+    if (reader.isTruncated()) {
+        std::cout << YELLOW << "Warning: capture ends in the middle of a record" << RESET << "\n";
+    }
+    std::cout << "\n";
+    writeProfile(replaySwitch, options);
+    return 0;
+}
+
+/**
+ * @brief Runs the frames of a scenario file through a switch in bursts
+ * 
+ * The reader streams the file in fixed-size blocks, so a scenario of any
+ * length runs in constant memory. Each record's cycle drives the switch's
+ * logical clock; a burst never spans two cycles.
+ */
+int runScenario(const ReplayOptions& options) {
+    ScenarioReader reader(options.scenarioPath);
+    std::unique_ptr<AsyncObserver> trace = makeTrace(options);
+    const SwitchConfig config = replayConfig(options, trace.get());
+    
+    std::cout << BOLD << CYAN << "\n╔════════════════════════════════════════════════╗\n";
+    std::cout << "║              SCENARIO REPLAY                   ║\n";
+    std::cout << "╚════════════════════════════════════════════════╝\n" << RESET;
+    std::cout << "Scenario: " << options.scenarioPath << " ("
+              << (reader.getFormat() == ScenarioFormat::Binary ? "binary" : "text") << ")\n";
+    
+    Switch scenarioSwitch(config);
+    configureVlans(scenarioSwitch, options);
+    configureLags(scenarioSwitch, options);
+    
+    std::vector<FrameView> frames(options.burst);
+    std::vector<int> ports(options.burst);
+    std::vector<ForwardDecision> decisions(options.burst);
+    std::size_t n = 0;
+    
+    auto flush = [&]() {
+        scenarioSwitch.processBurst(frames.data(), ports.data(), n, decisions.data());
+        n = 0;
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    const ScenarioRecord* block;
+    std::size_t count;
+    while (reader.next(block, count)) {
+        for (std::size_t i = 0; i < count; i++) {
+            const ScenarioRecord& record = block[i];
+            // The clock never runs backwards; late records join the current cycle
+            if (n == options.burst || (n > 0 && record.cycle > scenarioSwitch.getCurrentCycle())) {
+                flush();
+            }
+            if (record.cycle > scenarioSwitch.getCurrentCycle()) {
+                scenarioSwitch.advanceCycles(record.cycle - scenarioSwitch.getCurrentCycle());
+            }
+            frames[n] = record.view();
+            ports[n] = record.port;
+            n++;
+        }
+    }
+    if (n > 0) {
+        flush();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (options.verbose) {
+        scenarioSwitch.printMACTable();
+    }
+    if (!options.lags.empty()) {
+        scenarioSwitch.printLagStatistics();
+    }
+    scenarioSwitch.printStatistics();
+    std::cout << "Frames Replayed:         " << reader.getRecordsRead() << "\n";
+    std::cout << "Scenario Cycles:         " << scenarioSwitch.getCurrentCycle() << "\n";
+    printTraceDrops(trace.get());
+    std::cout << std::setprecision(3);
+    std::cout << "Replay Time:             " << seconds << " s ("
+              << (seconds > 0 ? reader.getRecordsRead() / seconds / 1e6 : 0.0) << " Mpps)\n\n";
+    writeProfile(scenarioSwitch, options);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        ReplayOptions options;
+        try {
+            if (!parseReplayOptions(argc, argv, options)) {
+                printUsage();
+                return 1;
+            }
+            return options.scenarioPath.empty() ? runPcapReplay(options) : runScenario(options);
+        } catch (const std::exception& e) {
+            std::cerr << "l2sim: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    
     std::cout << "\n";
     std::cout << BOLD << "╔══════════════════════════════════════════════════════╗\n";
     std::cout << "║                                                      ║\n";
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Sweep.h"
+
+// ANSI color codes
+#define RESET   "\033[0m"
+#define BOLD    "\033[1m"
+#define CYAN    "\033[36m"
+
+namespace {
+
+/**
+ * @brief Sweep command-line options
+ */
+struct SweepOptions {
+    SweepConfig config;
+    std::string output;                 // Per-run results CSV
+    std::string summary;                // Per-point summary CSV (empty = none)
+    int threads = 0;                    // Worker threads (0 = one per hardware thread)
+    bool timing = false;                // Add per-run replay times to the results
+};
+
+void printUsage() {
+    std::cout << "Usage: l2sweep -o FILE [options]   Replay synthetic traffic over a parameter grid\n"
+              << "  -o, --output FILE    Per-run results CSV to write\n"
+              << "  --summary FILE       Also write one CSV row per grid point\n"
+              << "  --ports LIST         Port counts, e.g. 24,48 (default 48)\n"
+              << "  --aging LIST         Aging timeouts in cycles, 0 = none (default 300)\n"
+              << "  --stations LIST      MAC population sizes (default 10000)\n"
+              << "  --moves LIST         Station move probabilities per frame (default 0)\n"
+              << "  --replicas N         Runs per grid point, each with its own seed (default 4)\n"
+              << "  --frames N           Frames per run (default 200000)\n"
+              << "  --rate N             Frames per clock cycle (default 1000)\n"
+              << "  --zipf S             Destination Zipf skew, 0 = uniform (default 1.0)\n"
+              << "  --broadcast R        Broadcast frame ratio (default 0.01)\n"
+              << "  --engine NAME        MAC table engine: hash, flat or compact (default flat)\n"
+              << "  --capacity N         MAC table capacity, 0 = the run's population (default 0)\n"
+              << "  --eviction NAME      Full table: none, lru or clock (default none)\n"
+              << "  --threads N          Worker threads, 0 = one per hardware thread (default 0)\n"
+              << "  --timing             Add each run's replay time to the results\n"
+              << "  --seed N             Base seed of the sweep (default 1)\n";
+}
+
+/**
+ * @brief Parses a comma-separated list of values
+ */
+template <typename T, typename Parse>
+std::vector<T> parseList(const std::string& text, Parse parse) {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(static_cast<T>(parse(item)));
+    }
+    if (values.empty()) {
+        throw std::invalid_argument("empty list '" + text + "'");
+    }
+    return values;
+}
+
+int toInt(const std::string& text) { return std::stoi(text); }
+unsigned long long toSize(const std::string& text) { return std::stoull(text); }
+double toDouble(const std::string& text) { return std::stod(text); }
+
+bool parseOptions(int argc, char* argv[], SweepOptions& options) {
+    SweepConfig& config = options.config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (arg == "--timing") {
+            options.timing = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "-o" || arg == "--output") {
+            options.output = value;
+        } else if (arg == "--summary") {
+            options.summary = value;
+        } else if (arg == "--ports") {
+            config.ports = parseList<int>(value, toInt);
+        } else if (arg == "--aging") {
+            config.agingTimeouts = parseList<int>(value, toInt);
+        } else if (arg == "--stations") {
+            config.stations = parseList<std::size_t>(value, toSize);
+        } else if (arg == "--moves") {
+            config.moveRates = parseList<double>(value, toDouble);
+        } else if (arg == "--replicas") {
+            config.replicas = std::stoi(value);
+        } else if (arg == "--frames") {
+            config.frames = std::stoull(value);
+        } else if (arg == "--rate") {
+            config.framesPerCycle = std::max<uint64_t>(1, std::stoull(value));
+        } else if (arg == "--zipf") {
+            config.zipfSkew = std::stod(value);
+        } else if (arg == "--broadcast") {
+            config.broadcastRatio = std::stod(value);
+        } else if (arg == "--engine" && (value == "hash" || value == "flat" || value == "compact")) {
+            config.engine = value == "hash" ? TableEngine::Hash
+                          : value == "flat" ? TableEngine::Flat : TableEngine::Compact;
+        } else if (arg == "--capacity") {
+            config.capacity = std::stoull(value);
+        } else if (arg == "--eviction" && (value == "none" || value == "lru" || value == "clock")) {
+            config.eviction = value == "none" ? EvictionPolicy::NoLearn
+                            : value == "lru"  ? EvictionPolicy::LRU
+                                              : EvictionPolicy::Clock;
+        } else if (arg == "--threads") {
+            options.threads = std::max(0, std::stoi(value));
+        } else if (arg == "--seed") {
+            config.seed = std::stoull(value);
+        } else {
+            std::cerr << "Invalid option " << arg << " " << value << "\n";
+            return false;
+        }
+    }
+    return !options.output.empty();
+}
+
+void writeCsv(const std::string& path, const SweepRunner& runner, bool summary, bool timing) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("cannot open " + path + " for writing");
+    }
+    if (summary) {
+        runner.writeSummaryCsv(out);
+    } else {
+        runner.writeResultsCsv(out, timing);
+    }
+    if (!out) {
+        throw std::runtime_error("error writing " + path);
+    }
+}
+
+void printSummary(const SweepRunner& runner) {
+    std::cout << BOLD << CYAN << "\n=== Sweep Summary ===" << RESET << "\n"
+              << std::left << std::setw(7) << "Point" << std::setw(7) << "Ports"
+              << std::setw(7) << "Aging" << std::setw(10) << "Stations" << std::setw(9) << "Moves"
+              << std::setw(11) << "Learned" << std::setw(12) << "Mean Table"
+              << std::setw(11) << "Table Full" << "Flood % (min-max)\n";
+    const std::vector<SweepSummary>& summaries = runner.getSummaries();
+    for (std::size_t point = 0; point < summaries.size(); point++) {
+        const SweepRun run = runner.describe(point * runner.getConfig().replicas);
+        const SweepSummary& s = summaries[point];
+        std::cout << std::left << std::setw(7) << point << std::setw(7) << run.ports
+                  << std::setw(7) << run.agingTimeout << std::setw(10) << run.stations
+                  << std::setw(9) << run.moveRate
+                  << std::setw(11) << s.learned / std::max<uint64_t>(s.runs, 1)
+                  << std::setw(12) << std::fixed << std::setprecision(0) << s.meanTableSize()
+                  << std::setw(11) << s.tableFull / std::max<uint64_t>(s.runs, 1)
+                  << std::setprecision(2) << s.floodPercent() << " (" << s.floodMin << "-"
+                  << s.floodMax << ")\n" << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SweepOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 1;
+        }
+        SweepRunner runner(options.config);
+        runner.run(options.threads);
+
+        writeCsv(options.output, runner, false, options.timing);
+        if (!options.summary.empty()) {
+            writeCsv(options.summary, runner, true, false);
+        }
+        printSummary(runner);
+        std::cout << "\n" << BOLD << runner.runs() << " runs" << RESET << " ("
+                  << runner.points() << " points x " << options.config.replicas << " replicas) on "
+                  << runner.getThreads() << " threads in " << std::fixed << std::setprecision(2)
+                  << runner.getSeconds() << " s, " << std::setprecision(1)
+                  << runner.runs() / std::max(runner.getSeconds(), 1e-9) << " runs/s, "
+                  << runner.getSteals() << " steals\n"
+                  << "Results written to " << options.output << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "l2sweep: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}